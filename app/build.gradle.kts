@@ -47,6 +47,10 @@ android {
     buildFeatures {
         viewBinding = true
     }
+    androidResources {
+        // Models are memory-mapped straight from the APK, which needs them stored uncompressed
+        noCompress += listOf("onnx", "ort")
+    }
 }
 
 dependencies {
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Convert 16-bit PCM to float in a single pass over the input.
+// `raw` receives the samples unscaled (mel front end), `normalized` receives them
+// scaled to [-1, 1) (VAD). `normalized` may be null when VAD is not fed.
+inline void convertPcm16(const int16_t* src, float* raw, float* normalized, size_t count) {
+    constexpr float scale = 1.0f / 32768.0f;
+    size_t i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const float32x4_t vscale = vdupq_n_f32(scale);
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t s = vld1q_s16(src + i);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(raw + i, lo);
+        vst1q_f32(raw + i + 4, hi);
+        if (normalized) {
+            vst1q_f32(normalized + i, vmulq_f32(lo, vscale));
+            vst1q_f32(normalized + i + 4, vmulq_f32(hi, vscale));
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128 vscale = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // Sign-extend int16 to int32 by unpacking into the high half and shifting back
+        const __m128i lo32 = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        const __m128i hi32 = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        const __m128 lo = _mm_cvtepi32_ps(lo32);
+        const __m128 hi = _mm_cvtepi32_ps(hi32);
+        _mm_storeu_ps(raw + i, lo);
+        _mm_storeu_ps(raw + i + 4, hi);
+        if (normalized) {
+            _mm_storeu_ps(normalized + i, _mm_mul_ps(lo, vscale));
+            _mm_storeu_ps(normalized + i + 4, _mm_mul_ps(hi, vscale));
+        }
+    }
+#endif
+
+    // Scalar tail (and fallback for targets without NEON/SSE2)
+    for (; i < count; i++) {
+        const float sample = static_cast<float>(src[i]);
+        raw[i] = sample;
+        if (normalized) {
+            normalized[i] = sample * scale;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Fixed-capacity history of raw PCM16 audio for post-wake capture.
+// One producer appends; any number of readers copy by absolute sample position
+// (samples written since allocate()), so the buffer can be shared with Java as
+// one direct ByteBuffer: sample p lives at index p & (capacity - 1).
+//
+// The producer never waits for readers. It announces the range it is about to
+// overwrite in `reserved` before copying and publishes it in `written` after,
+// so a reader validates a copy by checking overwriteLimit() once it is done:
+// samples below that position may have been overwritten while it read them.
+class CaptureRing {
+public:
+    CaptureRing() = default;
+    explicit CaptureRing(size_t minCapacity) { allocate(minCapacity); }
+
+    CaptureRing(const CaptureRing&) = delete;
+    CaptureRing& operator=(const CaptureRing&) = delete;
+
+    // Allocate storage; must not be called while the producer or a reader is active
+    void allocate(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        buffer.assign(capacity, 0);
+        mask = capacity - 1;
+        reservedSamples.store(0, std::memory_order_relaxed);
+        writtenSamples.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return buffer.size(); }
+    const int16_t* data() const { return buffer.data(); }
+
+    // Samples appended so far; [written() - capacity(), written()) is readable
+    uint64_t written() const { return writtenSamples.load(std::memory_order_acquire); }
+
+    // Oldest position still intact, including against a write in progress
+    uint64_t overwriteLimit() const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = reservedSamples.load(std::memory_order_relaxed);
+        return reserved > capacity() ? reserved - capacity() : 0;
+    }
+
+    // Producer: append `count` samples, overwriting the oldest
+    void write(const int16_t* samples, size_t count) {
+        if (buffer.empty() || count == 0) return;
+        const uint64_t end = writtenSamples.load(std::memory_order_relaxed) + count;
+        if (count > capacity()) {
+            samples += count - capacity();
+            count = capacity();
+        }
+        const uint64_t start = end - count;
+        reservedSamples.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t offset = start & mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(&buffer[offset], samples, first * sizeof(int16_t));
+        std::memcpy(&buffer[0], samples + first, (count - first) * sizeof(int16_t));
+        writtenSamples.store(end, std::memory_order_release);
+    }
+
+    // Reader: copy the samples in [position, position + count) that have been
+    // written; returns how many were copied, or 0 if any of them were overwritten
+    size_t read(uint64_t position, int16_t* dst, size_t count) const {
+        const uint64_t end = std::min<uint64_t>(written(), position + count);
+        if (end <= position || position < overwriteLimit()) return 0;
+        count = static_cast<size_t>(end - position);
+        const size_t offset = position & mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(dst, &buffer[offset], first * sizeof(int16_t));
+        std::memcpy(dst + first, &buffer[0], (count - first) * sizeof(int16_t));
+        return position >= overwriteLimit() ? count : 0;
+    }
+
+private:
+    std::vector<int16_t> buffer;
+    size_t mask = 0;
+    std::atomic<uint64_t> reservedSamples{0};
+    std::atomic<uint64_t> writtenSamples{0};
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Speech start/end decisions, in VAD sample clock terms
+struct EndpointConfig {
+    float threshold = 0.5f;       // a window at or above this is speech
+    float releaseMargin = 0.15f;  // windows within this below the threshold neither extend nor end speech
+    int hangoverMs = 500;         // silence after the last speech window before speech ends
+
+    // Early endpointing: when the probability falls from speech to below
+    // `floorProbability` within `fastFallMs` and stays there, the segment
+    // ends after `earlyHangoverMs` instead. A fading tail keeps the full hangover.
+    bool earlyEndpoint = false;
+    int earlyHangoverMs = 200;
+    int fastFallMs = 96;
+    float floorProbability = 0.1f;
+};
+
+// One voice activity edge. Positions count VAD input samples since start()
+// (or since VAD was last enabled), so they are exact whatever the size of the
+// processAudio() calls that delivered them.
+struct EndpointEvent {
+    bool speech = false;         // true: speech started, false: it ended
+    uint64_t sample = 0;         // start: first sample of the first speech window;
+                                 // end: one past the last speech window
+    uint64_t decidedSample = 0;  // position the decision was made at
+    bool early = false;          // end decided with the early hangover
+};
+
+// Per-window state machine turning Silero speech probabilities into start and
+// end events. Driven only by the sample clock, so the same audio always ends
+// speech at the same sample. Single-threaded: owned by the VAD worker.
+class Endpointer {
+public:
+    void configure(const EndpointConfig& config, size_t sampleRate) {
+        threshold = config.threshold;
+        releaseThreshold = config.threshold - config.releaseMargin;
+        floorProbability = config.floorProbability;
+        hangoverSamples = msToSamples(config.hangoverMs, sampleRate);
+        earlyHangoverSamples = config.earlyEndpoint
+            ? msToSamples(config.earlyHangoverMs, sampleRate) : hangoverSamples;
+        fastFallSamples = msToSamples(config.fastFallMs, sampleRate);
+        reset();
+    }
+
+    void reset() {
+        speech = false;
+        silent = false;
+        crisp = false;
+        lastSpeechEnd = 0;
+    }
+
+    bool inSpeech() const { return speech; }
+
+    // One window of `windowSamples` ending at `windowEnd`; returns true and
+    // fills `event` when it starts or ends speech
+    bool update(float probability, uint64_t windowEnd, size_t windowSamples, EndpointEvent& event) {
+        if (probability >= threshold) {
+            lastSpeechEnd = windowEnd;
+            silent = false;
+            if (speech) return false;
+            speech = true;
+            event = {true, windowEnd - windowSamples, windowEnd, false};
+            return true;
+        }
+        if (!speech) return false;
+
+        if (probability >= releaseThreshold) {
+            // Hysteresis band: not silence yet, and no longer a crisp end
+            silent = true;
+            crisp = false;
+            return false;
+        }
+        if (!silent) {
+            silent = true;
+            crisp = probability < floorProbability && windowEnd - lastSpeechEnd <= fastFallSamples;
+        } else if (probability >= floorProbability) {
+            crisp = false;
+        }
+
+        const uint64_t hangover = crisp ? earlyHangoverSamples : hangoverSamples;
+        if (windowEnd - lastSpeechEnd < hangover) return false;
+        speech = false;
+        silent = false;
+        event = {false, lastSpeechEnd, windowEnd, crisp && earlyHangoverSamples < hangoverSamples};
+        return true;
+    }
+
+private:
+    static uint64_t msToSamples(int ms, size_t sampleRate) {
+        return static_cast<uint64_t>(ms > 0 ? ms : 0) * sampleRate / 1000;
+    }
+
+    float threshold = 0.5f;
+    float releaseThreshold = 0.35f;
+    float floorProbability = 0.1f;
+    uint64_t hangoverSamples = 8000;
+    uint64_t earlyHangoverSamples = 8000;
+    uint64_t fastFallSamples = 1536;
+
+    bool speech = false;
+    bool silent = false;  // a window below the threshold was seen since the last speech window
+    bool crisp = false;   // the current silence followed a fast fall
+    uint64_t lastSpeechEnd = 0;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Lightweight wake-up primitive built on a Linux futex.
+// notify() is a single atomic increment unless a consumer is actually asleep,
+// so producers on the audio path never take a lock or make a syscall needlessly.
+//
+// Consumer pattern:
+//     uint32_t seen = signal.epoch();
+//     if (!dataAvailable()) signal.wait(seen);
+class EventSignal {
+public:
+    EventSignal() = default;
+    EventSignal(const EventSignal&) = delete;
+    EventSignal& operator=(const EventSignal&) = delete;
+
+    // Current sequence number, read before checking for data
+    uint32_t epoch() const { return sequence.load(std::memory_order_acquire); }
+
+    // Wake any waiting consumer
+    void notify() {
+        sequence.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst) > 0) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence),
+                    FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+    // Block until notify() has been called since `seen` was read
+    void wait(uint32_t seen) {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        while (sequence.load(std::memory_order_seq_cst) == seen) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence),
+                    FUTEX_WAIT_PRIVATE, seen, nullptr, nullptr, 0);
+        }
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    // wait() that gives up after `timeoutNanos`; returns false on timeout
+    bool waitFor(uint32_t seen, int64_t timeoutNanos) {
+        timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeoutNanos / 1000000000;
+        deadline.tv_nsec += timeoutNanos % 1000000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        bool notified = true;
+        while (sequence.load(std::memory_order_seq_cst) == seen) {
+            // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline
+            if (syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence),
+                        FUTEX_WAIT_BITSET_PRIVATE, seen, &deadline, nullptr,
+                        FUTEX_BITSET_MATCH_ANY) == -1 && errno == ETIMEDOUT) {
+                notified = sequence.load(std::memory_order_seq_cst) != seen;
+                break;
+            }
+        }
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+        return notified;
+    }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "futex word must be a plain 32-bit integer");
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<int> waiters{0};
+};
@@ -0,0 +1,352 @@
+#include "jni_callback_dispatcher.h"
+#include "platform_log.h"
+#include <algorithm>
+
+#define LOGD(...) PLATFORM_LOG(PLATFORM_LOG_DEBUG, "JniCallbackDispatcher", __VA_ARGS__)
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "JniCallbackDispatcher", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "JniCallbackDispatcher", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "JniCallbackDispatcher", __VA_ARGS__)
+
+namespace {
+
+void clearException(JNIEnv* env) {
+    if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+}
+
+} // namespace
+
+JniCallbackDispatcher::~JniCallbackDispatcher() {
+    // Global refs are dropped by release(); without a JNIEnv they are left to the VM
+    stop();
+}
+
+bool JniCallbackDispatcher::initialize(JavaVM* vm, JNIEnv* env, bool multiStream) {
+    javaVM = vm;
+    withStreamIds = multiStream;
+
+    const char* className = multiStream ? "com/vinhpx/voiceassistant/MultiStreamWakeupCallback"
+                                        : "com/vinhpx/voiceassistant/WakeupDetectorCallback";
+    jclass localClass = env->FindClass(className);
+    if (localClass == nullptr) {
+        LOGE("Failed to find %s class", className);
+        env->ExceptionClear();
+        return false;
+    }
+    callbackClass = static_cast<jclass>(env->NewGlobalRef(localClass));
+    env->DeleteLocalRef(localClass);
+
+    onWakeWordDetected = env->GetMethodID(callbackClass, "onWakeWordDetected",
+        multiStream ? "(ILjava/lang/String;)V" : "(Ljava/lang/String;)V");
+    if (onWakeWordDetected == nullptr) {
+        LOGE("Failed to find onWakeWordDetected method");
+        env->ExceptionClear();
+        return false;
+    }
+
+    // Voice activity callbacks are optional; single-stream ones take the edge's position
+    const char* voiceSignature = multiStream ? "(I)V" : "(J)V";
+    onVoiceActivityStarted = env->GetMethodID(callbackClass, "onVoiceActivityStarted", voiceSignature);
+    if (onVoiceActivityStarted == nullptr) {
+        LOGE("Failed to find onVoiceActivityStarted method");
+        env->ExceptionClear();
+    }
+    onVoiceActivityEnded = env->GetMethodID(callbackClass, "onVoiceActivityEnded", voiceSignature);
+    if (onVoiceActivityEnded == nullptr) {
+        LOGE("Failed to find onVoiceActivityEnded method");
+        env->ExceptionClear();
+    }
+
+    // Capture sessions exist only for the single-stream detector
+    if (!multiStream) {
+        onAudioCaptureStarted = env->GetMethodID(callbackClass, "onAudioCaptureStarted",
+                                                 "(Ljava/lang/String;J)V");
+        onAudioCaptureEnded = env->GetMethodID(callbackClass, "onAudioCaptureEnded",
+                                               "(Ljava/lang/String;J)V");
+        if (onAudioCaptureStarted == nullptr || onAudioCaptureEnded == nullptr) {
+            LOGE("Failed to find the audio capture methods");
+            env->ExceptionClear();
+            onAudioCaptureStarted = nullptr;
+            onAudioCaptureEnded = nullptr;
+        }
+    }
+    return true;
+}
+
+void JniCallbackDispatcher::release(JNIEnv* env) {
+    stop();
+    clearTarget(env);
+    if (callbackClass) {
+        env->DeleteGlobalRef(callbackClass);
+        callbackClass = nullptr;
+    }
+}
+
+void JniCallbackDispatcher::start() {
+    if (running.exchange(true)) return;
+    thread = std::thread(&JniCallbackDispatcher::run, this);
+}
+
+void JniCallbackDispatcher::stop() {
+    if (!running.exchange(false)) return;
+    signal.notify();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void JniCallbackDispatcher::setTarget(JNIEnv* env, jobject callback,
+                                      const std::vector<std::string>& wakeWords, size_t streams) {
+    std::lock_guard<std::mutex> lock(targetMutex);
+    releaseTarget(env);
+
+    target = env->NewWeakGlobalRef(callback);
+    targetStreams = streams;
+    assignWakeWords(env, wakeWords);
+    voiceActive.assign(streams, 0);
+    voiceFinal.assign(streams, 0);
+    voiceToggles.assign(streams, 0);
+    voiceStartAt.assign(streams, -1);
+    voiceEndAt.assign(streams, -1);
+    pendingCaptures.clear();
+    pendingCaptures.reserve(maxPendingCaptures);
+}
+
+void JniCallbackDispatcher::setWakeWords(JNIEnv* env, const std::vector<std::string>& wakeWords) {
+    std::lock_guard<std::mutex> lock(targetMutex);
+    for (jstring name : wakeWordNames) {
+        env->DeleteGlobalRef(name);
+    }
+    wakeWordNames.clear();
+    assignWakeWords(env, wakeWords);
+}
+
+// Cached names and per-wake-word pending state; caller holds targetMutex
+void JniCallbackDispatcher::assignWakeWords(JNIEnv* env, const std::vector<std::string>& wakeWords) {
+    for (const auto& name : wakeWords) {
+        jstring local = env->NewStringUTF(name.c_str());
+        wakeWordNames.push_back(static_cast<jstring>(env->NewGlobalRef(local)));
+        env->DeleteLocalRef(local);
+    }
+    targetWakeWords = wakeWords.size();
+    pendingDetections.assign(targetStreams * wakeWords.size(), 0);
+}
+
+void JniCallbackDispatcher::clearTarget(JNIEnv* env) {
+    std::lock_guard<std::mutex> lock(targetMutex);
+    releaseTarget(env);
+    targetWakeWords = 0;
+    targetStreams = 0;
+    pendingDetections.clear();
+    voiceActive.clear();
+    voiceFinal.clear();
+    voiceToggles.clear();
+    voiceStartAt.clear();
+    voiceEndAt.clear();
+    pendingCaptures.clear();
+}
+
+void JniCallbackDispatcher::releaseTarget(JNIEnv* env) {
+    if (target) {
+        env->DeleteWeakGlobalRef(target);
+        target = nullptr;
+    }
+    for (jstring name : wakeWordNames) {
+        env->DeleteGlobalRef(name);
+    }
+    wakeWordNames.clear();
+}
+
+void JniCallbackDispatcher::postWakeWord(int wakeWord, int stream) {
+    Event event;
+    event.type = EventType::WakeWord;
+    event.wakeWord = static_cast<int16_t>(wakeWord);
+    event.stream = static_cast<int16_t>(stream);
+    post(event);
+}
+
+void JniCallbackDispatcher::postVoiceActivity(bool active, int stream, int64_t position) {
+    Event event;
+    event.type = EventType::VoiceActivity;
+    event.active = active;
+    event.stream = static_cast<int16_t>(stream);
+    event.position = position;
+    post(event);
+}
+
+void JniCallbackDispatcher::postCaptureStarted(int wakeWord, uint64_t startPosition) {
+    Event event;
+    event.type = EventType::CaptureStarted;
+    event.wakeWord = static_cast<int16_t>(wakeWord);
+    event.position = static_cast<int64_t>(startPosition);
+    post(event);
+}
+
+void JniCallbackDispatcher::postCaptureEnded(int wakeWord, uint64_t endPosition) {
+    Event event;
+    event.type = EventType::CaptureEnded;
+    event.wakeWord = static_cast<int16_t>(wakeWord);
+    event.position = static_cast<int64_t>(endPosition);
+    post(event);
+}
+
+void JniCallbackDispatcher::post(const Event& event) {
+    if (!queue.tryPush(event)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    signal.notify();
+}
+
+// Dispatcher thread: attached once, sleeps on the futex until events arrive
+void JniCallbackDispatcher::run() {
+    JNIEnv* env = nullptr;
+    JavaVMAttachArgs args{JNI_VERSION_1_6, "WakeWordCallbacks", nullptr};
+    if (javaVM->AttachCurrentThread(&env, &args) != JNI_OK || env == nullptr) {
+        LOGE("Failed to attach callback dispatcher to the JVM");
+        return;
+    }
+    LOGI("Callback dispatcher started");
+
+    while (running) {
+        const uint32_t seen = signal.epoch();
+        drain(env);
+        if (running) signal.wait(seen);
+    }
+    // Deliver whatever was posted before stop()
+    drain(env);
+
+    javaVM->DetachCurrentThread();
+    LOGI("Callback dispatcher exiting (%llu events dropped)",
+         static_cast<unsigned long long>(dropped.load()));
+}
+
+void JniCallbackDispatcher::drain(JNIEnv* env) {
+    jobject callback = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(targetMutex);
+        if (!collect(env)) return;
+        callback = target ? env->NewLocalRef(target) : nullptr;
+    }
+
+    // Java runs without targetMutex, so a callback may restart the detector or
+    // change its wake words
+    for (const Delivery& delivery : deliveries) {
+        if (callback) deliver(env, callback, delivery);
+        if (delivery.name) env->DeleteLocalRef(delivery.name);
+    }
+    deliveries.clear();
+
+    if (callback) {
+        env->DeleteLocalRef(callback);
+    }
+}
+
+// Pop and coalesce the queue into `deliveries`, in delivery order, with a local
+// ref per name; caller holds targetMutex. Returns false if nothing was queued.
+bool JniCallbackDispatcher::collect(JNIEnv* env) {
+    // Coalesce everything queued so far
+    std::copy(voiceActive.begin(), voiceActive.end(), voiceFinal.begin());
+    std::fill(voiceToggles.begin(), voiceToggles.end(), 0);
+    size_t received = 0;
+    Event event;
+    while (queue.tryPop(event)) {
+        received++;
+        const size_t stream = static_cast<size_t>(event.stream);
+        if (stream >= targetStreams) continue;
+        const size_t wakeWord = static_cast<size_t>(event.wakeWord);
+        const size_t index = stream * targetWakeWords + wakeWord;
+        switch (event.type) {
+            case EventType::WakeWord:
+                if (wakeWord < targetWakeWords) pendingDetections[index]++;
+                break;
+            case EventType::VoiceActivity:
+                (event.active ? voiceStartAt : voiceEndAt)[stream] = event.position;
+                if (event.active != static_cast<bool>(voiceFinal[stream])) {
+                    voiceFinal[stream] = event.active;
+                    voiceToggles[stream]++;
+                }
+                break;
+            case EventType::CaptureStarted:
+            case EventType::CaptureEnded:
+                if (wakeWord < targetWakeWords && pendingCaptures.size() < maxPendingCaptures) {
+                    pendingCaptures.push_back(event);
+                }
+                break;
+        }
+    }
+    if (received == 0) return false;
+
+    deliveries.reserve(targetStreams * (targetWakeWords + 2) + maxPendingCaptures);
+    for (size_t stream = 0; stream < targetStreams; stream++) {
+        // Voice activity first, so a detection is never reported outside its segment
+        if (voiceToggles[stream] > 0) {
+            if (voiceFinal[stream] == voiceActive[stream]) {
+                addVoiceActivity(stream, !voiceFinal[stream]);
+            }
+            addVoiceActivity(stream, voiceFinal[stream]);
+        }
+        voiceActive[stream] = voiceFinal[stream];
+
+        for (size_t i = 0; i < targetWakeWords; i++) {
+            uint32_t& detections = pendingDetections[stream * targetWakeWords + i];
+            if (detections == 0) continue;
+            if (detections > 1) {
+                LOGD("Coalesced %u detections of wake word %zu", detections, i);
+            }
+            detections = 0;
+            deliveries.push_back({EventType::WakeWord, false, static_cast<int16_t>(stream),
+                                  static_cast<jstring>(env->NewLocalRef(wakeWordNames[i])), 0});
+        }
+    }
+
+    // After the detections, so Java hears about the wake word before its audio
+    for (const Event& capture : pendingCaptures) {
+        deliveries.push_back({capture.type, false, 0,
+                              static_cast<jstring>(env->NewLocalRef(wakeWordNames[capture.wakeWord])),
+                              capture.position});
+    }
+    pendingCaptures.clear();
+    return true;
+}
+
+void JniCallbackDispatcher::addVoiceActivity(size_t stream, bool active) {
+    const int64_t position = active ? voiceStartAt[stream] : voiceEndAt[stream];
+    deliveries.push_back({EventType::VoiceActivity, active, static_cast<int16_t>(stream), nullptr,
+                          position});
+}
+
+void JniCallbackDispatcher::deliver(JNIEnv* env, jobject callback, const Delivery& delivery) {
+    switch (delivery.type) {
+        case EventType::WakeWord:
+            if (withStreamIds) {
+                env->CallVoidMethod(callback, onWakeWordDetected, static_cast<jint>(delivery.stream),
+                                    delivery.name);
+            } else {
+                env->CallVoidMethod(callback, onWakeWordDetected, delivery.name);
+            }
+            break;
+        case EventType::VoiceActivity: {
+            jmethodID method = delivery.active ? onVoiceActivityStarted : onVoiceActivityEnded;
+            if (!method) return;
+            if (withStreamIds) {
+                env->CallVoidMethod(callback, method, static_cast<jint>(delivery.stream));
+            } else {
+                env->CallVoidMethod(callback, method, static_cast<jlong>(delivery.position));
+            }
+            break;
+        }
+        case EventType::CaptureStarted:
+        case EventType::CaptureEnded: {
+            jmethodID method = delivery.type == EventType::CaptureStarted ? onAudioCaptureStarted
+                                                                          : onAudioCaptureEnded;
+            if (!method) return;
+            env->CallVoidMethod(callback, method, delivery.name,
+                                static_cast<jlong>(delivery.position));
+            break;
+        }
+    }
+    clearException(env);
+}
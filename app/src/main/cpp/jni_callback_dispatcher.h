@@ -0,0 +1,138 @@
+#pragma once
+
+#include <jni.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "event_signal.h"
+#include "mpsc_queue.h"
+
+// Delivers pipeline events to the Java WakeupDetectorCallback from one
+// dispatcher thread that attaches to the JVM once for its whole lifetime.
+// Inference and audio threads only post(): a CAS into a fixed queue plus a futex
+// wake when the dispatcher sleeps, never a JNI call, lock or allocation.
+//
+// Each wake-up drains everything queued and coalesces it before calling Java:
+// repeated detections of one wake word become one onWakeWordDetected, and a
+// burst of voice activity toggles collapses to its final state (plus the opposite edge first if the
+// state flipped and came back, so Java still sees the segment).
+//
+// Capture session start and end events are never coalesced; they are delivered
+// in order after the batch's detections.
+//
+// Java is called with no native lock held, so a callback may call back into
+// the detector (start(), addWakeWord(), ...) from the dispatcher thread.
+//
+// Each detector owns its dispatcher. In multi-stream mode the target is a
+// MultiStreamWakeupCallback, every event carries its stream id, and coalescing
+// happens per stream.
+class JniCallbackDispatcher {
+public:
+    JniCallbackDispatcher() = default;
+    ~JniCallbackDispatcher();
+
+    JniCallbackDispatcher(const JniCallbackDispatcher&) = delete;
+    JniCallbackDispatcher& operator=(const JniCallbackDispatcher&) = delete;
+
+    // Resolve the callback interface and its methods; call from a Java thread
+    // (the app class loader is needed to find the interface)
+    bool initialize(JavaVM* vm, JNIEnv* env, bool multiStream = false);
+
+    // stop(), then drop the target and the class reference
+    void release(JNIEnv* env);
+
+    // Start the dispatcher thread if it is not already running
+    void start();
+
+    // Deliver what is still queued, then detach and join the dispatcher thread
+    void stop();
+
+    // Route events to `callback` (held weakly); pre-creates one jstring per
+    // wake word so detections never build strings on the dispatcher thread.
+    // Events for streams outside [0, streams) are ignored.
+    void setTarget(JNIEnv* env, jobject callback, const std::vector<std::string>& wakeWords,
+                   size_t streams = 1);
+    void clearTarget(JNIEnv* env);
+    
+    // Replace the wake word list after keywords were added or removed, keeping
+    // the target; detections of a new index drained before this call are dropped
+    void setWakeWords(JNIEnv* env, const std::vector<std::string>& wakeWords);
+
+    // Non-blocking producers, safe from any thread. `wakeWord` indexes the list
+    // given to setTarget(); events are dropped (and counted) if the queue is full
+    void postWakeWord(int wakeWord, int stream = 0);
+    // `position` is the edge's sample position, passed to single-stream callbacks
+    void postVoiceActivity(bool active, int stream = 0, int64_t position = -1);
+    void postCaptureStarted(int wakeWord, uint64_t startPosition);
+    void postCaptureEnded(int wakeWord, uint64_t endPosition);
+
+    uint64_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    enum class EventType : uint8_t { WakeWord, VoiceActivity, CaptureStarted, CaptureEnded };
+
+    struct Event {
+        EventType type = EventType::WakeWord;
+        bool active = false;
+        int16_t wakeWord = 0;
+        int16_t stream = 0;
+        int64_t position = 0;
+    };
+
+    // One Java call of a drained batch, built under targetMutex and made after
+    // it is released; `name` is a local ref
+    struct Delivery {
+        EventType type = EventType::WakeWord;
+        bool active = false;
+        int16_t stream = 0;
+        jstring name = nullptr;
+        int64_t position = 0;
+    };
+
+    static constexpr size_t queueCapacity = 256;
+    static constexpr size_t maxPendingCaptures = 16;
+
+    void post(const Event& event);
+    void run();
+    void drain(JNIEnv* env);
+    bool collect(JNIEnv* env);
+    void addVoiceActivity(size_t stream, bool active);
+    void deliver(JNIEnv* env, jobject callback, const Delivery& delivery);
+    void releaseTarget(JNIEnv* env);
+    void assignWakeWords(JNIEnv* env, const std::vector<std::string>& wakeWords);
+
+    JavaVM* javaVM = nullptr;
+    bool withStreamIds = false;  // Java methods take the stream id first
+    jclass callbackClass = nullptr;  // global ref, keeps the method IDs valid
+    jmethodID onWakeWordDetected = nullptr;
+    jmethodID onVoiceActivityStarted = nullptr;  // (long position) when single-stream
+    jmethodID onVoiceActivityEnded = nullptr;
+    jmethodID onAudioCaptureStarted = nullptr;  // single-stream only
+    jmethodID onAudioCaptureEnded = nullptr;
+
+    MpscQueue<Event> queue{queueCapacity};
+    EventSignal signal;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> dropped{0};
+    std::thread thread;
+
+    // Target and per-wake-word state; the dispatcher holds this only while it
+    // drains the queue, never while it calls into Java or producers are involved
+    std::mutex targetMutex;
+    jweak target = nullptr;
+    std::vector<jstring> wakeWordNames;  // global refs
+    size_t targetWakeWords = 0;
+    size_t targetStreams = 0;
+    std::vector<uint32_t> pendingDetections;  // [stream * wakeWords + wakeWord]
+    std::vector<uint8_t> voiceActive;   // per stream, last state delivered to Java
+    std::vector<uint8_t> voiceFinal;    // per stream, state at the end of this batch
+    std::vector<uint32_t> voiceToggles; // per stream, edges seen in this batch
+    std::vector<int64_t> voiceStartAt;  // per stream, position of the latest start edge
+    std::vector<int64_t> voiceEndAt;    // per stream, position of the latest end edge
+    std::vector<Event> pendingCaptures; // in arrival order, up to maxPendingCaptures
+
+    std::vector<Delivery> deliveries;   // dispatcher thread only, the batch being delivered
+};
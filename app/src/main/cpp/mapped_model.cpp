@@ -0,0 +1,220 @@
+#include "mapped_model.h"
+#include "platform_log.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#ifdef __ANDROID__
+#include <android/asset_manager.h>
+#endif
+
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "MappedModel", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "MappedModel", __VA_ARGS__)
+
+namespace {
+
+std::mutex cacheMutex;
+std::map<std::string, std::unique_ptr<MappedModel>> cache;
+
+#ifdef __ANDROID__
+AAssetManager* assetManager = nullptr;
+#endif
+
+// Map `length` bytes at `offset` of `fd`; mmap offsets must be page aligned
+void mapRange(int fd, off_t offset, size_t length, MappedModel& model) {
+    const off_t pageSize = sysconf(_SC_PAGESIZE);
+    const off_t alignedOffset = offset & ~(pageSize - 1);
+    const size_t delta = static_cast<size_t>(offset - alignedOffset);
+
+    void* base = mmap(nullptr, length + delta, PROT_READ, MAP_PRIVATE, fd, alignedOffset);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error(std::string("mmap failed: ") + std::strerror(errno));
+    }
+    model.mapBase = base;
+    model.mapLength = length + delta;
+    model.data = static_cast<const char*>(base) + delta;
+    model.size = length;
+    model.fileBacked = true;
+}
+
+std::unique_ptr<MappedModel> mapFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open model " + path);
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        throw std::runtime_error("cannot stat model " + path);
+    }
+
+    auto model = std::make_unique<MappedModel>();
+    try {
+        mapRange(fd, 0, static_cast<size_t>(info.st_size), *model);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);  // the mapping keeps the file referenced
+    return model;
+}
+
+#ifdef __ANDROID__
+std::unique_ptr<MappedModel> mapAsset(const std::string& name) {
+    if (!assetManager) {
+        throw std::runtime_error("no asset manager set for " + name);
+    }
+    AAsset* asset = AAssetManager_open(assetManager, name.c_str(), AASSET_MODE_RANDOM);
+    if (!asset) {
+        throw std::runtime_error("cannot open asset " + name);
+    }
+
+    auto model = std::make_unique<MappedModel>();
+    off64_t start = 0, length = 0;
+    const int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+    if (fd >= 0) {
+        // Stored uncompressed: map the APK range directly
+        try {
+            mapRange(fd, static_cast<off_t>(start), static_cast<size_t>(length), *model);
+        } catch (...) {
+            close(fd);
+            AAsset_close(asset);
+            throw;
+        }
+        close(fd);
+    } else {
+        LOGW("Asset %s is compressed; add it to androidResources.noCompress to map it", name.c_str());
+        const size_t size = static_cast<size_t>(AAsset_getLength64(asset));
+        void* copy = std::malloc(size);
+        if (!copy || AAsset_read(asset, copy, size) != static_cast<int>(size)) {
+            std::free(copy);
+            AAsset_close(asset);
+            throw std::runtime_error("cannot read asset " + name);
+        }
+        model->data = copy;
+        model->size = size;
+    }
+    AAsset_close(asset);
+    return model;
+}
+#endif
+
+} // namespace
+
+#ifdef __ANDROID__
+void setModelAssetManager(AAssetManager* manager) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    assetManager = manager;
+}
+#endif
+
+bool isAssetModel(const std::string& ref) {
+    return ref.compare(0, sizeof(assetModelPrefix) - 1, assetModelPrefix) == 0;
+}
+
+bool modelExists(const std::string& ref) {
+    if (isAssetModel(ref)) {
+#ifdef __ANDROID__
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (!assetManager) return false;
+        AAsset* asset = AAssetManager_open(assetManager, ref.c_str() + sizeof(assetModelPrefix) - 1,
+                                           AASSET_MODE_UNKNOWN);
+        if (asset) AAsset_close(asset);
+        return asset != nullptr;
+#else
+        return false;
+#endif
+    }
+    return access(ref.c_str(), R_OK) == 0;
+}
+
+const MappedModel& mapModel(const std::string& ref) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(ref);
+    if (it != cache.end()) {
+        return *it->second;
+    }
+
+    std::unique_ptr<MappedModel> model;
+    if (isAssetModel(ref)) {
+#ifdef __ANDROID__
+        model = mapAsset(ref.substr(sizeof(assetModelPrefix) - 1));
+#else
+        throw std::runtime_error("asset models are only available on Android: " + ref);
+#endif
+    } else {
+        model = mapFile(ref);
+    }
+    LOGI("Mapped %s (%zu bytes, %s)", ref.c_str(), model->size,
+         model->fileBacked ? "file-backed" : "heap copy");
+    return *cache.emplace(ref, std::move(model)).first->second;
+}
+
+void forgetModel(const std::string& ref) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(ref);
+    if (it == cache.end()) return;
+    const MappedModel& model = *it->second;
+    if (model.fileBacked) {
+        munmap(model.mapBase, model.mapLength);
+    } else {
+        std::free(const_cast<void*>(model.data));
+    }
+    cache.erase(it);
+}
+
+bool isOrtFormatModel(const MappedModel& model) {
+    // Flatbuffer file identifier at bytes 4..7
+    return model.size >= 8 && std::memcmp(static_cast<const char*>(model.data) + 4, "ORTM", 4) == 0;
+}
+
+uint64_t modelContentHash(const MappedModel& model) {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (model.contentHash == 0) {
+        uint64_t hash = 14695981039346656037ull;
+        const auto* bytes = static_cast<const unsigned char*>(model.data);
+        for (size_t i = 0; i < model.size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        model.contentHash = hash ? hash : 1;
+    }
+    return model.contentHash;
+}
+
+void releaseModelPages(const MappedModel& model) {
+    if (model.fileBacked) {
+        madvise(model.mapBase, model.mapLength, MADV_DONTNEED);
+    }
+}
+
+MappedModelUsage mappedModelUsage() {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    MappedModelUsage usage;
+    std::vector<unsigned char> pages;
+    for (const auto& entry : cache) {
+        const MappedModel& model = *entry.second;
+        usage.models++;
+        if (!model.fileBacked) {
+            usage.heapBytes += model.size;
+            continue;
+        }
+        usage.mappedBytes += model.size;
+        pages.resize((model.mapLength + pageSize - 1) / pageSize);
+        if (mincore(model.mapBase, model.mapLength, pages.data()) == 0) {
+            for (unsigned char page : pages) {
+                if (page & 1) usage.residentBytes += pageSize;
+            }
+        }
+    }
+    return usage;
+}
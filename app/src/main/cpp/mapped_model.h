@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef __ANDROID__
+struct AAssetManager;
+#endif
+
+// Read-only view of a model's bytes for building sessions from memory.
+// A model reference is either a file path or "asset:<name>" for a file inside
+// the APK (e.g. "asset:models/embedding_model.onnx"). Files and uncompressed
+// assets are mmap'd, so the bytes are clean file-backed pages that the kernel
+// can drop and re-read at will; compressed assets are inflated into the heap.
+// Mappings are cached per reference and live until the process exits, which
+// lets sessions use the bytes in place.
+struct MappedModel {
+    const void* data = nullptr;
+    size_t size = 0;
+    bool fileBacked = false;  // mmap'd rather than copied
+    mutable uint64_t contentHash = 0;  // 0 until modelContentHash() runs
+
+    // Whole pages covering `data`, for madvise()
+    void* mapBase = nullptr;
+    size_t mapLength = 0;
+};
+
+constexpr const char assetModelPrefix[] = "asset:";
+
+#ifdef __ANDROID__
+// Asset manager used to resolve "asset:" references; must stay valid (the
+// caller holds a global ref to the Java AssetManager)
+void setModelAssetManager(AAssetManager* manager);
+#endif
+
+bool isAssetModel(const std::string& ref);
+
+// True if the reference names a readable file or asset
+bool modelExists(const std::string& ref);
+
+// Map the model, or return the existing mapping; throws std::runtime_error
+const MappedModel& mapModel(const std::string& ref);
+
+// Unmap a model no session uses, e.g. a cache file that failed to load
+void forgetModel(const std::string& ref);
+
+// True for ORT flatbuffer models (usable in place by ORT) rather than ONNX protobuf
+bool isOrtFormatModel(const MappedModel& model);
+
+// 64-bit FNV-1a of the model bytes, cached with the mapping
+uint64_t modelContentHash(const MappedModel& model);
+
+// Give back the resident pages of a file-backed mapping once a session has
+// copied what it needs; the mapping stays valid and refaults from flash
+void releaseModelPages(const MappedModel& model);
+
+// Totals over every cached model, for memory reports
+struct MappedModelUsage {
+    size_t models = 0;
+    size_t mappedBytes = 0;    // file-backed mappings
+    size_t residentBytes = 0;  // pages of those mappings currently in memory
+    size_t heapBytes = 0;      // compressed assets inflated into the heap
+};
+MappedModelUsage mappedModelUsage();
@@ -0,0 +1,162 @@
+#include "mel_frontend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 10*log10 amin of the exported graph, and its 80 dB top_db floor in log10 units
+constexpr float minPower = 1e-10f;
+constexpr float floorBelowPeak = 8.0f;
+// Offset of the (x / 10) + 2 rescale once the 10x is folded into log10
+constexpr float rescaleOffset = 2.0f;
+
+// librosa's Slaney mel scale: linear below 1 kHz, logarithmic above
+double hzToMel(double hz) {
+    const double fSp = 200.0 / 3.0;
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / fSp;
+    const double logStep = std::log(6.4) / 27.0;
+    return hz >= minLogHz ? minLogMel + std::log(hz / minLogHz) / logStep : hz / fSp;
+}
+
+double melToHz(double mel) {
+    const double fSp = 200.0 / 3.0;
+    const double minLogHz = 1000.0;
+    const double minLogMel = minLogHz / fSp;
+    const double logStep = std::log(6.4) / 27.0;
+    return mel >= minLogMel ? minLogHz * std::exp(logStep * (mel - minLogMel)) : fSp * mel;
+}
+
+float dot(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+#ifdef SIMD_FLOAT4
+    simd::f32x4 acc = simd::set1(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        acc = simd::mulAdd(simd::load(a + i), simd::load(b + i), acc);
+    }
+    sum = simd::horizontalSum(acc);
+#endif
+    for (; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+MelFrontEnd::MelFrontEnd(size_t maxBlockSamples)
+    : maxBlock(maxBlockSamples),
+      buffer(fftSize + maxBlockSamples, 0.0f),
+      output((maxBlockSamples / hopLength + 1) * numMels, 0.0f) {
+    buildWindow();
+    buildFilterbank();
+    reset();
+}
+
+// Periodic Hann of windowLength, zero-padded on both sides to fftSize
+void MelFrontEnd::buildWindow() {
+    const double pi = 3.14159265358979323846;
+    const size_t pad = (fftSize - windowLength) / 2;
+    window.fill(0.0f);
+    for (size_t n = 0; n < windowLength; n++) {
+        window[pad + n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * n / windowLength));
+    }
+}
+
+// librosa.filters.mel(sr, n_fft, n_mels, fmin, fmax) with Slaney normalization,
+// stored sparsely since each band covers at most a few dozen bins
+void MelFrontEnd::buildFilterbank() {
+    const size_t numBins = RealFft<fftSize>::bins;
+    const double minMel = hzToMel(minFrequency);
+    const double maxMel = hzToMel(maxFrequency);
+
+    std::array<double, numMels + 2> edges{};
+    for (size_t i = 0; i < edges.size(); i++) {
+        edges[i] = melToHz(minMel + (maxMel - minMel) * i / (numMels + 1));
+    }
+
+    bandWeights.clear();
+    for (size_t m = 0; m < numMels; m++) {
+        const double lower = edges[m], centre = edges[m + 1], upper = edges[m + 2];
+        const double norm = 2.0 / (upper - lower);
+
+        bands[m].offset = static_cast<uint32_t>(bandWeights.size());
+        bands[m].firstBin = 0;
+        bands[m].numBins = 0;
+        for (size_t bin = 0; bin < numBins; bin++) {
+            const double hz = static_cast<double>(sampleRate) * bin / fftSize;
+            const double rising = (hz - lower) / (centre - lower);
+            const double falling = (upper - hz) / (upper - centre);
+            const double weight = std::max(0.0, std::min(rising, falling)) * norm;
+            if (weight <= 0.0) {
+                if (bands[m].numBins > 0) break;
+                continue;
+            }
+            if (bands[m].numBins == 0) {
+                bands[m].firstBin = static_cast<uint16_t>(bin);
+            }
+            bandWeights.push_back(static_cast<float>(weight));
+            bands[m].numBins++;
+        }
+    }
+}
+
+void MelFrontEnd::reset() {
+    // Start one hop short of a full frame so the first frame completes after hopLength samples
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    buffered = fftSize - hopLength;
+}
+
+size_t MelFrontEnd::process(const float* samples, size_t count) {
+    count = std::min(count, maxBlock);
+    std::memcpy(buffer.data() + buffered, samples, count * sizeof(float));
+    buffered += count;
+
+    size_t numFrames = 0;
+    size_t pos = 0;
+    float peak = -INFINITY;
+    for (; pos + fftSize <= buffered; pos += hopLength, numFrames++) {
+        const float* src = buffer.data() + pos;
+        size_t i = 0;
+#ifdef SIMD_FLOAT4
+        for (; i + 4 <= fftSize; i += 4) {
+            simd::store(&frame[i], simd::mul(simd::load(src + i), simd::load(&window[i])));
+        }
+#endif
+        for (; i < fftSize; i++) {
+            frame[i] = src[i] * window[i];
+        }
+
+        fft.powerSpectrum(frame.data(), power.data());
+
+        float* mels = &output[numFrames * numMels];
+        for (size_t m = 0; m < numMels; m++) {
+            const MelBand& band = bands[m];
+            const float energy = dot(&power[band.firstBin], &bandWeights[band.offset], band.numBins);
+            mels[m] = std::log10(std::max(energy, minPower));
+            peak = std::max(peak, mels[m]);
+        }
+    }
+
+    // Carry the samples the next frame overlaps with
+    buffered -= pos;
+    std::memmove(buffer.data(), buffer.data() + pos, buffered * sizeof(float));
+
+    // 80 dB floor below this block's peak, then the embedding model's rescale
+    const float floor = peak - floorBelowPeak;
+    const size_t values = numFrames * numMels;
+    size_t i = 0;
+#ifdef SIMD_FLOAT4
+    const simd::f32x4 vfloor = simd::set1(floor);
+    const simd::f32x4 voffset = simd::set1(rescaleOffset);
+    for (; i + 4 <= values; i += 4) {
+        simd::store(&output[i], simd::add(simd::max(simd::load(&output[i]), vfloor), voffset));
+    }
+#endif
+    for (; i < values; i++) {
+        output[i] = std::max(output[i], floor) + rescaleOffset;
+    }
+    return numFrames;
+}
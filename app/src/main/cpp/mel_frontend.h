@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "real_fft.h"
+
+// Native replacement for melspectrogram.onnx.
+// Reproduces the exported graph: a 400-sample periodic Hann window centred in a
+// 512-point frame, hop 160, power spectrum, the librosa (Slaney) 32-band mel
+// filterbank over 60-3800 Hz, 10*log10 with amin 1e-10 and an 80 dB floor below
+// the loudest frame. The (x / 10) + 2 rescale the embedding model expects is
+// folded into the log step, so frames come out ready for the mel window.
+//
+// Unlike the ONNX path, which is fed 5120-sample blocks with no overlap between
+// them, the front end keeps the last 352 samples between calls and emits one frame
+// per 160 new samples, so any block size works and each 1280-sample chunk yields
+// 8 frames. Against the model's own weights, on frames aligned to its grid, the
+// largest difference after rescale was 7e-5 on speech-like audio and 4e-5 on a
+// loud tone (float32 rounding of the weakest bands next to loud ones). It stayed
+// under 2e-6 on digital silence and noise of a few LSB, and the mean per frame
+// stayed under 4e-6. wakeword_replay --compare-mels measures this against the
+// model and fails above 5e-4. The 80 dB floor is taken per call rather than per
+// 5120 samples, which only changes values more than 80 dB below the block's
+// loudest frame.
+class MelFrontEnd {
+public:
+    static constexpr size_t sampleRate = 16000;
+    static constexpr size_t fftSize = 512;
+    static constexpr size_t windowLength = 400;
+    static constexpr size_t hopLength = 160;
+    static constexpr size_t numMels = 32;
+    static constexpr float minFrequency = 60.0f;
+    static constexpr float maxFrequency = 3800.0f;
+
+    // `maxBlockSamples` bounds the samples passed to one process() call
+    explicit MelFrontEnd(size_t maxBlockSamples);
+
+    // Forget buffered audio; the next frame starts from silence
+    void reset();
+
+    // Consume `count` (<= maxBlockSamples) samples in int16 scale, returns the
+    // number of complete frames now available from frames()
+    size_t process(const float* samples, size_t count);
+
+    // numMels floats per frame produced by the last process() call
+    const float* frames() const { return output.data(); }
+
+private:
+    void buildWindow();
+    void buildFilterbank();
+
+    // Mel band as a contiguous run of non-zero weights over the FFT bins
+    struct MelBand {
+        uint16_t firstBin;
+        uint16_t numBins;
+        uint32_t offset;
+    };
+
+    RealFft<fftSize> fft;
+    std::array<float, fftSize> window{};
+    std::array<MelBand, numMels> bands{};
+    std::vector<float> bandWeights;
+
+    size_t maxBlock;
+    std::vector<float> buffer;  // carried-over samples followed by the new block
+    size_t buffered = 0;
+    std::vector<float> output;  // log10 mels, then rescaled in place
+    std::array<float, fftSize> frame{};
+    std::array<float, RealFft<fftSize>::bins> power{};
+};
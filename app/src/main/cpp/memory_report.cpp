@@ -0,0 +1,74 @@
+#include "memory_report.h"
+#include "mapped_model.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// "VmRSS:     12345 kB" lines of /proc/self/status
+size_t statusKilobytes(const char* line, const char* key) {
+    const size_t length = std::strlen(key);
+    if (std::strncmp(line, key, length) != 0 || line[length] != ':') return 0;
+    unsigned long long kilobytes = 0;
+    std::sscanf(line + length + 1, "%llu", &kilobytes);
+    return static_cast<size_t>(kilobytes) * 1024;
+}
+
+void appendField(std::string& json, const char* name, size_t bytes) {
+    if (json.size() > 1) json += ',';
+    json += '"';
+    json += name;
+    json += "\":";
+    json += std::to_string(bytes);
+}
+
+} // namespace
+
+void MemoryReport::readProcessUsage() {
+    const MappedModelUsage models = mappedModelUsage();
+    modelCount = models.models;
+    modelMappedBytes = models.mappedBytes;
+    modelResidentBytes = models.residentBytes;
+    modelHeapBytes = models.heapBytes;
+
+    FILE* status = std::fopen("/proc/self/status", "r");
+    if (!status) return;
+    char line[256];
+    const struct {
+        const char* key;
+        size_t* field;
+    } fields[] = {{"VmRSS", &residentBytes}, {"VmHWM", &peakResidentBytes},
+                  {"RssAnon", &anonymousBytes}, {"RssFile", &fileBytes}};
+    while (std::fgets(line, sizeof(line), status)) {
+        for (const auto& field : fields) {
+            if (const size_t bytes = statusKilobytes(line, field.key)) {
+                *field.field = bytes;
+            }
+        }
+    }
+    std::fclose(status);
+}
+
+std::string MemoryReport::toJson() const {
+    std::string json = "{";
+    appendField(json, "sampleRing", sampleRing);
+    appendField(json, "vadRing", vadRing);
+    appendField(json, "preRoll", preRoll);
+    appendField(json, "melWindow", melWindow);
+    appendField(json, "featureWindow", featureWindow);
+    appendField(json, "wakeWordHeads", wakeWordHeads);
+    appendField(json, "captureRing", captureRing);
+    appendField(json, "scoreRing", scoreRing);
+    appendField(json, "stageScratch", stageScratch);
+    appendField(json, "pipeline", pipelineBytes());
+    appendField(json, "models", modelCount);
+    appendField(json, "modelMapped", modelMappedBytes);
+    appendField(json, "modelResident", modelResidentBytes);
+    appendField(json, "modelHeap", modelHeapBytes);
+    appendField(json, "resident", residentBytes);
+    appendField(json, "peakResident", peakResidentBytes);
+    appendField(json, "anonymous", anonymousBytes);
+    appendField(json, "file", fileBytes);
+    json += '}';
+    return json;
+}
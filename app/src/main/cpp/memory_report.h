@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Native memory of one detector and of the process, in bytes. The buffer
+// figures are exact allocation sizes; the model and process figures are read
+// from the model cache and /proc/self/status when the report is built. ORT
+// keeps no arena statistics in this version, so the shared CPU arena shows up
+// in the process's anonymous memory rather than as a line of its own.
+struct MemoryReport {
+    // Pipeline buffers owned by the detector, all allocated by initialize() or
+    // a setter before start(); nothing on the audio path grows them
+    size_t sampleRing = 0;      // samples queued for the mel stage, with their arrival marks
+    size_t vadRing = 0;         // samples queued for VAD
+    size_t preRoll = 0;         // audio held back while VAD gating is closed
+    size_t melWindow = 0;       // mel frames, with per-slot timestamps
+    size_t featureWindow = 0;   // embeddings every wake word head reads in place
+    size_t wakeWordHeads = 0;   // per-head score buffers
+    size_t captureRing = 0;     // post-wake capture
+    size_t scoreRing = 0;       // score telemetry
+    size_t stageScratch = 0;    // bound model inputs/outputs, conversion and resampler buffers
+
+    // Models mapped by this process, shared by every detector
+    size_t modelCount = 0;
+    size_t modelMappedBytes = 0;    // file-backed mappings; clean pages the kernel can drop
+    size_t modelResidentBytes = 0;  // of those, currently in memory
+    size_t modelHeapBytes = 0;      // compressed assets inflated into the heap
+
+    // Process footprint; 0 where /proc is not readable
+    size_t residentBytes = 0;       // VmRSS
+    size_t peakResidentBytes = 0;   // VmHWM
+    size_t anonymousBytes = 0;      // RssAnon: heap, ORT arena and buffers
+    size_t fileBytes = 0;           // RssFile: mapped models and libraries
+
+    size_t pipelineBytes() const {
+        return sampleRing + vadRing + preRoll + melWindow + featureWindow + wakeWordHeads +
+               captureRing + scoreRing + stageScratch;
+    }
+
+    // Fill the model and process fields
+    void readProcessUsage();
+
+    // Snapshot as a JSON object; every value but "models" is in bytes
+    std::string toJson() const;
+};
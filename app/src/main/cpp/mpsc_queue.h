@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-capacity multi-producer/single-consumer queue of small trivially
+// copyable values. Every slot carries a sequence number (Vyukov's bounded
+// queue), so producers claim slots with one CAS and never wait on each other or
+// on the consumer: tryPush() fails instead of blocking when the queue is full.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+    explicit MpscQueue(size_t minCapacity) { allocate(minCapacity); }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Allocate storage; must not be called while either side is active
+    void allocate(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        slots = std::make_unique<Slot[]>(capacity);
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = capacity - 1;
+        tail.store(0, std::memory_order_relaxed);
+        head = 0;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Any thread: enqueue a copy of `value`, returns false if the queue is full
+    bool tryPush(const T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // the consumer has not freed this slot yet
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: dequeue the oldest value, returns false if none is ready
+    bool tryPop(T& value) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        value = slot.value;
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> tail{0};  // shared by producers
+    alignas(64) size_t head = 0;              // consumer only
+};
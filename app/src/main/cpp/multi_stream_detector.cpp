@@ -0,0 +1,609 @@
+#include "multi_stream_detector.h"
+#include "audio_convert.h"
+#include "platform_log.h"
+#include "trace_section.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#define LOGD(...) PLATFORM_LOG(PLATFORM_LOG_DEBUG, "MultiStreamDetector", __VA_ARGS__)
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "MultiStreamDetector", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "MultiStreamDetector", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "MultiStreamDetector", __VA_ARGS__)
+
+MultiStreamDetector::~MultiStreamDetector() {
+    stop();
+}
+
+// Warm the session up, then size the batch: a dynamic leading dimension is
+// probed once at full width, and any model whose output does not scale with it
+// is run one window at a time
+void MultiStreamDetector::BatchedStage::prepare(Ort::Session& model,
+                                                const std::vector<int64_t>& windowShape,
+                                                size_t maxBatch) {
+    Ort::AllocatorWithDefaultOptions allocator;
+    session = &model;
+    inputName = model.GetInputNameAllocated(0, allocator).get();
+    outputName = model.GetOutputNameAllocated(0, allocator).get();
+    inputFloats = shapeElementCount(windowShape);
+
+    const std::vector<int64_t> outputShape = warmUpSession(model, inputName, outputName, windowShape);
+    outputFloats = shapeElementCount(outputShape);
+
+    batchLimit = 1;
+    if (maxBatch > 1 && hasDynamicBatch(model) && !outputShape.empty()) {
+        std::vector<int64_t> batchShape = windowShape;
+        batchShape[0] = static_cast<int64_t>(maxBatch);
+        try {
+            const auto batchOutput = warmUpSession(model, inputName, outputName, batchShape);
+            if (!batchOutput.empty() && batchOutput[0] == static_cast<int64_t>(maxBatch) &&
+                shapeElementCount(batchOutput) == maxBatch * outputFloats) {
+                batchLimit = maxBatch;
+            }
+        } catch (const Ort::Exception& e) {
+            // e.g. a Reshape inside the graph that hardcodes a batch of 1
+            LOGW("%s does not run batched (%s)", inputName.c_str(), e.what());
+        }
+    }
+
+    input.assign(batchLimit * inputFloats, 0.0f);
+    output.assign(batchLimit * outputFloats, 0.0f);
+    auto memoryInfo = Ort::MemoryInfo::CreateCpu(
+        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    inputViews.clear();
+    outputViews.clear();
+    for (size_t b = 1; b <= batchLimit; b++) {
+        std::vector<int64_t> inShape = windowShape;
+        std::vector<int64_t> outShape = outputShape;
+        inShape[0] = static_cast<int64_t>(b);
+        outShape[0] = static_cast<int64_t>(b);
+        inputViews.push_back(Ort::Value::CreateTensor<float>(
+            memoryInfo, input.data(), b * inputFloats, inShape.data(), inShape.size()));
+        outputViews.push_back(Ort::Value::CreateTensor<float>(
+            memoryInfo, output.data(), b * outputFloats, outShape.data(), outShape.size()));
+    }
+}
+
+void MultiStreamDetector::BatchedStage::run(const Ort::RunOptions& options, size_t windows) {
+    const char* inputNames[] = {inputName.c_str()};
+    const char* outputNames[] = {outputName.c_str()};
+    session->Run(options, inputNames, &inputViews[windows - 1], 1,
+                 outputNames, &outputViews[windows - 1], 1);
+}
+
+bool MultiStreamDetector::initialize(const std::string& melModelPath, const std::string& embModelPath,
+                                     const std::vector<std::string>& wakeWordModelPaths,
+                                     size_t maxStreams, const StageProviders& providers,
+                                     const StagePrecisions& precisions) {
+    if (wakeWordModelPaths.empty() || maxStreams == 0) {
+        LOGE("Need at least one wake word model and one stream");
+        return false;
+    }
+    if (isRunning) {
+        LOGE("Cannot initialize while the detector is running");
+        return false;
+    }
+    isInitialized = false;
+    vadInitialized = false;
+
+    try {
+        if (useNativeMels) {
+            melSession.reset();
+            melFramesPerBlock = 0;
+            LOGI("Using native mel front end");
+        } else {
+            const std::vector<int64_t> melInputShape(Geometry::melInputShape.begin(),
+                                                     Geometry::melInputShape.end());
+            melSession = loadStageSession(melModelPath, providers.mel, precisions.mel);
+            if (!validateSessionIo(*melSession, "mel", melInputShape)) {
+                return false;
+            }
+            melStage.prepare(*melSession, melInputShape, maxStreams);
+            melFramesPerBlock = melStage.outputFloats / numMels;
+            if (melFramesPerBlock == 0 || melStage.outputFloats % numMels != 0) {
+                LOGE("Unexpected mel model output size %zu", melStage.outputFloats);
+                return false;
+            }
+        }
+
+        const std::vector<int64_t> embInputShape(Geometry::embInputShape.begin(),
+                                                 Geometry::embInputShape.end());
+        embSession = loadStageSession(embModelPath, providers.embedding, precisions.embedding);
+        if (!validateSessionIo(*embSession, "embedding", embInputShape)) {
+            return false;
+        }
+        embStage.prepare(*embSession, embInputShape, maxStreams);
+        if (embStage.outputFloats != embFeatures) {
+            LOGE("Unexpected embedding model output size %zu", embStage.outputFloats);
+            return false;
+        }
+
+        const std::vector<int64_t> wwInputShape(Geometry::wwInputShape.begin(),
+                                                Geometry::wwInputShape.end());
+        wwHeads = std::vector<WakeWordHead>(wakeWordModelPaths.size());
+        for (size_t i = 0; i < wakeWordModelPaths.size(); i++) {
+            auto& head = wwHeads[i];
+            head.name = std::filesystem::path(wakeWordModelPaths[i]).stem().string();
+            head.session = loadStageSession(wakeWordModelPaths[i], providers.wakeWord,
+                                            precisions.wakeWord);
+            if (!validateSessionIo(*head.session, head.name.c_str(), wwInputShape)) {
+                return false;
+            }
+            head.stage.prepare(*head.session, wwInputShape, maxStreams);
+            if (head.stage.outputFloats == 0) {
+                LOGE("Wake word model %s produces no scores", head.name.c_str());
+                return false;
+            }
+        }
+
+        // Every slot is allocated up front; addStream() only resets one
+        streams.clear();
+        for (size_t i = 0; i < maxStreams; i++) {
+            auto stream = std::make_unique<Stream>();
+            stream->id = static_cast<int>(i);
+            stream->sampleRing.allocate(sampleRingCapacity);
+            stream->scratch.resize(chunkSamples);
+            stream->melWindow.allocate(numMels, melWindowCapacity);
+            stream->featureWindow.allocate(embFeatures, featureWindowCapacity);
+            if (useNativeMels) {
+                stream->melFrontEnd = std::make_unique<MelFrontEnd>(chunkSamples);
+            }
+            stream->activation.assign(wwHeads.size(), 0);
+            streams.push_back(std::move(stream));
+        }
+        melStreams.reserve(maxStreams);
+        batchStreams.reserve(maxStreams);
+        wwStreams.reserve(maxStreams);
+
+        isInitialized = true;
+        LOGI("Initialized for %zu streams: batch mel %zu, embedding %zu, wake word %zu",
+             maxStreams, melSession ? melStage.batchLimit : 0, embStage.batchLimit,
+             wwHeads.front().stage.batchLimit);
+        return true;
+    } catch (const std::exception& e) {
+        LOGE("Error initializing MultiStreamDetector: %s", e.what());
+        return false;
+    }
+}
+
+bool MultiStreamDetector::initializeVAD(const std::string& vadModelPath) {
+    if (!isInitialized || isRunning) {
+        LOGE("Cannot initialize VAD: detector not initialized or running");
+        return false;
+    }
+
+    try {
+        // The first iterator loads the session, the rest share it
+        vadSession.reset();
+        for (size_t i = 0; i < streams.size(); i++) {
+            Stream& stream = *streams[i];
+            stream.vad = vadSession ? std::make_unique<VadIterator>(vadSession)
+                                    : std::make_unique<VadIterator>(vadModelPath);
+            vadSession = stream.vad->shared_session();
+            if (i == 0) {
+                stream.vad->warmup();
+            }
+            stream.vad->set_run_options(&runOptions);
+            stream.vadRing.allocate(vadRingCapacity);
+            stream.vadScratch.resize(chunkSamples);
+
+            const int id = stream.id;
+            stream.vad->set_callback([this, id](bool active) {
+                if (vadCallback) {
+                    vadCallback(id, active);
+                }
+            });
+        }
+        vadInitialized = true;
+        LOGI("VAD initialized for %zu streams", streams.size());
+        return true;
+    } catch (const std::exception& e) {
+        LOGE("Error initializing VAD: %s", e.what());
+        return false;
+    }
+}
+
+bool MultiStreamDetector::setNativeMelFrontEnd(bool enable) {
+    if (isRunning) {
+        LOGE("Cannot change the mel front end while the detector is running");
+        return false;
+    }
+    useNativeMels = enable;
+    return true;
+}
+
+void MultiStreamDetector::setVoiceActivityCallback(VoiceActivityCallback callback) {
+    vadCallback = std::move(callback);
+}
+
+// Only called with no worker touching the stream
+void MultiStreamDetector::resetStream(Stream& stream) {
+    stream.sampleRing.clear();
+    stream.vadRing.clear();
+    stream.melWindow.clear();
+    stream.featureWindow.clear();
+    if (stream.melFrontEnd) {
+        stream.melFrontEnd->reset();
+    }
+    if (stream.vad) {
+        stream.vad->reset();
+    }
+    std::fill(stream.activation.begin(), stream.activation.end(), 0);
+}
+
+int MultiStreamDetector::addStream() {
+    std::unique_lock<std::shared_mutex> lock(streamsMutex);
+    for (size_t i = 0; i < streams.size(); i++) {
+        Stream& stream = *streams[i];
+        if (!stream.active.load()) {
+            resetStream(stream);
+            stream.active = true;
+            LOGI("Added stream %zu", i);
+            return static_cast<int>(i);
+        }
+    }
+    LOGW("All %zu streams are in use", streams.size());
+    return -1;
+}
+
+bool MultiStreamDetector::removeStream(int id) {
+    std::unique_lock<std::shared_mutex> lock(streamsMutex);
+    Stream* stream = activeStream(id);
+    if (!stream) {
+        return false;
+    }
+    stream->active = false;
+    LOGI("Removed stream %d", id);
+    return true;
+}
+
+MultiStreamDetector::Stream* MultiStreamDetector::activeStream(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= streams.size()) {
+        return nullptr;
+    }
+    Stream* stream = streams[static_cast<size_t>(id)].get();
+    return stream->active.load() ? stream : nullptr;
+}
+
+size_t MultiStreamDetector::activeStreams() const {
+    size_t count = 0;
+    for (const auto& stream : streams) {
+        if (stream->active.load()) count++;
+    }
+    return count;
+}
+
+std::vector<std::string> MultiStreamDetector::wakeWordNames() const {
+    std::vector<std::string> names;
+    for (const auto& head : wwHeads) {
+        names.push_back(head.name);
+    }
+    return names;
+}
+
+bool MultiStreamDetector::start(WakeWordCallback callback) {
+    if (!isInitialized) {
+        LOGE("Cannot start detector: not initialized");
+        return false;
+    }
+    if (isRunning) {
+        return true;
+    }
+
+    wakeWordCallback = std::move(callback);
+    for (auto& stream : streams) {
+        resetStream(*stream);
+    }
+    runOptions.UnsetTerminate();
+    isRunning = true;
+    melThread = std::thread(&MultiStreamDetector::melWorker, this);
+    embThread = std::thread(&MultiStreamDetector::embeddingWorker, this);
+    wwThread = std::thread(&MultiStreamDetector::wakeWordWorker, this);
+    if (vadInitialized) {
+        vadThread = std::thread(&MultiStreamDetector::vadWorker, this);
+    }
+    LOGI("MultiStreamDetector started with %zu active streams", activeStreams());
+    return true;
+}
+
+void MultiStreamDetector::stop() {
+    if (!isRunning.exchange(false)) {
+        return;
+    }
+    // Batches in flight are cancelled rather than waited for
+    runOptions.SetTerminate();
+    samplesSignal.notify();
+    melsSignal.notify();
+    featuresSignal.notify();
+    vadSignal.notify();
+    for (std::thread* thread : {&melThread, &embThread, &wwThread, &vadThread}) {
+        if (thread->joinable()) {
+            thread->join();
+        }
+    }
+    LOGI("MultiStreamDetector stopped");
+}
+
+void MultiStreamDetector::processAudio(int id, const int16_t* audioData, size_t numSamples) {
+    if (!isRunning || !audioData || numSamples == 0) {
+        return;
+    }
+    Stream* stream = activeStream(id);
+    if (!stream) {
+        return;
+    }
+
+    const int64_t ingestStart = monotonicNanos();
+    const bool feedVAD = vadInitialized && stream->vad;
+    size_t dropped = 0;
+    size_t vadDropped = 0;
+    for (size_t offset = 0; offset < numSamples; offset += chunkSamples) {
+        const size_t count = std::min(chunkSamples, numSamples - offset);
+        convertPcm16(audioData + offset, stream->scratch.data(),
+                     feedVAD ? stream->vadScratch.data() : nullptr, count);
+        dropped += count - stream->sampleRing.write(stream->scratch.data(), count);
+        if (feedVAD) {
+            vadDropped += count - stream->vadRing.write(stream->vadScratch.data(), count);
+        }
+    }
+    samplesSignal.notify();
+    if (feedVAD) {
+        vadSignal.notify();
+    }
+    pipelineStats.ingest.record(monotonicNanos() - ingestStart);
+
+    // Shared by every stream's thread; the counters are atomic adds
+    if (dropped > 0) {
+        pipelineStats.mel.droppedNanos += samplesToNanos(dropped);
+        LOGW("Stream %d sample ring full, dropped %zu samples", id, dropped);
+    }
+    if (vadDropped > 0) {
+        pipelineStats.vad.droppedNanos += samplesToNanos(vadDropped);
+        LOGW("Stream %d VAD ring full, dropped %zu samples", id, vadDropped);
+    }
+}
+
+bool MultiStreamDetector::isDrained() const {
+    const uint64_t transitions = stageTransitions.load();
+    if (busyStages.load() != 0) {
+        return false;
+    }
+    const size_t melBlock = melSession ? frameSize : chunkSamples;
+    for (const auto& stream : streams) {
+        if (!stream->active.load()) continue;
+        if (stream->sampleRing.size() >= melBlock ||
+            stream->melWindow.frames() >= embWindowSize ||
+            stream->featureWindow.frames() >= wwFeatures ||
+            (stream->vad && stream->vadRing.size() > 0)) {
+            return false;
+        }
+    }
+    return stageTransitions.load() == transitions;
+}
+
+// Mel blocks of every ready stream, batched through the mel model or computed
+// per stream by the native front end
+void MultiStreamDetector::melWorker() {
+    LOGI("Mel worker started");
+    const size_t blockSize = melSession ? frameSize : chunkSamples;
+    std::vector<float> block(blockSize);
+
+    try {
+        while (isRunning) {
+            const uint32_t seen = samplesSignal.epoch();
+            std::shared_lock<std::shared_mutex> lock(streamsMutex);
+            melStreams.clear();
+            for (auto& stream : streams) {
+                if (stream->active.load() && stream->sampleRing.size() >= blockSize) {
+                    melStreams.push_back(stream.get());
+                }
+            }
+            if (melStreams.empty()) {
+                lock.unlock();
+                if (isRunning) samplesSignal.wait(seen);
+                continue;
+            }
+
+            BusyScope busy(*this);
+            const int64_t startNanos = monotonicNanos();
+            TRACE_SECTION("MultiStreamDetector::mel");
+            if (!melSession) {
+                for (Stream* stream : melStreams) {
+                    stream->sampleRing.read(block.data(), blockSize);
+                    const size_t frames = stream->melFrontEnd->process(block.data(), blockSize);
+                    stream->melWindow.writeFrames(stream->melFrontEnd->frames(), frames);
+                }
+            } else {
+                const size_t batchLimit = melStage.batchLimit;
+                for (size_t first = 0; first < melStreams.size(); first += batchLimit) {
+                    const size_t count = std::min(batchLimit, melStreams.size() - first);
+                    for (size_t i = 0; i < count; i++) {
+                        melStreams[first + i]->sampleRing.read(melStage.window(i), blockSize);
+                    }
+                    melStage.run(runOptions, count);
+                    for (size_t i = 0; i < count; i++) {
+                        SlidingWindow& window = melStreams[first + i]->melWindow;
+                        const float* mels = melStage.result(i);
+                        for (size_t f = 0; f < melFramesPerBlock; f++) {
+                            float* frame = window.frameToWrite();
+                            if (!frame) break;
+                            for (size_t m = 0; m < numMels; m++) {
+                                frame[m] = (mels[f * numMels + m] / 10.0f) + 2.0f;
+                            }
+                            window.commitFrame();
+                        }
+                    }
+                }
+            }
+            pipelineStats.mel.compute.record(monotonicNanos() - startNanos);
+            melsSignal.notify();
+        }
+    } catch (const std::exception& e) {
+        if (isRunning) LOGE("Error in mel worker: %s", e.what());
+    }
+    pipelineStats.mel.cpuNanos = threadCpuNanos();
+    LOGI("Mel worker exiting");
+}
+
+// One embedding per ready stream per pass, stacked into batches
+void MultiStreamDetector::embeddingWorker() {
+    LOGI("Embedding worker started");
+    const size_t windowFloats = embWindowSize * numMels;
+
+    try {
+        while (isRunning) {
+            const uint32_t seen = melsSignal.epoch();
+            std::shared_lock<std::shared_mutex> lock(streamsMutex);
+            batchStreams.clear();
+            for (auto& stream : streams) {
+                if (stream->active.load() && stream->melWindow.frames() >= embWindowSize) {
+                    batchStreams.push_back(stream.get());
+                }
+            }
+            if (batchStreams.empty()) {
+                lock.unlock();
+                if (isRunning) melsSignal.wait(seen);
+                continue;
+            }
+
+            BusyScope busy(*this);
+            const size_t batchLimit = embStage.batchLimit;
+            for (size_t first = 0; first < batchStreams.size(); first += batchLimit) {
+                const size_t count = std::min(batchLimit, batchStreams.size() - first);
+                for (size_t i = 0; i < count; i++) {
+                    std::memcpy(embStage.window(i), batchStreams[first + i]->melWindow.window(),
+                                windowFloats * sizeof(float));
+                }
+
+                const int64_t startNanos = monotonicNanos();
+                {
+                    TRACE_SECTION("MultiStreamDetector::embedding");
+                    embStage.run(runOptions, count);
+                }
+                pipelineStats.embedding.compute.record(monotonicNanos() - startNanos);
+
+                for (size_t i = 0; i < count; i++) {
+                    Stream& stream = *batchStreams[first + i];
+                    if (stream.featureWindow.writeFrames(embStage.result(i), 1) == 0) {
+                        LOGW("Feature window full, dropping embedding");
+                    }
+                    stream.melWindow.advance(embStepSize);
+                }
+            }
+            featuresSignal.notify();
+        }
+    } catch (const std::exception& e) {
+        if (isRunning) LOGE("Error in embedding worker: %s", e.what());
+    }
+    pipelineStats.embedding.cpuNanos = threadCpuNanos();
+    LOGI("Embedding worker exiting");
+}
+
+// Every head over one feature window per ready stream per pass
+void MultiStreamDetector::wakeWordWorker() {
+    LOGI("Wake word worker started");
+    const size_t windowFloats = wwFeatures * embFeatures;
+
+    try {
+        while (isRunning) {
+            const uint32_t seen = featuresSignal.epoch();
+            std::shared_lock<std::shared_mutex> lock(streamsMutex);
+            wwStreams.clear();
+            for (auto& stream : streams) {
+                if (stream->active.load() && stream->featureWindow.frames() >= wwFeatures) {
+                    wwStreams.push_back(stream.get());
+                }
+            }
+            if (wwStreams.empty()) {
+                lock.unlock();
+                if (isRunning) featuresSignal.wait(seen);
+                continue;
+            }
+
+            BusyScope busy(*this);
+            const int64_t startNanos = monotonicNanos();
+            for (size_t h = 0; h < wwHeads.size(); h++) {
+                BatchedStage& stage = wwHeads[h].stage;
+                for (size_t first = 0; first < wwStreams.size(); first += stage.batchLimit) {
+                    const size_t count = std::min(stage.batchLimit, wwStreams.size() - first);
+                    for (size_t i = 0; i < count; i++) {
+                        std::memcpy(stage.window(i), wwStreams[first + i]->featureWindow.window(),
+                                    windowFloats * sizeof(float));
+                    }
+                    {
+                        TRACE_SECTION("MultiStreamDetector::wakeWord");
+                        stage.run(runOptions, count);
+                    }
+
+                    // Same activation and refractory rule as WakeupDetector::updateActivation()
+                    for (size_t i = 0; i < count; i++) {
+                        Stream& stream = *wwStreams[first + i];
+                        int& activation = stream.activation[h];
+                        const float* scores = stage.result(i);
+                        for (size_t k = 0; k < stage.outputFloats; k++) {
+                            if (scores[k] > threshold) {
+                                if (++activation >= triggerLevel) {
+                                    LOGI("Wake word detected on stream %d: %s (score: %.4f)",
+                                         stream.id, wwHeads[h].name.c_str(), scores[k]);
+                                    pipelineStats.detections++;
+                                    if (wakeWordCallback) {
+                                        wakeWordCallback(stream.id, h);
+                                    }
+                                    activation = -refractory;
+                                }
+                            } else if (activation > 0) {
+                                activation = std::max(0, activation - 1);
+                            } else {
+                                activation = std::min(0, activation + 1);
+                            }
+                        }
+                    }
+                }
+            }
+            pipelineStats.wakeWord.compute.record(monotonicNanos() - startNanos);
+
+            for (Stream* stream : wwStreams) {
+                stream->featureWindow.advance(1);
+            }
+        }
+    } catch (const std::exception& e) {
+        if (isRunning) LOGE("Error in wake word worker: %s", e.what());
+    }
+    pipelineStats.wakeWord.cpuNanos = threadCpuNanos();
+    LOGI("Wake word worker exiting");
+}
+
+// Silero keeps recurrent state per stream, so streams run one after another on
+// the shared session
+void MultiStreamDetector::vadWorker() {
+    LOGI("VAD worker started");
+    std::array<float, vadReadBlock> block;
+
+    try {
+        while (isRunning) {
+            const uint32_t seen = vadSignal.epoch();
+            bool worked = false;
+            {
+                std::shared_lock<std::shared_mutex> lock(streamsMutex);
+                for (auto& stream : streams) {
+                    if (!stream->active.load() || stream->vadRing.size() == 0) continue;
+                    BusyScope busy(*this);
+                    const int64_t startNanos = monotonicNanos();
+                    const size_t count = stream->vadRing.read(block.data(), block.size());
+                    stream->vad->feed(block.data(), count);
+                    pipelineStats.vad.compute.record(monotonicNanos() - startNanos);
+                    worked = true;
+                }
+            }
+            if (!worked && isRunning) {
+                vadSignal.wait(seen);
+            }
+        }
+    } catch (const std::exception& e) {
+        if (isRunning) LOGE("Error in VAD worker: %s", e.what());
+    }
+    pipelineStats.vad.cpuNanos = threadCpuNanos();
+    LOGI("VAD worker exiting");
+}
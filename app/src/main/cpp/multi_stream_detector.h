@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+#include "event_signal.h"
+#include "mel_frontend.h"
+#include "pipeline_geometry.h"
+#include "pipeline_stats.h"
+#include "session_factory.h"
+#include "sliding_window.h"
+#include "spsc_ring_buffer.h"
+#include "wakeup_detector.h"
+
+// Wake word detection for many concurrent audio streams (microphone beams, or
+// client streams on a gateway) over one set of sessions. A stream only owns its
+// sample rings, mel and feature windows, VAD state and activation counters, so
+// an extra stream costs a few hundred KB and a share of each batch rather than
+// a full detector.
+//
+// One worker per stage serves every stream. Each pass gathers the streams that
+// have a window ready and runs them through the model as one batch (models
+// with a fixed batch dimension of 1 get one Run per stream instead), so
+// streams fed in lockstep, like the beams of one array, are scored together.
+//
+// Streams may be added and removed at any time. processAudio() may be called
+// from one thread per stream, but never for a stream while it is being removed.
+class MultiStreamDetector {
+public:
+    // `wakeWord` indexes wakeWordNames(); both run on pipeline threads
+    using WakeWordCallback = std::function<void(int stream, size_t wakeWord)>;
+    using VoiceActivityCallback = std::function<void(int stream, bool active)>;
+
+    MultiStreamDetector() = default;
+    ~MultiStreamDetector();
+
+    MultiStreamDetector(const MultiStreamDetector&) = delete;
+    MultiStreamDetector& operator=(const MultiStreamDetector&) = delete;
+
+    // Load the shared sessions and preallocate `maxStreams` stream slots; same
+    // model, provider and precision rules as WakeupDetector::initialize()
+    bool initialize(const std::string& melModelPath, const std::string& embModelPath,
+                    const std::vector<std::string>& wakeWordModelPaths, size_t maxStreams,
+                    const StageProviders& providers = StageProviders(),
+                    const StagePrecisions& precisions = StagePrecisions());
+
+    // One Silero session for all streams, each with its own recurrent state;
+    // call after initialize() and while stopped
+    bool initializeVAD(const std::string& vadModelPath);
+
+    // Native mel front end for the next initialize(); fails while running
+    bool setNativeMelFrontEnd(bool enable);
+
+    // Voice activity start/end per stream; set before start()
+    void setVoiceActivityCallback(VoiceActivityCallback callback);
+
+    // Claim a free slot with fresh state; returns its id, or -1 if all are in use
+    int addStream();
+
+    // Release a slot; its buffered audio is dropped
+    bool removeStream(int stream);
+
+    bool start(WakeWordCallback callback);
+    void stop();
+
+    // Queue audio for one stream; the buffer is read once and never retained
+    void processAudio(int stream, const int16_t* audioData, size_t numSamples);
+
+    std::vector<std::string> wakeWordNames() const;
+    size_t maxStreams() const { return streams.size(); }
+    size_t activeStreams() const;
+
+    // Stage statistics over all streams; each compute sample is one batch
+    const PipelineStats& stats() const { return pipelineStats; }
+    void resetStats() { pipelineStats.reset(); }
+
+    // True when every stream's audio so far has been scored
+    bool isDrained() const;
+
+private:
+    // Same geometry as WakeupDetector; batched heads share one window, so only
+    // standard-window wake word models are accepted
+    using Geometry = StandardGeometry;
+    static constexpr size_t chunkSamples = Geometry::chunkSamples;
+    static constexpr size_t frameSize = Geometry::frameSize;
+    static constexpr size_t numMels = Geometry::numMels;
+    static constexpr size_t embWindowSize = Geometry::embWindowSize;
+    static constexpr size_t embStepSize = Geometry::embStepSize;
+    static constexpr size_t embFeatures = Geometry::embFeatures;
+    static constexpr size_t wwFeatures = Geometry::wwFeatures;
+
+    // Per-stream capacities, smaller than a single detector's since a stream that
+    // falls this far behind is dropping audio anyway
+    static constexpr size_t sampleRingCapacity = 16000 * 2;  // ~2 s of audio
+    static constexpr size_t melWindowCapacity = 128;         // mel frames, ~1.3 s
+    static constexpr size_t featureWindowCapacity = 32;      // embeddings, ~2.5 s
+    static constexpr size_t vadRingCapacity = 16000;         // ~1 s of audio
+    static constexpr size_t vadReadBlock = 2048;
+    static constexpr float threshold = 0.5f;
+    static constexpr int triggerLevel = 1;
+    static constexpr int refractory = 20;
+
+    static int64_t samplesToNanos(size_t samples) {
+        return static_cast<int64_t>(samples) * 1000000000 / static_cast<int64_t>(Geometry::sampleRate);
+    }
+
+    struct Stream {
+        int id = 0;
+        std::atomic<bool> active{false};
+        SpscRingBuffer<float> sampleRing;
+        SpscRingBuffer<float> vadRing;
+        std::vector<float> scratch;     // processAudio conversion, raw scale
+        std::vector<float> vadScratch;  // processAudio conversion, [-1, 1)
+        SlidingWindow melWindow;
+        SlidingWindow featureWindow;
+        std::unique_ptr<MelFrontEnd> melFrontEnd;
+        std::unique_ptr<VadIterator> vad;
+        std::vector<int> activation;    // per wake word head
+    };
+
+    // A model run over up to `batchLimit` stacked windows, with inputs and
+    // outputs preallocated for every batch size so a pass never allocates
+    struct BatchedStage {
+        Ort::Session* session = nullptr;
+        std::string inputName;
+        std::string outputName;
+        size_t inputFloats = 0;   // per window
+        size_t outputFloats = 0;  // per window
+        size_t batchLimit = 1;
+        std::vector<float> input;
+        std::vector<float> output;
+        std::vector<Ort::Value> inputViews;   // [b - 1]: batch of b windows
+        std::vector<Ort::Value> outputViews;
+
+        void prepare(Ort::Session& model, const std::vector<int64_t>& windowShape,
+                     size_t maxBatch);
+        float* window(size_t index) { return &input[index * inputFloats]; }
+        const float* result(size_t index) const { return &output[index * outputFloats]; }
+        void run(const Ort::RunOptions& options, size_t windows);
+    };
+
+    struct WakeWordHead {
+        std::string name;
+        std::unique_ptr<Ort::Session> session;
+        BatchedStage stage;
+    };
+
+    void melWorker();
+    void embeddingWorker();
+    void wakeWordWorker();
+    void vadWorker();
+    void resetStream(Stream& stream);
+    Stream* activeStream(int id) const;
+
+    // Marks a worker as busy for isDrained()
+    struct BusyScope {
+        explicit BusyScope(const MultiStreamDetector& d) : detector(d) {
+            detector.busyStages.fetch_add(1);
+            detector.stageTransitions.fetch_add(1);
+        }
+        ~BusyScope() {
+            detector.stageTransitions.fetch_add(1);
+            detector.busyStages.fetch_sub(1);
+        }
+        const MultiStreamDetector& detector;
+    };
+
+    bool useNativeMels = false;
+    std::atomic<bool> isInitialized{false};
+    std::atomic<bool> isRunning{false};
+    std::atomic<bool> vadInitialized{false};
+
+    std::unique_ptr<Ort::Session> melSession;
+    std::unique_ptr<Ort::Session> embSession;
+    std::shared_ptr<Ort::Session> vadSession;
+    BatchedStage melStage;
+    BatchedStage embStage;
+    std::vector<WakeWordHead> wwHeads;
+    size_t melFramesPerBlock = 0;
+
+    // Workers hold the lock shared for one pass; addStream/removeStream take it
+    // exclusively, so a slot never changes under a batch that includes it
+    mutable std::shared_mutex streamsMutex;
+    std::vector<std::unique_ptr<Stream>> streams;
+    std::vector<Stream*> batchStreams;  // embedding worker's gather list
+    std::vector<Stream*> wwStreams;     // wake word worker's gather list
+    std::vector<Stream*> melStreams;    // mel worker's gather list
+
+    WakeWordCallback wakeWordCallback;
+    VoiceActivityCallback vadCallback;
+
+    // Shared by every Run(); stop() sets its terminate flag
+    Ort::RunOptions runOptions;
+
+    std::thread melThread, embThread, wwThread, vadThread;
+    EventSignal samplesSignal, melsSignal, featuresSignal, vadSignal;
+    PipelineStats pipelineStats;
+    mutable std::atomic<int> busyStages{0};
+    mutable std::atomic<uint64_t> stageTransitions{0};
+};
@@ -0,0 +1,199 @@
+#include "multi_stream_detector.h"
+#include "jni_callback_dispatcher.h"
+#include "platform_log.h"
+#include <jni.h>
+#include <algorithm>
+#include <string>
+
+// JNI bindings for MultiStreamWakeupDetectorJNI; the pipeline lives in multi_stream_detector.cpp
+
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "MultiStreamDetectorJNI", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "MultiStreamDetectorJNI", __VA_ARGS__)
+
+namespace {
+
+// Native side of one MultiStreamWakeupDetectorJNI; the detector is declared
+// last so it is destroyed (and stopped) before the dispatcher
+struct MultiStreamHandle {
+    JniCallbackDispatcher dispatcher;
+    MultiStreamDetector detector;
+};
+
+MultiStreamHandle* handleFromPtr(jlong detectorPtr) {
+    return reinterpret_cast<MultiStreamHandle*>(detectorPtr);
+}
+
+std::string toString(JNIEnv* env, jstring value) {
+    if (!value) return std::string();
+    const char* chars = env->GetStringUTFChars(value, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(value, chars);
+    return result;
+}
+
+} // namespace
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_createMultiStreamDetector(
+        JNIEnv* env, jobject thiz) {
+    LOGI("Creating MultiStreamDetector");
+    JavaVM* vm = nullptr;
+    env->GetJavaVM(&vm);
+    auto* handle = new MultiStreamHandle();
+    if (!handle->dispatcher.initialize(vm, env, true)) {
+        delete handle;
+        return 0;
+    }
+    handle->dispatcher.start();
+    JniCallbackDispatcher* dispatcher = &handle->dispatcher;
+    handle->detector.setVoiceActivityCallback([dispatcher](int stream, bool active) {
+        dispatcher->postVoiceActivity(active, stream);
+    });
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_initializeDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring melModelPath, jstring embModelPath,
+        jobjectArray wwModelPaths, jint maxStreams, jintArray providers, jintArray precisions) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle || maxStreams <= 0) return JNI_FALSE;
+
+    std::vector<std::string> wwModelPathsVec;
+    const jsize wwModelCount = env->GetArrayLength(wwModelPaths);
+    for (jsize i = 0; i < wwModelCount; i++) {
+        auto pathStr = static_cast<jstring>(env->GetObjectArrayElement(wwModelPaths, i));
+        wwModelPathsVec.push_back(toString(env, pathStr));
+        env->DeleteLocalRef(pathStr);
+    }
+
+    // Same layouts as WakeupDetectorJNI: {mel, embedding, wake word, vad} and {mel, embedding, wake word}
+    StageProviders stageProviders;
+    if (providers) {
+        jint values[4] = {0, 0, 0, 0};
+        const jsize count = std::min<jsize>(env->GetArrayLength(providers), 4);
+        env->GetIntArrayRegion(providers, 0, count, values);
+        stageProviders.mel = executionProviderFromInt(values[0]);
+        stageProviders.embedding = executionProviderFromInt(values[1]);
+        stageProviders.wakeWord = executionProviderFromInt(values[2]);
+        stageProviders.vad = executionProviderFromInt(values[3]);
+    }
+    StagePrecisions stagePrecisions;
+    if (precisions) {
+        jint values[3] = {0, 0, 0};
+        const jsize count = std::min<jsize>(env->GetArrayLength(precisions), 3);
+        env->GetIntArrayRegion(precisions, 0, count, values);
+        stagePrecisions.mel = modelPrecisionFromInt(values[0]);
+        stagePrecisions.embedding = modelPrecisionFromInt(values[1]);
+        stagePrecisions.wakeWord = modelPrecisionFromInt(values[2]);
+    }
+
+    return handle->detector.initialize(toString(env, melModelPath), toString(env, embModelPath),
+                                       wwModelPathsVec, static_cast<size_t>(maxStreams),
+                                       stageProviders, stagePrecisions) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_initializeVAD(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring vadModelPath) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return JNI_FALSE;
+    return handle->detector.initializeVAD(toString(env, vadModelPath)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_setNativeMelFrontEnd(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return JNI_FALSE;
+    return handle->detector.setNativeMelFrontEnd(enabled == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_addStream(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    return handle ? handle->detector.addStream() : -1;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_removeStream(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jint stream) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return JNI_FALSE;
+    return handle->detector.removeStream(stream) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_startDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return JNI_FALSE;
+
+    // Per-stream coalescing state and one cached jstring per wake word
+    JniCallbackDispatcher* dispatcher = &handle->dispatcher;
+    dispatcher->setTarget(env, thiz, handle->detector.wakeWordNames(),
+                          handle->detector.maxStreams());
+    return handle->detector.start([dispatcher](int stream, size_t wakeWord) {
+        dispatcher->postWakeWord(static_cast<int>(wakeWord), stream);
+    }) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_stopDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (handle) {
+        handle->detector.stop();
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_processAudio(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jint stream, jshortArray audioData,
+        jint numSamples) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle || numSamples <= 0) return;
+
+    jshort* audioBuffer = env->GetShortArrayElements(audioData, nullptr);
+    if (!audioBuffer) return;
+    const jsize length = env->GetArrayLength(audioData);
+    handle->detector.processAudio(stream, reinterpret_cast<int16_t*>(audioBuffer),
+                                  static_cast<size_t>(std::min<jint>(numSamples, length)));
+    env->ReleaseShortArrayElements(audioData, audioBuffer, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_processAudioDirect(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jint stream, jobject audioBuffer,
+        jint numSamples) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle || numSamples <= 0) return;
+
+    auto* samples = static_cast<const int16_t*>(env->GetDirectBufferAddress(audioBuffer));
+    if (!samples) {
+        LOGE("processAudioDirect requires a direct ByteBuffer");
+        return;
+    }
+    const jlong capacitySamples = env->GetDirectBufferCapacity(audioBuffer) / 2;
+    handle->detector.processAudio(stream, samples,
+                                  static_cast<size_t>(std::min<jlong>(numSamples, capacitySamples)));
+}
+
+JNIEXPORT jstring JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_getPipelineStats(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return nullptr;
+    return env->NewStringUTF(handle->detector.stats().toJson().c_str());
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_resetPipelineStats(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (handle) {
+        handle->detector.resetStats();
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_MultiStreamWakeupDetectorJNI_destroyMultiStreamDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    MultiStreamHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return;
+    handle->detector.stop();
+    handle->dispatcher.release(env);
+    delete handle;
+}
+
+} // extern "C"
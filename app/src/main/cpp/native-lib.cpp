@@ -15,4 +15,4 @@ Java_com_vinhpx_voiceassistant_MainActivity_stringFromJNI(
     return env->NewStringUTF(hello.c_str());
 }
 
-// The WakeupDetectorJNI functions are implemented in wakeup_detector.cpp
\ No newline at end of file
+// The WakeupDetectorJNI functions are implemented in wakeup_detector_jni.cpp
\ No newline at end of file
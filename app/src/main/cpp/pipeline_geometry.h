@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time geometry of the openWakeWord pipeline: 16 kHz audio, 32-band
+// mels every 10 ms, one 96-float embedding per 80 ms over 76 mel frames, and
+// wake word heads over the newest `WakeWordFrames` embeddings. Every buffer
+// size, stride and tensor shape of the streaming and offline paths comes from
+// here, so loops over them have constant trip counts and shapes never go
+// through a vector at inference time. Models are checked against the shapes
+// once at load.
+template <size_t WakeWordFrames>
+struct PipelineGeometry {
+    static constexpr size_t sampleRate = 16000;
+    static constexpr size_t chunkSamples = 1280;            // 80 ms
+    static constexpr size_t frameSize = 4 * chunkSamples;   // mel model block, 320 ms
+    static constexpr size_t melHopSamples = 160;            // one mel frame per 10 ms
+    static constexpr size_t numMels = 32;
+    static constexpr size_t embWindowSize = 76;             // mel frames per embedding, 775 ms
+    static constexpr size_t embStepSize = 8;                // mel frames between embeddings
+    static constexpr size_t embFeatures = 96;
+    static constexpr size_t wwFeatures = WakeWordFrames;    // embeddings per wake word window
+    static constexpr size_t vadWindowSamples = 512;         // Silero VAD window at 16 kHz, 32 ms
+
+    static constexpr size_t embInputFloats = embWindowSize * numMels;
+    static constexpr size_t wwInputFloats = wwFeatures * embFeatures;
+
+    static constexpr std::array<int64_t, 2> melInputShape{1, static_cast<int64_t>(frameSize)};
+    static constexpr std::array<int64_t, 4> embInputShape{
+        1, static_cast<int64_t>(embWindowSize), static_cast<int64_t>(numMels), 1};
+    static constexpr std::array<int64_t, 3> wwInputShape{
+        1, static_cast<int64_t>(wwFeatures), static_cast<int64_t>(embFeatures)};
+
+    static_assert(embStepSize * melHopSamples == chunkSamples, "one embedding per audio chunk");
+    static_assert(frameSize % chunkSamples == 0, "mel blocks are whole chunks");
+    static_assert(WakeWordFrames > 0, "a wake word window needs at least one embedding");
+};
+
+// The stock openWakeWord heads, and the alternative 24-embedding (1.92 s) heads
+using StandardGeometry = PipelineGeometry<16>;
+using WideHeadGeometry = PipelineGeometry<24>;
+
+// Number of elements in a tensor of a compile-time shape
+template <size_t Rank>
+constexpr size_t shapeElementCount(const std::array<int64_t, Rank>& shape) {
+    size_t count = 1;
+    for (int64_t dim : shape) {
+        count *= static_cast<size_t>(dim);
+    }
+    return count;
+}
+
+static_assert(shapeElementCount(StandardGeometry::wwInputShape) == StandardGeometry::wwInputFloats,
+              "wake word shape and buffer size disagree");
+static_assert(StandardGeometry::wwInputShape.size() == WideHeadGeometry::wwInputShape.size(),
+              "every head geometry binds a rank-3 input");
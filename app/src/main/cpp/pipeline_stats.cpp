@@ -0,0 +1,59 @@
+#include "pipeline_stats.h"
+#include <cinttypes>
+#include <cstdio>
+
+namespace {
+
+void appendHistogram(std::string& json, const char* name, const LatencyHistogram& histogram) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\"%s\":{\"count\":%" PRIu64 ",\"mean\":%.1f,\"p50\":%" PRIu64
+                  ",\"p90\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+                  name, histogram.count(), histogram.mean(), histogram.percentile(50),
+                  histogram.percentile(90), histogram.percentile(99), histogram.max());
+    json += buffer;
+}
+
+void appendStage(std::string& json, const char* name, const StageStats& stage) {
+    json += '"';
+    json += name;
+    json += "\":{";
+    appendHistogram(json, "wait", stage.wait);
+    json += ',';
+    appendHistogram(json, "compute", stage.compute);
+    json += ',';
+    appendHistogram(json, "lag", stage.lag);
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), ",\"cpuMs\":%.1f,\"lagMs\":%.1f,\"droppedMs\":%.1f}",
+                  stage.cpuNanos.load() / 1e6, stage.lagNanos.load() / 1e6,
+                  stage.droppedNanos.load() / 1e6);
+    json += buffer;
+}
+
+} // namespace
+
+std::string PipelineStats::toJson() const {
+    std::string json = "{";
+    appendHistogram(json, "ingest", ingest);
+    json += ',';
+    appendStage(json, "mel", mel);
+    json += ',';
+    appendStage(json, "embedding", embedding);
+    json += ',';
+    appendStage(json, "wakeWord", wakeWord);
+    json += ',';
+    appendStage(json, "vad", vad);
+    json += ',';
+    appendHistogram(json, "endToEnd", endToEnd);
+    json += ',';
+    appendHistogram(json, "detection", detection);
+    json += ",\"detections\":" + std::to_string(detections.load());
+    json += ",\"wakeWordRuns\":" + std::to_string(wakeWordRuns.load());
+    json += ",\"wakeWordSkips\":" + std::to_string(wakeWordSkips.load());
+    json += ",\"embeddingsInterpolated\":" + std::to_string(embeddingsInterpolated.load());
+    json += ",\"overloadSkips\":" + std::to_string(overloadSkips.load());
+    char gated[48];
+    std::snprintf(gated, sizeof(gated), ",\"gatedMs\":%.1f}", gatedNanos.load() / 1e6);
+    json += gated;
+    return json;
+}
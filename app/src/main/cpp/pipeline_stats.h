@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+// Monotonic clock used for every pipeline timestamp
+inline int64_t monotonicNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// CPU time consumed so far by the calling thread
+inline int64_t threadCpuNanos() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// Fixed-size latency histogram in microseconds with log-spaced buckets: exact
+// below 8 us, then 8 buckets per power of two (worst-case error 12.5%).
+// record() is lock-free and safe from several writers at once (every stream
+// thread records multi-stream ingest); any thread may read, percentiles are
+// approximate while a writer is active.
+class LatencyHistogram {
+public:
+    void record(int64_t nanos) {
+        const uint64_t micros = nanos > 0 ? static_cast<uint64_t>(nanos) / 1000 : 0;
+        buckets[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+        samples.fetch_add(1, std::memory_order_relaxed);
+        totalMicros.fetch_add(micros, std::memory_order_relaxed);
+        uint64_t seenMax = maxMicros.load(std::memory_order_relaxed);
+        while (micros > seenMax &&
+               !maxMicros.compare_exchange_weak(seenMax, micros, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return samples.load(std::memory_order_relaxed); }
+    uint64_t max() const { return maxMicros.load(std::memory_order_relaxed); }
+
+    double mean() const {
+        const uint64_t n = count();
+        return n ? static_cast<double>(totalMicros.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Upper bound in microseconds of the bucket holding the p-th percentile (0..100)
+    uint64_t percentile(double p) const {
+        const uint64_t n = count();
+        if (n == 0) return 0;
+        const uint64_t rank = static_cast<uint64_t>(p / 100.0 * (n - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < numBuckets; i++) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                const uint64_t bound = bucketUpperBound(i);
+                return bound < max() ? bound : max();
+            }
+        }
+        return max();
+    }
+
+    void reset() {
+        for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+        samples.store(0, std::memory_order_relaxed);
+        totalMicros.store(0, std::memory_order_relaxed);
+        maxMicros.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t subBuckets = 8;
+    static constexpr size_t octaves = 40;  // up to ~2^42 us, far beyond any stage
+    static constexpr size_t numBuckets = subBuckets * octaves;
+
+    static size_t bucketFor(uint64_t micros) {
+        if (micros < subBuckets) return static_cast<size_t>(micros);
+        const size_t msb = 63 - static_cast<size_t>(__builtin_clzll(micros));
+        const size_t sub = static_cast<size_t>(micros >> (msb - 3)) & (subBuckets - 1);
+        const size_t index = (msb - 2) * subBuckets + sub;
+        return index < numBuckets ? index : numBuckets - 1;
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < subBuckets) return index;
+        const size_t msb = index / subBuckets + 2;
+        const uint64_t sub = index % subBuckets;
+        return ((subBuckets + sub + 1) << (msb - 3)) - 1;
+    }
+
+    std::array<std::atomic<uint32_t>, numBuckets> buckets{};
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> totalMicros{0};
+    std::atomic<uint64_t> maxMicros{0};
+};
+
+// Queue wait (input ready -> inference start), compute time and worker CPU
+// time for one pipeline stage, plus its lag: the audio still queued in front
+// of it beyond the next inference, sampled before every inference
+struct StageStats {
+    LatencyHistogram wait;
+    LatencyHistogram compute;
+    LatencyHistogram lag;
+    std::atomic<int64_t> cpuNanos{0};      // stored when the worker exits
+    std::atomic<int64_t> lagNanos{0};      // latest lag sample
+    std::atomic<int64_t> droppedNanos{0};  // input lost to the overload policy or a full queue
+
+    void reset() {
+        wait.reset();
+        compute.reset();
+        lag.reset();
+        cpuNanos = 0;
+        lagNanos = 0;
+        droppedNanos = 0;
+    }
+};
+
+// Always-on pipeline measurements. Every frame carries the arrival time of the
+// newest sample it depends on, so endToEnd covers processAudio -> wake word
+// scores for every window and detection covers processAudio -> wakeWordCallback.
+// Each histogram has one writer thread; any thread may read.
+struct PipelineStats {
+    LatencyHistogram ingest;  // processAudio call
+    StageStats mel;           // ONNX Run or native front end per block
+    StageStats embedding;     // embedding Run per window
+    StageStats wakeWord;      // all wake word heads per window
+    StageStats vad;           // one VAD feed (up to vadReadBlock samples)
+    LatencyHistogram endToEnd;
+    LatencyHistogram detection;
+    std::atomic<uint64_t> detections{0};
+    std::atomic<uint64_t> wakeWordRuns{0};   // full wake word model inferences
+    std::atomic<uint64_t> wakeWordSkips{0};  // inferences the cascade first stage avoided
+    std::atomic<uint64_t> embeddingsInterpolated{0};  // steps the adaptive stride skipped
+    std::atomic<uint64_t> overloadSkips{0};  // low-priority inferences OverloadPolicy::Degrade shed
+    std::atomic<int64_t> gatedNanos{0};      // audio the VAD gate kept from the wake word models
+
+    void reset() {
+        ingest.reset();
+        mel.reset();
+        embedding.reset();
+        wakeWord.reset();
+        vad.reset();
+        endToEnd.reset();
+        detection.reset();
+        detections = 0;
+        wakeWordRuns = 0;
+        wakeWordSkips = 0;
+        embeddingsInterpolated = 0;
+        overloadSkips = 0;
+        gatedNanos = 0;
+    }
+
+    // Snapshot as a JSON object; histogram values are in microseconds, lag and
+    // dropped totals in milliseconds
+    std::string toJson() const;
+};
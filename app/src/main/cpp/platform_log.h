@@ -0,0 +1,67 @@
+#pragma once
+
+// Logging shim so the pipeline builds both for Android (logcat) and for host
+// tools (stderr). Each source file keeps its own LOGx macros with its tag:
+//     #define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "Tag", __VA_ARGS__)
+//
+// Messages below PLATFORM_LOG_MIN_LEVEL are compiled out, arguments and all.
+// It defaults to info in NDEBUG (release) builds, so per-frame debug logging
+// never formats a string there; pass -DPLATFORM_LOG_MIN_LEVEL=3 to keep it.
+
+#ifdef __ANDROID__
+#include <android/log.h>
+
+#define PLATFORM_LOG_DEBUG ANDROID_LOG_DEBUG
+#define PLATFORM_LOG_INFO ANDROID_LOG_INFO
+#define PLATFORM_LOG_WARN ANDROID_LOG_WARN
+#define PLATFORM_LOG_ERROR ANDROID_LOG_ERROR
+
+#define PLATFORM_LOG_PRINT(priority, tag, ...) __android_log_print(priority, tag, __VA_ARGS__)
+#else
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+#define PLATFORM_LOG_DEBUG 3
+#define PLATFORM_LOG_INFO 4
+#define PLATFORM_LOG_WARN 5
+#define PLATFORM_LOG_ERROR 6
+
+// Messages below this priority are dropped; host tools raise it to keep
+// per-frame logging out of measurements
+inline std::atomic<int>& platformLogMinPriority() {
+    static std::atomic<int> priority{PLATFORM_LOG_INFO};
+    return priority;
+}
+
+__attribute__((format(printf, 3, 4)))
+inline void platformLogPrint(int priority, const char* tag, const char* format, ...) {
+    if (priority < platformLogMinPriority().load(std::memory_order_relaxed)) {
+        return;
+    }
+    static const char levels[] = "??VDIWEF";
+    const char level = priority >= 0 && priority < 8 ? levels[priority] : '?';
+
+    char message[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    std::fprintf(stderr, "%c/%s: %s\n", level, tag, message);
+}
+
+#define PLATFORM_LOG_PRINT(priority, tag, ...) platformLogPrint(priority, tag, __VA_ARGS__)
+#endif
+
+#ifndef PLATFORM_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define PLATFORM_LOG_MIN_LEVEL PLATFORM_LOG_INFO
+#else
+#define PLATFORM_LOG_MIN_LEVEL PLATFORM_LOG_DEBUG
+#endif
+#endif
+
+#define PLATFORM_LOG(priority, tag, ...) \
+    do { \
+        if ((priority) >= PLATFORM_LOG_MIN_LEVEL) PLATFORM_LOG_PRINT(priority, tag, __VA_ARGS__); \
+    } while (0)
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include "audio_convert.h"
+#include "simd_float4.h"
+
+// Streaming rational resampler from a device's native capture rate (44.1 kHz,
+// 48 kHz, ...) to the pipeline rate. One Kaiser-windowed sinc low-pass at
+// `interpolation` times the input rate is split into `interpolation` polyphase
+// branches of `tapsPerPhase` taps, so every output sample is a single
+// tapsPerPhase-long dot product over the newest input, whatever the ratio.
+// The group delay is fixed at tapsPerPhase / 2 input samples (1 ms at
+// 48 kHz, 1.09 ms at 44.1 kHz). Single-threaded: owned by the thread calling processAudio().
+class PolyphaseResampler {
+public:
+    static constexpr size_t tapsPerPhase = 96;
+    static constexpr size_t maxPhases = 320;      // 120 KB of coefficients at most
+    static constexpr size_t blockSamples = 1024;  // input converted per pass
+
+    // Set up `inputRate` -> `outputRate`; equal rates make the resampler a
+    // pass-through (active() false). Returns false for a ratio it cannot do.
+    bool configure(size_t inputRate, size_t outputRate) {
+        if (inputRate == 0 || outputRate == 0) return false;
+        const size_t divisor = std::gcd(inputRate, outputRate);
+        const size_t phases = outputRate / divisor;
+        if (phases > maxPhases) return false;
+
+        interpolation = phases;
+        decimation = inputRate / divisor;
+        sourceRate = inputRate;
+        coefficients.clear();
+        if (active()) {
+            design(std::min(inputRate, outputRate));
+            buffer.assign(tapsPerPhase - 1 + blockSamples, 0.0f);
+        } else {
+            buffer.clear();
+        }
+        reset();
+        return true;
+    }
+
+    // Forget buffered input, as for a new stream
+    void reset() {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        position = 0;
+        phase = 0;
+    }
+
+    bool active() const { return interpolation != decimation; }
+    size_t inputRate() const { return sourceRate; }
+    size_t memoryBytes() const { return (coefficients.size() + buffer.size()) * sizeof(float); }
+
+    // Largest number of samples process() can return for `count` input samples
+    size_t maxOutput(size_t count) const {
+        return (count * interpolation + decimation - 1) / decimation;
+    }
+
+    // Resample `count` samples into `out`, which holds at least maxOutput(count);
+    // returns the number of output samples written
+    size_t process(const int16_t* in, size_t count, int16_t* out) {
+        constexpr size_t history = tapsPerPhase - 1;
+        size_t produced = 0;
+        while (count > 0) {
+            const size_t n = std::min(count, blockSamples);
+            convertPcm16(in, buffer.data() + history, nullptr, n);
+            // `position` indexes the newest input sample of the next output
+            // within this block; its window is buffer[position, position + taps)
+            for (; position < n; produced++) {
+                const float* taps = coefficients.data() + phase * tapsPerPhase;
+                out[produced] = toPcm16(dot(taps, buffer.data() + position));
+                phase += decimation;
+                position += phase / interpolation;
+                phase %= interpolation;
+            }
+            position -= n;
+            std::memmove(buffer.data(), buffer.data() + n, history * sizeof(float));
+            in += n;
+            count -= n;
+        }
+        return produced;
+    }
+
+private:
+    // Half-gain point as a fraction of the lower rate: 7.68 kHz for 16 kHz
+    // output, leaving 7 kHz within 0.6 dB and nothing above 9 kHz to alias
+    static constexpr double cutoffFraction = 0.48;
+    static constexpr double kaiserBeta = 8.0;  // ~80 dB stopband
+
+    void design(size_t bandRate) {
+        const size_t length = tapsPerPhase * interpolation;
+        const double upRate = static_cast<double>(sourceRate) * interpolation;
+        const double cutoff = cutoffFraction * bandRate / upRate;  // cycles per sample
+        const double center = (length - 1) / 2.0;
+        const double windowNorm = besselI0(kaiserBeta);
+        const double pi = 3.14159265358979323846;
+
+        // Branch p holds taps p, p + L, p + 2L, ... of the prototype, reversed
+        // so the dot product runs forward over the input window
+        coefficients.assign(length, 0.0f);
+        std::vector<double> branch(tapsPerPhase);
+        for (size_t p = 0; p < interpolation; p++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < tapsPerPhase; k++) {
+                const double x = static_cast<double>(p + k * interpolation) - center;
+                const double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * x) / (pi * x);
+                const double r = x / center;
+                const double window = besselI0(kaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / windowNorm;
+                branch[k] = sinc * window;
+                sum += branch[k];
+            }
+            // Unity DC gain per branch, so no phase adds a ripple at the output rate
+            for (size_t k = 0; k < tapsPerPhase; k++) {
+                coefficients[p * tapsPerPhase + tapsPerPhase - 1 - k] = static_cast<float>(branch[k] / sum);
+            }
+        }
+    }
+
+    static double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 64 && term > 1e-12 * sum; k++) {
+            const double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+        return sum;
+    }
+
+    static float dot(const float* taps, const float* window) {
+#ifdef SIMD_FLOAT4
+        simd::f32x4 acc0 = simd::set1(0.0f);
+        simd::f32x4 acc1 = simd::set1(0.0f);
+        for (size_t j = 0; j < tapsPerPhase; j += 8) {
+            acc0 = simd::mulAdd(simd::load(taps + j), simd::load(window + j), acc0);
+            acc1 = simd::mulAdd(simd::load(taps + j + 4), simd::load(window + j + 4), acc1);
+        }
+        return simd::horizontalSum(simd::add(acc0, acc1));
+#else
+        float sum = 0.0f;
+        for (size_t j = 0; j < tapsPerPhase; j++) {
+            sum += taps[j] * window[j];
+        }
+        return sum;
+#endif
+    }
+
+    static int16_t toPcm16(float sample) {
+        const long rounded = std::lrint(sample);
+        return static_cast<int16_t>(std::clamp<long>(rounded, INT16_MIN, INT16_MAX));
+    }
+
+    static_assert(tapsPerPhase % 8 == 0, "dot() runs two 4-lane accumulators");
+
+    size_t interpolation = 1;
+    size_t decimation = 1;
+    size_t sourceRate = 0;
+    std::vector<float> coefficients;  // interpolation branches of tapsPerPhase taps
+    std::vector<float> buffer;        // tapsPerPhase - 1 samples of history, then one block
+    size_t position = 0;
+    size_t phase = 0;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "simd_float4.h"
+
+// Power spectrum of a real N-point signal via an N/2-point complex FFT.
+// The signal is packed as z[n] = x[2n] + i*x[2n+1], transformed with an iterative
+// radix-2 FFT in split (separate real/imaginary) layout so butterflies vectorize
+// four at a time, then untangled into the N/2 + 1 non-negative frequency bins.
+// All tables are sized at compile time; nothing allocates after construction.
+template <size_t N>
+class RealFft {
+    static_assert(N >= 16 && (N & (N - 1)) == 0, "RealFft size must be a power of two >= 16");
+    static constexpr size_t half = N / 2;
+
+public:
+    static constexpr size_t bins = N / 2 + 1;
+
+    RealFft() {
+        const double pi = 3.14159265358979323846;
+
+        size_t bits = 0;
+        while ((size_t{1} << bits) < half) bits++;
+        for (size_t i = 0; i < half; i++) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; b++) {
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            }
+            bitReverse[i] = static_cast<uint16_t>(r);
+        }
+
+        // Twiddles for the stage with span h live at [h - 1, 2h - 1)
+        for (size_t h = 1; h < half; h *= 2) {
+            for (size_t j = 0; j < h; j++) {
+                stageCos[h - 1 + j] = static_cast<float>(std::cos(pi * j / h));
+                stageSin[h - 1 + j] = static_cast<float>(-std::sin(pi * j / h));
+            }
+        }
+
+        for (size_t k = 0; k <= half; k++) {
+            splitCos[k] = static_cast<float>(std::cos(2.0 * pi * k / N));
+            splitSin[k] = static_cast<float>(-std::sin(2.0 * pi * k / N));
+        }
+    }
+
+    // power[k] = |X[k]|^2 for k = 0..N/2
+    void powerSpectrum(const float* input, float* power) {
+        for (size_t n = 0; n < half; n++) {
+            re[bitReverse[n]] = input[2 * n];
+            im[bitReverse[n]] = input[2 * n + 1];
+        }
+
+        transform();
+
+        // DC and Nyquist come from z[0] alone
+        const float dc = re[0] + im[0];
+        const float nyquist = re[0] - im[0];
+        power[0] = dc * dc;
+        power[half] = nyquist * nyquist;
+
+        size_t k = 1;
+#ifdef SIMD_FLOAT4
+        const simd::f32x4 vhalf = simd::set1(0.5f);
+        for (; k + 4 <= half; k += 4) {
+            // z[k..k+3] and the mirrored z[half-k .. half-k-3]
+            const simd::f32x4 ar = simd::load(&re[k]);
+            const simd::f32x4 ai = simd::load(&im[k]);
+            const simd::f32x4 br = simd::reverse(simd::load(&re[half - k - 3]));
+            const simd::f32x4 bi = simd::reverse(simd::load(&im[half - k - 3]));
+
+            const simd::f32x4 er = simd::mul(simd::add(ar, br), vhalf);
+            const simd::f32x4 ei = simd::mul(simd::sub(ai, bi), vhalf);
+            const simd::f32x4 orr = simd::mul(simd::add(ai, bi), vhalf);
+            const simd::f32x4 oi = simd::mul(simd::sub(br, ar), vhalf);
+
+            const simd::f32x4 c = simd::load(&splitCos[k]);
+            const simd::f32x4 s = simd::load(&splitSin[k]);
+            const simd::f32x4 xr = simd::add(er, simd::sub(simd::mul(c, orr), simd::mul(s, oi)));
+            const simd::f32x4 xi = simd::add(ei, simd::add(simd::mul(c, oi), simd::mul(s, orr)));
+            simd::store(&power[k], simd::mulAdd(xr, xr, simd::mul(xi, xi)));
+        }
+#endif
+        for (; k < half; k++) {
+            const float ar = re[k], ai = im[k];
+            const float br = re[half - k], bi = im[half - k];
+
+            const float er = 0.5f * (ar + br);
+            const float ei = 0.5f * (ai - bi);
+            const float orr = 0.5f * (ai + bi);
+            const float oi = 0.5f * (br - ar);
+
+            const float c = splitCos[k], s = splitSin[k];
+            const float xr = er + c * orr - s * oi;
+            const float xi = ei + c * oi + s * orr;
+            power[k] = xr * xr + xi * xi;
+        }
+    }
+
+private:
+    // In-place decimation-in-time FFT over re/im, input already bit-reversed
+    void transform() {
+        for (size_t h = 1; h < half; h *= 2) {
+            const float* wc = &stageCos[h - 1];
+            const float* ws = &stageSin[h - 1];
+            for (size_t g = 0; g < half; g += 2 * h) {
+                float* ar = &re[g];
+                float* ai = &im[g];
+                float* br = &re[g + h];
+                float* bi = &im[g + h];
+                size_t j = 0;
+#ifdef SIMD_FLOAT4
+                for (; j + 4 <= h; j += 4) {
+                    const simd::f32x4 c = simd::load(wc + j);
+                    const simd::f32x4 s = simd::load(ws + j);
+                    const simd::f32x4 xr = simd::load(br + j);
+                    const simd::f32x4 xi = simd::load(bi + j);
+                    const simd::f32x4 tr = simd::sub(simd::mul(c, xr), simd::mul(s, xi));
+                    const simd::f32x4 ti = simd::add(simd::mul(c, xi), simd::mul(s, xr));
+                    const simd::f32x4 ur = simd::load(ar + j);
+                    const simd::f32x4 ui = simd::load(ai + j);
+                    simd::store(br + j, simd::sub(ur, tr));
+                    simd::store(bi + j, simd::sub(ui, ti));
+                    simd::store(ar + j, simd::add(ur, tr));
+                    simd::store(ai + j, simd::add(ui, ti));
+                }
+#endif
+                for (; j < h; j++) {
+                    const float tr = wc[j] * br[j] - ws[j] * bi[j];
+                    const float ti = wc[j] * bi[j] + ws[j] * br[j];
+                    br[j] = ar[j] - tr;
+                    bi[j] = ai[j] - ti;
+                    ar[j] += tr;
+                    ai[j] += ti;
+                }
+            }
+        }
+    }
+
+    std::array<uint16_t, half> bitReverse{};
+    std::array<float, half> stageCos{};
+    std::array<float, half> stageSin{};
+    std::array<float, half + 1> splitCos{};
+    std::array<float, half + 1> splitSin{};
+    std::array<float, half> re{};
+    std::array<float, half> im{};
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// One wake word output of one frame, laid out for Java: a direct ByteBuffer in
+// native order reads it as long, float, short, short (see ScoreTelemetryReader)
+struct ScoreRecord {
+    int64_t originNanos;  // arrival of the newest sample scored, System.nanoTime() clock
+    float score;
+    uint16_t wakeWord;    // index into wakeWordNames()
+    int16_t activation;   // after this score
+};
+static_assert(sizeof(ScoreRecord) == 16, "ScoreRecord is shared with Java as 16 bytes");
+
+// Fixed-capacity history of wake word scores for telemetry. The wake word
+// thread appends each frame's records with one memcpy and two stores; readers
+// poll by absolute record position at their own rate, from native code or
+// through a direct ByteBuffer: record p lives at index p & (capacity - 1).
+//
+// The producer never waits. As in CaptureRing it announces the range it is
+// about to overwrite in `reserved` before copying and publishes it in `written`
+// after, so a reader validates a copy by checking overwriteLimit() afterwards.
+class ScoreRing {
+public:
+    ScoreRing() = default;
+    ScoreRing(const ScoreRing&) = delete;
+    ScoreRing& operator=(const ScoreRing&) = delete;
+
+    // Allocate storage; must not be called while the producer or a reader is active
+    void allocate(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        buffer.assign(capacity, ScoreRecord{});
+        mask = capacity - 1;
+        reservedRecords.store(0, std::memory_order_relaxed);
+        writtenRecords.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return buffer.size(); }
+    const ScoreRecord* data() const { return buffer.data(); }
+
+    // Records appended so far; [written() - capacity(), written()) is readable
+    uint64_t written() const { return writtenRecords.load(std::memory_order_acquire); }
+
+    // Oldest position still intact, including against a write in progress
+    uint64_t overwriteLimit() const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = reservedRecords.load(std::memory_order_relaxed);
+        return reserved > capacity() ? reserved - capacity() : 0;
+    }
+
+    // Producer: append `count` records, overwriting the oldest
+    void write(const ScoreRecord* records, size_t count) {
+        if (buffer.empty() || count == 0) return;
+        const uint64_t end = writtenRecords.load(std::memory_order_relaxed) + count;
+        if (count > capacity()) {
+            records += count - capacity();
+            count = capacity();
+        }
+        const uint64_t start = end - count;
+        reservedRecords.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t offset = start & mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(&buffer[offset], records, first * sizeof(ScoreRecord));
+        std::memcpy(&buffer[0], records + first, (count - first) * sizeof(ScoreRecord));
+        writtenRecords.store(end, std::memory_order_release);
+    }
+
+    // Reader: copy the records in [position, position + count) that have been
+    // written; returns how many were copied, or 0 if any of them were overwritten
+    size_t read(uint64_t position, ScoreRecord* dst, size_t count) const {
+        const uint64_t end = std::min<uint64_t>(written(), position + count);
+        if (end <= position || position < overwriteLimit()) return 0;
+        count = static_cast<size_t>(end - position);
+        const size_t offset = position & mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(dst, &buffer[offset], first * sizeof(ScoreRecord));
+        std::memcpy(dst + first, &buffer[0], (count - first) * sizeof(ScoreRecord));
+        return position >= overwriteLimit() ? count : 0;
+    }
+
+private:
+    std::vector<ScoreRecord> buffer;
+    size_t mask = 0;
+    std::atomic<uint64_t> reservedRecords{0};
+    std::atomic<uint64_t> writtenRecords{0};
+};
@@ -0,0 +1,359 @@
+#include "session_factory.h"
+#include "mapped_model.h"
+#include "platform_log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+
+#ifdef __ANDROID__
+#include <nnapi_provider_factory.h>
+#endif
+
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "SessionFactory", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "SessionFactory", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "SessionFactory", __VA_ARGS__)
+
+const char* executionProviderName(ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::Cpu: return "CPU";
+        case ExecutionProvider::Nnapi: return "NNAPI";
+        case ExecutionProvider::Xnnpack: return "XNNPACK";
+    }
+    return "unknown";
+}
+
+ExecutionProvider executionProviderFromInt(int value) {
+    switch (value) {
+        case static_cast<int>(ExecutionProvider::Nnapi): return ExecutionProvider::Nnapi;
+        case static_cast<int>(ExecutionProvider::Xnnpack): return ExecutionProvider::Xnnpack;
+        default: return ExecutionProvider::Cpu;
+    }
+}
+
+const char* modelPrecisionName(ModelPrecision precision) {
+    switch (precision) {
+        case ModelPrecision::Fp32: return "FP32";
+        case ModelPrecision::Fp16: return "FP16";
+        case ModelPrecision::Int8Dynamic: return "INT8 dynamic";
+        case ModelPrecision::Int8Static: return "INT8 static";
+    }
+    return "unknown";
+}
+
+ModelPrecision modelPrecisionFromInt(int value) {
+    switch (value) {
+        case static_cast<int>(ModelPrecision::Fp16): return ModelPrecision::Fp16;
+        case static_cast<int>(ModelPrecision::Int8Dynamic): return ModelPrecision::Int8Dynamic;
+        case static_cast<int>(ModelPrecision::Int8Static): return ModelPrecision::Int8Static;
+        default: return ModelPrecision::Fp32;
+    }
+}
+
+std::string modelVariantPath(const std::string& fp32Path, ModelPrecision precision,
+                             ModelPrecision* resolved) {
+    if (resolved) *resolved = ModelPrecision::Fp32;
+
+    const char* suffix = nullptr;
+    switch (precision) {
+        case ModelPrecision::Fp32: return fp32Path;
+        case ModelPrecision::Fp16: suffix = ".fp16"; break;
+        case ModelPrecision::Int8Dynamic: suffix = ".int8"; break;
+        case ModelPrecision::Int8Static: suffix = ".int8_static"; break;
+    }
+
+    std::filesystem::path variant(fp32Path);
+    const std::string extension = variant.extension().string();
+    variant.replace_extension();
+    variant += suffix;
+    variant += extension;
+
+    if (!modelExists(variant.string())) {
+        LOGW("No %s variant of %s (%s), using FP32", modelPrecisionName(precision),
+             fp32Path.c_str(), variant.c_str());
+        return fp32Path;
+    }
+    if (resolved) *resolved = precision;
+    return variant.string();
+}
+
+std::string cascadeModelPath(const std::string& wakeWordPath) {
+    std::filesystem::path firstStage(wakeWordPath);
+    const std::string extension = firstStage.extension().string();
+    firstStage.replace_extension();
+    firstStage += ".stage1";
+    firstStage += extension;
+    return modelExists(firstStage.string()) ? firstStage.string() : std::string();
+}
+
+namespace {
+
+std::atomic<bool> lowMemory{false};
+
+} // namespace
+
+void setLowMemorySessions(bool enable) {
+    lowMemory = enable;
+    LOGI("Low-memory sessions %s", enable ? "on" : "off");
+}
+
+bool lowMemorySessions() {
+    return lowMemory;
+}
+
+void enableArenaShrinkage(Ort::RunOptions& runOptions) {
+    runOptions.AddConfigEntry("memory.enable_memory_arena_shrinkage", "cpu:0");
+}
+
+Ort::Env& sharedOrtEnv() {
+    // Never destroyed: sessions owned by static objects may outlive any destructor order
+    static Ort::Env* env = [] {
+        Ort::ThreadingOptions threadingOptions;
+        threadingOptions.SetGlobalIntraOpNumThreads(1);
+        threadingOptions.SetGlobalInterOpNumThreads(1);
+        threadingOptions.SetGlobalSpinControl(0);
+        auto* created = new Ort::Env(threadingOptions, ORT_LOGGING_LEVEL_WARNING, "VoiceAssistant");
+        created->DisableTelemetryEvents();
+        
+        // One CPU arena for every session instead of one per session; in low-memory
+        // mode it extends by the requested size (kSameAsRequested)
+        Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        Ort::ArenaCfg arenaConfig(0, lowMemory ? 1 : -1, -1, -1);
+        created->CreateAndRegisterAllocator(memoryInfo, arenaConfig);
+        LOGI("Created shared ORT environment with global thread pools");
+        return created;
+    }();
+    return *env;
+}
+
+// Weights prepacked by CPU kernels, shared by every session of the same model
+// (e.g. several detectors loading one embedding model)
+static OrtPrepackedWeightsContainer* sharedPrepackedWeights() {
+    static OrtPrepackedWeightsContainer* container = [] {
+        OrtPrepackedWeightsContainer* created = nullptr;
+        Ort::ThrowOnError(Ort::GetApi().CreatePrepackedWeightsContainer(&created));
+        return created;
+    }();
+    return container;
+}
+
+// Options shared by every stage regardless of provider
+static Ort::SessionOptions baseSessionOptions(const MappedModel& model) {
+    Ort::SessionOptions sessionOptions;
+    sessionOptions.DisablePerSessionThreads();
+    sessionOptions.AddConfigEntry("session.use_env_allocators", "1");
+    if (lowMemory) {
+        sessionOptions.DisableMemPattern();
+        sessionOptions.AddConfigEntry("session.use_device_allocator_for_initializers", "1");
+    }
+    if (isOrtFormatModel(model)) {
+        // The mapping outlives the session, so ORT can run from the mapped bytes
+        sessionOptions.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        sessionOptions.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+    }
+    sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    return sessionOptions;
+}
+
+// Register a non-CPU provider; throws Ort::Exception if it is unavailable
+static void appendProvider(Ort::SessionOptions& sessionOptions, ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::Cpu:
+            break;
+        case ExecutionProvider::Nnapi:
+#ifdef __ANDROID__
+            // Keep NNAPI off its reference CPU path; unsupported nodes run on ORT's kernels
+            Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_Nnapi(
+                sessionOptions, NNAPI_FLAG_CPU_DISABLED));
+#else
+            throw Ort::Exception("NNAPI is only available on Android", ORT_NOT_IMPLEMENTED);
+#endif
+            break;
+        case ExecutionProvider::Xnnpack:
+            // XNNPACK runs its own pool next to ORT's global ones
+            sessionOptions.AppendExecutionProvider("XNNPACK", {{"intra_op_num_threads", "1"}});
+            break;
+    }
+}
+
+namespace {
+
+std::mutex cacheDirectoryMutex;
+std::string cacheDirectory;
+
+std::string optimizedCacheDirectory() {
+    std::lock_guard<std::mutex> lock(cacheDirectoryMutex);
+    return cacheDirectory;
+}
+
+// model.onnx -> model.ort when a converted copy ships alongside
+std::string preferredModelSource(const std::string& modelPath) {
+    std::filesystem::path path(modelPath);
+    if (path.extension() != ".onnx") return modelPath;
+    path.replace_extension(".ort");
+    return modelExists(path.string()) ? path.string() : modelPath;
+}
+
+// <cache>/<stem>-<hash>-ort<version>.ort
+std::string optimizedModelPath(const std::string& directory, const std::string& source,
+                               const MappedModel& model) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  static_cast<unsigned long long>(modelContentHash(model)));
+    const std::string stem = std::filesystem::path(source).stem().string();
+    return (std::filesystem::path(directory) /
+            (stem + "-" + hash + "-ort" + Ort::GetVersionString() + ".ort")).string();
+}
+
+// CPU session, from the optimized-graph cache when possible
+std::unique_ptr<Ort::Session> createCpuSession(Ort::Env& env, const std::string& source,
+                                               const MappedModel& model) {
+    const std::string directory = optimizedCacheDirectory();
+    if (directory.empty() || isOrtFormatModel(model)) {
+        return std::make_unique<Ort::Session>(env, model.data, model.size,
+                                              baseSessionOptions(model), sharedPrepackedWeights());
+    }
+
+    const std::string cachedPath = optimizedModelPath(directory, source, model);
+    if (modelExists(cachedPath)) {
+        try {
+            const MappedModel& cached = mapModel(cachedPath);
+            auto session = std::make_unique<Ort::Session>(env, cached.data, cached.size,
+                                                          baseSessionOptions(cached),
+                                                          sharedPrepackedWeights());
+            LOGI("Loaded optimized graph of %s from cache", source.c_str());
+            return session;
+        } catch (const std::exception& e) {
+            LOGW("Discarding unusable cached graph %s (%s)", cachedPath.c_str(), e.what());
+            forgetModel(cachedPath);
+            std::remove(cachedPath.c_str());
+        }
+    }
+
+    // First load: optimize as usual and save the result, published atomically
+    const std::string tempPath = cachedPath + ".tmp";
+    Ort::SessionOptions sessionOptions = baseSessionOptions(model);
+    sessionOptions.SetOptimizedModelFilePath(tempPath.c_str());
+    sessionOptions.AddConfigEntry("session.save_model_format", "ORT");
+    auto session = std::make_unique<Ort::Session>(env, model.data, model.size, sessionOptions,
+                                                  sharedPrepackedWeights());
+    if (std::rename(tempPath.c_str(), cachedPath.c_str()) == 0) {
+        LOGI("Cached optimized graph of %s as %s", source.c_str(), cachedPath.c_str());
+    } else {
+        LOGW("Could not write optimized graph cache %s", cachedPath.c_str());
+        std::remove(tempPath.c_str());
+    }
+    return session;
+}
+
+} // namespace
+
+void setOptimizedModelCacheDirectory(const std::string& directory) {
+    std::error_code error;
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory, error);
+    }
+    std::lock_guard<std::mutex> lock(cacheDirectoryMutex);
+    cacheDirectory = directory;
+}
+
+// Provider sessions always start from the source graph: compiled NNAPI/XNNPACK
+// partitions cannot be serialized, and a CPU-optimized graph would hide nodes
+// from the provider. Only CPU sessions use the optimized-graph cache.
+std::unique_ptr<Ort::Session> createSession(const std::string& modelPath,
+                                            ExecutionProvider provider,
+                                            ExecutionProvider* selected) {
+    Ort::Env& env = sharedOrtEnv();
+    const std::string source = preferredModelSource(modelPath);
+    const MappedModel& model = mapModel(source);
+    
+    std::unique_ptr<Ort::Session> session;
+    if (provider != ExecutionProvider::Cpu) {
+        try {
+            Ort::SessionOptions sessionOptions = baseSessionOptions(model);
+            appendProvider(sessionOptions, provider);
+            session = std::make_unique<Ort::Session>(env, model.data, model.size, sessionOptions);
+            LOGI("Loaded %s on %s", source.c_str(), executionProviderName(provider));
+            if (selected) *selected = provider;
+        } catch (const Ort::Exception& e) {
+            LOGW("%s rejected %s (%s), falling back to CPU",
+                 executionProviderName(provider), source.c_str(), e.what());
+        }
+    }
+
+    if (!session) {
+        session = createCpuSession(env, source, model);
+        if (selected) *selected = ExecutionProvider::Cpu;
+    }
+    
+    // An ONNX protobuf has been parsed (or hashed) into ORT's own buffers; drop the mapped copy
+    if (!isOrtFormatModel(model)) {
+        releaseModelPages(model);
+    }
+    return session;
+}
+
+std::unique_ptr<Ort::Session> loadStageSession(const std::string& modelPath,
+                                               ExecutionProvider provider,
+                                               ModelPrecision precision) {
+    ModelPrecision resolved = ModelPrecision::Fp32;
+    const std::string variantPath = modelVariantPath(modelPath, precision, &resolved);
+    LOGI("Loading %s (%s)", variantPath.c_str(), modelPrecisionName(resolved));
+    return createSession(variantPath, provider);
+}
+
+bool validateSessionIo(Ort::Session& session, const char* stage,
+                       const std::vector<int64_t>& inputShape) {
+    const auto inputInfo = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo();
+    const auto outputInfo = session.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo();
+    if (inputInfo.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT ||
+        outputInfo.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        LOGE("%s model must have float32 input and output (convert FP16 models with keep_io_types)",
+             stage);
+        return false;
+    }
+    
+    if (!inputShapeMatches(session, inputShape)) {
+        LOGE("%s model input has rank %zu, incompatible with the pipeline's input shape",
+             stage, inputInfo.GetShape().size());
+        return false;
+    }
+    return true;
+}
+
+bool inputShapeMatches(Ort::Session& session, const std::vector<int64_t>& inputShape) {
+    const auto modelShape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    bool matches = modelShape.size() == inputShape.size();
+    for (size_t i = 0; matches && i < modelShape.size(); i++) {
+        matches = modelShape[i] <= 0 || modelShape[i] == inputShape[i];
+    }
+    return matches;
+}
+
+size_t shapeElementCount(const std::vector<int64_t>& shape) {
+    return static_cast<size_t>(std::accumulate(shape.begin(), shape.end(),
+                                               int64_t{1}, std::multiplies<>()));
+}
+
+std::vector<int64_t> warmUpSession(Ort::Session& session, const std::string& inputName,
+                                   const std::string& outputName,
+                                   const std::vector<int64_t>& inputShape) {
+    auto memoryInfo = Ort::MemoryInfo::CreateCpu(
+        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    
+    std::vector<float> zeros(shapeElementCount(inputShape), 0.0f);
+    auto input = Ort::Value::CreateTensor<float>(
+        memoryInfo, zeros.data(), zeros.size(), inputShape.data(), inputShape.size());
+    
+    const char* inputNames[] = {inputName.c_str()};
+    const char* outputNames[] = {outputName.c_str()};
+    auto outputs = session.Run(Ort::RunOptions{nullptr}, inputNames, &input, 1, outputNames, 1);
+    return outputs.front().GetTensorTypeAndShapeInfo().GetShape();
+}
+
+bool hasDynamicBatch(Ort::Session& session) {
+    const auto shape = session.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    return !shape.empty() && shape[0] <= 0;
+}
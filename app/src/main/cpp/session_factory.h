@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <onnxruntime_cxx_api.h>
+
+// Execution provider for one pipeline stage. Values match the
+// WakeupDetectorJNI.PROVIDER_* constants on the Java side.
+enum class ExecutionProvider : int {
+    Cpu = 0,
+    Nnapi = 1,
+    Xnnpack = 2,
+};
+
+// Per-stage execution provider selection
+struct StageProviders {
+    ExecutionProvider mel = ExecutionProvider::Cpu;
+    ExecutionProvider embedding = ExecutionProvider::Cpu;
+    ExecutionProvider wakeWord = ExecutionProvider::Cpu;
+    ExecutionProvider vad = ExecutionProvider::Cpu;
+};
+
+// Numeric precision of a stage's model variant. Values match the
+// WakeupDetectorJNI.PRECISION_* constants on the Java side.
+enum class ModelPrecision : int {
+    Fp32 = 0,
+    Fp16 = 1,        // FP16 weights, FP32 inputs/outputs (keep_io_types)
+    Int8Dynamic = 2, // dynamically quantized weights, FP32 activations
+    Int8Static = 3,  // statically quantized (QDQ) with calibrated activations
+};
+
+// Per-stage model precision selection
+struct StagePrecisions {
+    ModelPrecision mel = ModelPrecision::Fp32;
+    ModelPrecision embedding = ModelPrecision::Fp32;
+    ModelPrecision wakeWord = ModelPrecision::Fp32;
+};
+
+// Human-readable provider name for logs
+const char* executionProviderName(ExecutionProvider provider);
+
+// Convert a JNI/config integer to a provider, defaulting to CPU for unknown values
+ExecutionProvider executionProviderFromInt(int value);
+
+const char* modelPrecisionName(ModelPrecision precision);
+
+// Convert a JNI/config integer to a precision, defaulting to FP32 for unknown values
+ModelPrecision modelPrecisionFromInt(int value);
+
+// Path of the `precision` variant of an FP32 model, stored next to it with a
+// suffix before the extension: embedding_model.onnx -> embedding_model.fp16.onnx,
+// .int8.onnx or .int8_static.onnx. If the variant file does not exist the FP32
+// path is returned. `resolved` receives the precision actually selected.
+std::string modelVariantPath(const std::string& fp32Path, ModelPrecision precision,
+                             ModelPrecision* resolved = nullptr);
+
+// Path of the first-stage model of a wake word model for cascade mode, stored
+// next to it the same way: hey_jarvis.onnx -> hey_jarvis.stage1.onnx. Empty if
+// there is no such file.
+std::string cascadeModelPath(const std::string& wakeWordPath);
+
+// Process-wide ORT environment, created on first use with global thread pools
+// (one intra-op and one inter-op thread, spinning off). Sessions share these
+// pools instead of creating their own, so every Run executes on the calling
+// pipeline worker and its core affinity decides where inference happens.
+Ort::Env& sharedOrtEnv();
+
+// Low-memory sessions, process-wide: sessions created afterwards skip memory
+// pattern planning (no per-session peak buffers preallocated from the shapes)
+// and keep initializers out of the shared arena, and the shared arena, if it
+// is created afterwards, grows by exactly what a request needs instead of the
+// next power of two. Costs a few percent of inference time.
+void setLowMemorySessions(bool enable);
+bool lowMemorySessions();
+
+// Run options that return the shared CPU arena's free chunks to the system at
+// the end of the run
+void enableArenaShrinkage(Ort::RunOptions& runOptions);
+
+// Directory for optimized graphs of .onnx models; empty (the default) disables
+// the cache. The first CPU load of a model saves its fully optimized graph there
+// in ORT format, named by content hash and ORT version, and later loads map
+// that file instead of parsing and optimizing the ONNX graph again.
+void setOptimizedModelCacheDirectory(const std::string& directory);
+
+// Create a session in sharedOrtEnv() on the requested provider with the
+// pipeline's common options (global thread pools, shared arena, full graph
+// optimization). `modelPath` is a file path or an "asset:" reference; the model
+// is built from its memory mapping (see mapped_model.h), never read into a
+// second buffer. A pre-converted .ort file next to a .onnx model is preferred
+// over it. If
+// the provider is not available in this ORT build or rejects the graph, the
+// session is rebuilt on the default CPU provider. `selected` receives the
+// provider actually in use.
+std::unique_ptr<Ort::Session> createSession(const std::string& modelPath,
+                                            ExecutionProvider provider,
+                                            ExecutionProvider* selected = nullptr);
+
+// createSession() on the `precision` variant of a stage's FP32 model
+std::unique_ptr<Ort::Session> loadStageSession(const std::string& modelPath,
+                                               ExecutionProvider provider,
+                                               ModelPrecision precision);
+
+// Reduced-precision variants must keep FP32 inputs/outputs and the FP32 model's
+// input geometry, since every stage binds preallocated float buffers of that shape.
+// Dynamic (<= 0) dimensions are accepted; logs and returns false otherwise.
+bool validateSessionIo(Ort::Session& session, const char* stage,
+                       const std::vector<int64_t>& inputShape);
+
+// True if the first input accepts `inputShape`, dynamic dimensions matching anything
+bool inputShapeMatches(Ort::Session& session, const std::vector<int64_t>& inputShape);
+
+// Run one inference on silence to finish lazy initialization inside ORT.
+// Returns the output shape, which the stage then preallocates and binds.
+std::vector<int64_t> warmUpSession(Ort::Session& session, const std::string& inputName,
+                                   const std::string& outputName,
+                                   const std::vector<int64_t>& inputShape);
+
+// Number of elements in a tensor of the given shape
+size_t shapeElementCount(const std::vector<int64_t>& shape);
+
+// The same checks for the compile-time shapes of pipeline_geometry.h; load time only
+template <size_t Rank>
+bool validateSessionIo(Ort::Session& session, const char* stage,
+                       const std::array<int64_t, Rank>& inputShape) {
+    return validateSessionIo(session, stage, std::vector<int64_t>(inputShape.begin(), inputShape.end()));
+}
+
+template <size_t Rank>
+bool inputShapeMatches(Ort::Session& session, const std::array<int64_t, Rank>& inputShape) {
+    return inputShapeMatches(session, std::vector<int64_t>(inputShape.begin(), inputShape.end()));
+}
+
+template <size_t Rank>
+std::vector<int64_t> warmUpSession(Ort::Session& session, const std::string& inputName,
+                                   const std::string& outputName,
+                                   const std::array<int64_t, Rank>& inputShape) {
+    return warmUpSession(session, inputName, outputName,
+                         std::vector<int64_t>(inputShape.begin(), inputShape.end()));
+}
+
+// True if the first input's leading (batch) dimension is dynamic, so several
+// windows can be stacked into one Run(); fixed-batch models take one at a time
+bool hasDynamicBatch(Ort::Session& session);
@@ -0,0 +1,62 @@
+#pragma once
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SIMD_FLOAT4 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_FLOAT4 1
+#endif
+
+// Minimal 4-lane float wrapper over NEON and SSE2 so the DSP kernels are written
+// once. SIMD_FLOAT4 is left undefined on targets with neither; callers keep a
+// scalar loop for that case and for loop tails.
+#ifdef SIMD_FLOAT4
+namespace simd {
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+using f32x4 = float32x4_t;
+
+inline f32x4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, f32x4 v) { vst1q_f32(p, v); }
+inline f32x4 set1(float x) { return vdupq_n_f32(x); }
+inline f32x4 add(f32x4 a, f32x4 b) { return vaddq_f32(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return vsubq_f32(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return vmulq_f32(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return vmaxq_f32(a, b); }
+
+// Lanes in reverse order: {d, c, b, a} from {a, b, c, d}
+inline f32x4 reverse(f32x4 v) {
+    const float32x4_t r = vrev64q_f32(v);
+    return vcombine_f32(vget_high_f32(r), vget_low_f32(r));
+}
+
+inline float horizontalSum(f32x4 v) {
+    const float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+#else
+using f32x4 = __m128;
+
+inline f32x4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, f32x4 v) { _mm_storeu_ps(p, v); }
+inline f32x4 set1(float x) { return _mm_set1_ps(x); }
+inline f32x4 add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+
+// Lanes in reverse order: {d, c, b, a} from {a, b, c, d}
+inline f32x4 reverse(f32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+inline float horizontalSum(f32x4 v) {
+    const __m128 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+#endif
+
+// a * b + c
+inline f32x4 mulAdd(f32x4 a, f32x4 b, f32x4 c) { return add(mul(a, b), c); }
+
+} // namespace simd
+#endif
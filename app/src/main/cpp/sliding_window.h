@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Mirrored circular buffer of fixed-width float frames.
+// Every frame is stored twice, at slot `i` and at slot `i + capacity`, so any run
+// of up to `capacity` consecutive frames starting at the read head is contiguous
+// in memory. The consumer can hand window() straight to Ort::Value::CreateTensor
+// and slide the window with advance(), which only moves the head index.
+//
+// One producer thread and one consumer thread may use it concurrently.
+class SlidingWindow {
+public:
+    SlidingWindow() = default;
+    SlidingWindow(const SlidingWindow&) = delete;
+    SlidingWindow& operator=(const SlidingWindow&) = delete;
+
+    // Allocate storage; must not be called while either side is active
+    void allocate(size_t frameWidthFloats, size_t capacityFrames) {
+        width = frameWidthFloats;
+        capacity = capacityFrames;
+        storage.assign(2 * width * capacity, 0.0f);
+        clear();
+    }
+
+    // Drop all buffered frames; must not be called while either side is active
+    void clear() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t frameWidth() const { return width; }
+    size_t capacityFrames() const { return capacity; }
+    size_t storageBytes() const { return storage.size() * sizeof(float); }
+
+    // Start of the frames beginning at `slot` (0 <= slot < capacity). Any run of
+    // up to capacityFrames() frames from here is contiguous, so tensors over the
+    // window can be created once per slot instead of once per inference.
+    float* slotData(size_t slot) { return &storage[slot * width]; }
+
+    // Slot of the oldest buffered frame (consumer) and of the next frame to write (producer)
+    size_t headSlot() const { return head.load(std::memory_order_relaxed) % capacity; }
+    size_t tailSlot() const { return tail.load(std::memory_order_relaxed) % capacity; }
+
+    // Frames committed (producer) and consumed (consumer) since clear(); both
+    // only grow, so they name a frame position across advance() calls
+    size_t writtenFrames() const { return tail.load(std::memory_order_relaxed); }
+    size_t readFrames() const { return head.load(std::memory_order_relaxed); }
+
+    // Number of frames available to the consumer
+    size_t frames() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    // Number of frames the producer can still write
+    size_t freeFrames() const { return capacity - frames(); }
+
+    // Producer: slot for the next frame, or nullptr if the window is full.
+    // Fill exactly frameWidth() floats, then call commitFrame().
+    float* frameToWrite() {
+        const size_t writeIdx = tail.load(std::memory_order_relaxed);
+        if (writeIdx - head.load(std::memory_order_acquire) >= capacity) {
+            return nullptr;
+        }
+        return &storage[(writeIdx % capacity) * width];
+    }
+
+    // Producer: mirror the frame returned by frameToWrite() and publish it
+    void commitFrame() {
+        const size_t writeIdx = tail.load(std::memory_order_relaxed);
+        const size_t slot = writeIdx % capacity;
+        std::memcpy(&storage[(slot + capacity) * width], &storage[slot * width],
+                    width * sizeof(float));
+        tail.store(writeIdx + 1, std::memory_order_release);
+    }
+
+    // Producer: copy up to `count` whole frames in, returns the number written
+    size_t writeFrames(const float* data, size_t count) {
+        size_t written = 0;
+        for (; written < count; written++) {
+            float* frame = frameToWrite();
+            if (!frame) break;
+            std::memcpy(frame, data + written * width, width * sizeof(float));
+            commitFrame();
+        }
+        return written;
+    }
+
+    // Consumer: contiguous view of frames() frames starting at the oldest one
+    float* window() {
+        return &storage[(head.load(std::memory_order_relaxed) % capacity) * width];
+    }
+
+    // Consumer: slide the window forward by up to `count` frames
+    void advance(size_t count) {
+        const size_t readIdx = head.load(std::memory_order_relaxed);
+        count = std::min(count, tail.load(std::memory_order_acquire) - readIdx);
+        head.store(readIdx + count, std::memory_order_release);
+    }
+
+private:
+    std::vector<float> storage;
+    size_t width = 0;
+    size_t capacity = 0;
+
+    // Keep the indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Fixed-capacity single-producer/single-consumer ring buffer.
+// The producer only touches `tail`, the consumer only touches `head`, so no lock
+// is required. Capacity is rounded up to a power of two and allocated once.
+template <typename T>
+class SpscRingBuffer {
+public:
+    SpscRingBuffer() = default;
+    explicit SpscRingBuffer(size_t minCapacity) { allocate(minCapacity); }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Allocate storage; must not be called while either side is active
+    void allocate(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        buffer.assign(capacity, T{});
+        mask = capacity - 1;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    // Drop all buffered data; must not be called while either side is active
+    void clear() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return buffer.size(); }
+
+    // Number of elements available to the consumer
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    // Number of elements the producer can still write
+    size_t freeSpace() const { return capacity() - size(); }
+
+    // Producer: copy up to `count` elements in, returns the number written
+    size_t write(const T* data, size_t count) {
+        const size_t writeIdx = tail.load(std::memory_order_relaxed);
+        const size_t readIdx = head.load(std::memory_order_acquire);
+        count = std::min(count, capacity() - (writeIdx - readIdx));
+        if (count == 0) return 0;
+
+        const size_t offset = writeIdx & mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(&buffer[offset], data, first * sizeof(T));
+        std::memcpy(&buffer[0], data + first, (count - first) * sizeof(T));
+
+        tail.store(writeIdx + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: copy up to `count` elements out, returns the number read
+    size_t read(T* dest, size_t count) {
+        const size_t readIdx = head.load(std::memory_order_relaxed);
+        const size_t writeIdx = tail.load(std::memory_order_acquire);
+        count = std::min(count, writeIdx - readIdx);
+        if (count == 0) return 0;
+
+        const size_t offset = readIdx & mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(dest, &buffer[offset], first * sizeof(T));
+        std::memcpy(dest + first, &buffer[0], (count - first) * sizeof(T));
+
+        head.store(readIdx + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: drop up to `count` elements without copying them
+    size_t discard(size_t count) {
+        const size_t readIdx = head.load(std::memory_order_relaxed);
+        const size_t writeIdx = tail.load(std::memory_order_acquire);
+        count = std::min(count, writeIdx - readIdx);
+        head.store(readIdx + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t mask = 0;
+
+    // Keep the indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
@@ -0,0 +1,94 @@
+#include "thread_affinity.h"
+#include "platform_log.h"
+#include <algorithm>
+#include <cstdio>
+#include <sched.h>
+#include <unistd.h>
+
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "ThreadAffinity", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "ThreadAffinity", __VA_ARGS__)
+
+namespace {
+
+// Maximum frequency of a core in kHz, 0 if cpufreq does not report it
+long maxFrequencyKhz(int cpu) {
+    char path[96];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    FILE* file = std::fopen(path, "r");
+    if (!file) return 0;
+    long khz = 0;
+    if (std::fscanf(file, "%ld", &khz) != 1) khz = 0;
+    std::fclose(file);
+    return khz;
+}
+
+CpuTopology detectTopology() {
+    CpuTopology topology;
+    const long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+    std::vector<long> frequencies;
+    for (int cpu = 0; cpu < numCpus && cpu < CPU_SETSIZE; cpu++) {
+        frequencies.push_back(maxFrequencyKhz(cpu));
+    }
+
+    const long slowest = frequencies.empty() ? 0 :
+        *std::min_element(frequencies.begin(), frequencies.end());
+    for (int cpu = 0; cpu < static_cast<int>(frequencies.size()); cpu++) {
+        // Unknown frequencies count as both, so they are never excluded
+        const bool efficient = frequencies[cpu] == 0 || frequencies[cpu] == slowest;
+        const bool fast = frequencies[cpu] == 0 || frequencies[cpu] > slowest;
+        if (efficient) topology.efficiency.push_back(cpu);
+        if (fast) topology.performance.push_back(cpu);
+    }
+    if (topology.performance.empty()) {
+        topology.performance = topology.efficiency;  // symmetric
+    }
+
+    LOGI("CPU topology: %zu efficiency, %zu performance cores%s", topology.efficiency.size(),
+         topology.performance.size(), topology.asymmetric() ? "" : " (symmetric)");
+    return topology;
+}
+
+} // namespace
+
+const char* coreClassName(CoreClass coreClass) {
+    switch (coreClass) {
+        case CoreClass::Any: return "any";
+        case CoreClass::Efficiency: return "efficiency";
+        case CoreClass::Performance: return "performance";
+    }
+    return "unknown";
+}
+
+CoreClass coreClassFromInt(int value) {
+    switch (value) {
+        case static_cast<int>(CoreClass::Efficiency): return CoreClass::Efficiency;
+        case static_cast<int>(CoreClass::Performance): return CoreClass::Performance;
+        default: return CoreClass::Any;
+    }
+}
+
+const CpuTopology& CpuTopology::get() {
+    static const CpuTopology topology = detectTopology();
+    return topology;
+}
+
+bool pinCurrentThread(CoreClass coreClass) {
+    const CpuTopology& topology = CpuTopology::get();
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (coreClass == CoreClass::Any) {
+        for (int cpu : topology.efficiency) CPU_SET(cpu, &mask);
+        for (int cpu : topology.performance) CPU_SET(cpu, &mask);
+    } else {
+        const auto& cores = coreClass == CoreClass::Efficiency ? topology.efficiency : topology.performance;
+        for (int cpu : cores) CPU_SET(cpu, &mask);
+    }
+    if (CPU_COUNT(&mask) == 0) return false;
+
+    // pid 0 is the calling thread
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+        LOGW("Failed to pin thread to %s cores", coreClassName(coreClass));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+// Core class on asymmetric (big.LITTLE / DynamIQ) SoCs. Values match the
+// WakeupDetectorJNI.CORES_* constants on the Java side.
+enum class CoreClass : int {
+    Any = 0,          // every online core; the scheduler decides
+    Efficiency = 1,   // the cluster with the lowest maximum frequency
+    Performance = 2,  // every faster cluster (mid and prime cores)
+};
+
+const char* coreClassName(CoreClass coreClass);
+
+// Convert a JNI/config integer to a core class, defaulting to Any for unknown values
+CoreClass coreClassFromInt(int value);
+
+// CPU clusters read once from /sys/devices/system/cpu/cpu*/cpufreq. On
+// symmetric machines, or when cpufreq is not readable, both lists hold every
+// core, so pinning degrades to a no-op rather than restricting the thread.
+struct CpuTopology {
+    std::vector<int> efficiency;
+    std::vector<int> performance;
+
+    bool asymmetric() const { return efficiency != performance; }
+
+    static const CpuTopology& get();
+};
+
+// Restrict the calling thread to one core class; returns false if the kernel
+// rejects the mask (e.g. cores taken offline by the thermal governor)
+bool pinCurrentThread(CoreClass coreClass);
+
+// Per-thread pinning state, so re-applying an unchanged class costs no syscall
+class ThreadAffinity {
+public:
+    void apply(CoreClass coreClass) {
+        if (pinned && coreClass == current) return;
+        pinCurrentThread(coreClass);
+        current = coreClass;
+        pinned = true;
+    }
+
+private:
+    CoreClass current = CoreClass::Any;
+    bool pinned = false;
+};
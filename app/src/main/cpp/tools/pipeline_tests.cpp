@@ -0,0 +1,377 @@
+// Host unit tests for the pure pipeline pieces that need no models: the
+// Endpointer state machine, the PolyphaseResampler, RealFft and MelFrontEnd.
+// Run through ctest, or directly; exits non-zero and names every failed check.
+// MelFrontEnd's agreement with the mel model itself is measured by
+// wakeword_replay --compare-mels.
+//
+//   ctest --test-dir build-host --output-on-failure
+
+#include "endpointer.h"
+#include "mel_frontend.h"
+#include "polyphase_resampler.h"
+#include "real_fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                          \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                         #condition);                                             \
+            failures++;                                                           \
+        }                                                                         \
+    } while (0)
+
+constexpr size_t sampleRate = 16000;
+constexpr size_t windowSamples = 512;
+
+// Feeds one probability per VAD window and records every event
+struct EndpointRun {
+    Endpointer endpointer;
+    uint64_t windowEnd = 0;
+    std::vector<EndpointEvent> events;
+
+    explicit EndpointRun(const EndpointConfig& config) {
+        endpointer.configure(config, sampleRate);
+    }
+
+    void feed(float probability, int windows = 1) {
+        for (int i = 0; i < windows; i++) {
+            windowEnd += windowSamples;
+            EndpointEvent event;
+            if (endpointer.update(probability, windowEnd, windowSamples, event)) {
+                events.push_back(event);
+            }
+        }
+    }
+};
+
+// Windows after the last speech window until the end is decided
+uint64_t windowsToEnd(uint64_t hangoverSamples) {
+    return (hangoverSamples + windowSamples - 1) / windowSamples;
+}
+
+void testStartAndHangover() {
+    EndpointRun run{EndpointConfig()};
+    run.feed(0.0f, 3);
+    run.feed(0.9f, 10);
+    run.feed(0.0f, 40);
+
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    const uint64_t speechStart = 3 * windowSamples;
+    const uint64_t speechEnd = 13 * windowSamples;
+    CHECK(run.events[0].speech);
+    CHECK(run.events[0].sample == speechStart);
+    CHECK(run.events[0].decidedSample == speechStart + windowSamples);
+    CHECK(!run.events[1].speech);
+    CHECK(run.events[1].sample == speechEnd);
+    CHECK(run.events[1].decidedSample == speechEnd + windowsToEnd(8000) * windowSamples);
+    CHECK(!run.events[1].early);
+    CHECK(!run.endpointer.inSpeech());
+}
+
+void testHysteresisBand() {
+    // Windows just under the threshold neither extend speech nor end it
+    EndpointRun run{EndpointConfig()};
+    run.feed(0.9f, 5);
+    run.feed(0.4f, 20);
+    CHECK(run.events.size() == 1);
+    CHECK(run.endpointer.inSpeech());
+
+    // Past the hangover already, so the first silent window ends speech at the
+    // last window that reached the threshold
+    run.feed(0.0f);
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    CHECK(run.events[1].sample == 5 * windowSamples);
+    CHECK(run.events[1].decidedSample == 26 * windowSamples);
+    CHECK(!run.events[1].early);
+}
+
+EndpointConfig earlyConfig() {
+    EndpointConfig config;
+    config.earlyEndpoint = true;
+    config.earlyHangoverMs = 200;
+    return config;
+}
+
+void testEarlyEndpoint() {
+    EndpointRun run{earlyConfig()};
+    run.feed(0.9f, 10);
+    run.feed(0.02f, 40);
+
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    const uint64_t speechEnd = 10 * windowSamples;
+    CHECK(run.events[1].sample == speechEnd);
+    CHECK(run.events[1].decidedSample == speechEnd + windowsToEnd(3200) * windowSamples);
+    CHECK(run.events[1].early);
+}
+
+void testSlowFadeKeepsHangover() {
+    // Below the release threshold but above the floor: not a fast fall
+    EndpointRun run{earlyConfig()};
+    run.feed(0.9f, 10);
+    run.feed(0.3f, 40);
+
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    CHECK(run.events[1].decidedSample == 10 * windowSamples + windowsToEnd(8000) * windowSamples);
+    CHECK(!run.events[1].early);
+}
+
+void testFastFallThenRise() {
+    // A fast fall that comes back above the floor loses the early hangover
+    EndpointRun run{earlyConfig()};
+    run.feed(0.9f, 10);
+    run.feed(0.0f, 2);
+    run.feed(0.2f);
+    run.feed(0.0f, 40);
+
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    CHECK(run.events[1].decidedSample == 10 * windowSamples + windowsToEnd(8000) * windowSamples);
+    CHECK(!run.events[1].early);
+}
+
+void testBandBreaksFastFall() {
+    // Passing through the hysteresis band first is not a crisp end either
+    EndpointRun run{earlyConfig()};
+    run.feed(0.9f, 10);
+    run.feed(0.4f);
+    run.feed(0.0f, 40);
+
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    CHECK(!run.events[1].early);
+}
+
+void testEarlyOffUsesHangover() {
+    // Without early endpointing a crisp end still waits the full hangover
+    EndpointRun run{EndpointConfig()};
+    run.feed(0.9f, 10);
+    run.feed(0.0f, 40);
+
+    CHECK(run.events.size() == 2);
+    if (run.events.size() != 2) return;
+    CHECK(run.events[1].decidedSample == 10 * windowSamples + windowsToEnd(8000) * windowSamples);
+    CHECK(!run.events[1].early);
+}
+
+std::vector<int16_t> tone(double frequency, size_t rate, size_t count, double amplitude) {
+    std::vector<int16_t> samples(count);
+    const double step = 2.0 * 3.14159265358979323846 * frequency / rate;
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = static_cast<int16_t>(std::lrint(amplitude * std::sin(step * i)));
+    }
+    return samples;
+}
+
+// Resample `input` in `chunk`-sized calls, checking each against maxOutput()
+std::vector<int16_t> resample(PolyphaseResampler& resampler, const std::vector<int16_t>& input,
+                              size_t chunk) {
+    std::vector<int16_t> output;
+    std::vector<int16_t> block(resampler.maxOutput(chunk));
+    for (size_t offset = 0; offset < input.size(); offset += chunk) {
+        const size_t count = std::min(chunk, input.size() - offset);
+        const size_t produced = resampler.process(input.data() + offset, count, block.data());
+        CHECK(produced <= resampler.maxOutput(count));
+        output.insert(output.end(), block.begin(), block.begin() + produced);
+    }
+    return output;
+}
+
+double rms(const std::vector<int16_t>& samples, size_t skip) {
+    double sum = 0.0;
+    for (size_t i = skip; i < samples.size(); i++) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return std::sqrt(sum / (samples.size() - skip));
+}
+
+void testResamplerConfigure() {
+    PolyphaseResampler resampler;
+    CHECK(resampler.configure(sampleRate, sampleRate));
+    CHECK(!resampler.active());
+    CHECK(resampler.configure(48000, sampleRate));
+    CHECK(resampler.active());
+    CHECK(resampler.inputRate() == 48000);
+    CHECK(resampler.configure(44100, sampleRate));
+    CHECK(resampler.configure(8000, sampleRate));
+    CHECK(!resampler.configure(16001, sampleRate));  // 16000 phases
+    CHECK(!resampler.configure(0, sampleRate));
+}
+
+void testResamplerOutputCounts() {
+    for (size_t rate : {48000, 44100, 22050, 8000}) {
+        PolyphaseResampler reference;
+        CHECK(reference.configure(rate, sampleRate));
+        const std::vector<int16_t> input = tone(440.0, rate, rate, 8000.0);
+        const std::vector<int16_t> whole = resample(reference, input, input.size());
+        CHECK(whole.size() == sampleRate);
+
+        // Any split of the input gives the same samples
+        for (size_t chunk : {1, 160, 441, 1000, 4096}) {
+            PolyphaseResampler resampler;
+            resampler.configure(rate, sampleRate);
+            CHECK(resample(resampler, input, chunk) == whole);
+        }
+    }
+}
+
+// Output level over input level of a tone through `rate` -> 16 kHz, in dB
+double toneGainDb(size_t rate, double frequency) {
+    constexpr double amplitude = 10000.0;
+    PolyphaseResampler resampler;
+    resampler.configure(rate, sampleRate);
+    const std::vector<int16_t> output = resample(resampler, tone(frequency, rate, rate, amplitude), 480);
+    return 20.0 * std::log10(rms(output, PolyphaseResampler::tapsPerPhase) / (amplitude / std::sqrt(2.0)));
+}
+
+void testResamplerGain() {
+    for (size_t rate : {48000, 44100}) {
+        CHECK(std::fabs(toneGainDb(rate, 1000.0)) < 0.1);
+        CHECK(std::fabs(toneGainDb(rate, 7000.0)) < 0.6);
+        CHECK(toneGainDb(rate, 12000.0) < -60.0);  // would alias to 4 kHz
+    }
+}
+
+void testResamplerReset() {
+    PolyphaseResampler resampler;
+    resampler.configure(48000, sampleRate);
+    const std::vector<int16_t> input = tone(1000.0, 48000, 4800, 8000.0);
+    const std::vector<int16_t> first = resample(resampler, input, 480);
+    resampler.reset();
+    CHECK(resample(resampler, input, 480) == first);
+}
+
+void testRealFftMatchesDft() {
+    constexpr size_t size = MelFrontEnd::fftSize;
+    constexpr size_t bins = RealFft<size>::bins;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> uniform(-32768.0f, 32767.0f);
+    std::vector<float> input(size);
+    for (float& sample : input) sample = uniform(random);
+
+    RealFft<size> fft;
+    std::vector<float> power(bins);
+    fft.powerSpectrum(input.data(), power.data());
+
+    const double pi = 3.14159265358979323846;
+    double maxPower = 0.0, maxError = 0.0;
+    for (size_t k = 0; k < bins; k++) {
+        double re = 0.0, im = 0.0;
+        for (size_t n = 0; n < size; n++) {
+            re += input[n] * std::cos(2.0 * pi * k * n / size);
+            im -= input[n] * std::sin(2.0 * pi * k * n / size);
+        }
+        const double expected = re * re + im * im;
+        maxPower = std::max(maxPower, expected);
+        maxError = std::max(maxError, std::fabs(power[k] - expected));
+    }
+    CHECK(maxError < 1e-5 * maxPower);
+}
+
+std::vector<float> toFloat(const std::vector<int16_t>& samples) {
+    return std::vector<float>(samples.begin(), samples.end());
+}
+
+// Feed `input` in `chunk`-sized calls and collect every frame
+std::vector<float> mels(MelFrontEnd& frontEnd, const std::vector<float>& input, size_t chunk) {
+    std::vector<float> frames;
+    for (size_t offset = 0; offset + chunk <= input.size(); offset += chunk) {
+        const size_t count = frontEnd.process(input.data() + offset, chunk);
+        CHECK(count == chunk / MelFrontEnd::hopLength);
+        frames.insert(frames.end(), frontEnd.frames(),
+                      frontEnd.frames() + count * MelFrontEnd::numMels);
+    }
+    return frames;
+}
+
+void testMelFrontEndSilence() {
+    // amin 1e-10 after the rescale: log10(1e-10) + 2
+    MelFrontEnd frontEnd(1280);
+    const std::vector<float> frames = mels(frontEnd, std::vector<float>(1280 * 4, 0.0f), 1280);
+    CHECK(frames.size() == 32 * MelFrontEnd::numMels);
+    for (float value : frames) {
+        CHECK(std::fabs(value + 8.0f) < 1e-5f);
+    }
+}
+
+void testMelFrontEndChunking() {
+    // Frames do not depend on how the audio is split, apart from the per-call floor
+    const std::vector<float> input = toFloat(tone(700.0, sampleRate, 6400, 8000.0));
+    MelFrontEnd whole(6400);
+    const std::vector<float> reference = mels(whole, input, 6400);
+    CHECK(reference.size() == 40 * MelFrontEnd::numMels);
+    for (size_t chunk : {160, 320, 1280}) {
+        MelFrontEnd frontEnd(chunk);
+        const std::vector<float> frames = mels(frontEnd, input, chunk);
+        CHECK(frames.size() == reference.size());
+        if (frames.size() != reference.size()) continue;
+        for (size_t i = 0; i < frames.size(); i++) {
+            CHECK(std::fabs(frames[i] - reference[i]) < 1e-5f);
+        }
+    }
+}
+
+void testMelFrontEndTone() {
+    // A 1 kHz tone peaks in the band centred on it, bands 12 and 13 of 60-3800 Hz
+    MelFrontEnd frontEnd(1280);
+    const std::vector<float> frames = mels(frontEnd, toFloat(tone(1000.0, sampleRate, 2560, 10000.0)), 1280);
+    const float* last = &frames[frames.size() - MelFrontEnd::numMels];
+    const size_t loudest = std::max_element(last, last + MelFrontEnd::numMels) - last;
+    CHECK(loudest == 12 || loudest == 13);
+
+    // Nothing more than 80 dB (8 after the rescale) below the call's loudest frame
+    const float peak = *std::max_element(frames.end() - 8 * MelFrontEnd::numMels, frames.end());
+    for (auto it = frames.end() - 8 * MelFrontEnd::numMels; it != frames.end(); ++it) {
+        CHECK(*it >= peak - 8.0f - 1e-5f);
+    }
+}
+
+void testMelFrontEndReset() {
+    const std::vector<float> input = toFloat(tone(300.0, sampleRate, 2560, 5000.0));
+    MelFrontEnd frontEnd(1280);
+    const std::vector<float> first = mels(frontEnd, input, 1280);
+    frontEnd.reset();
+    CHECK(mels(frontEnd, input, 1280) == first);
+}
+
+} // namespace
+
+int main() {
+    testStartAndHangover();
+    testHysteresisBand();
+    testEarlyEndpoint();
+    testSlowFadeKeepsHangover();
+    testFastFallThenRise();
+    testBandBreaksFastFall();
+    testEarlyOffUsesHangover();
+    testResamplerConfigure();
+    testResamplerOutputCounts();
+    testResamplerGain();
+    testResamplerReset();
+    testRealFftMatchesDft();
+    testMelFrontEndSilence();
+    testMelFrontEndChunking();
+    testMelFrontEndTone();
+    testMelFrontEndReset();
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All pipeline tests passed\n");
+    return 0;
+}
@@ -0,0 +1,942 @@
+// Host replay and benchmark tool for the wake word pipeline.
+// Streams 16 kHz mono 16-bit WAV files through WakeupDetector::processAudio and
+// reports detections, per-stage queue wait and compute percentiles, end-to-end
+// latency, real-time factor and the CPU time of every worker thread.
+//
+//   wakeword_replay --mel melspectrogram.onnx --emb embedding_model.onnx
+//                   --ww alexa_v0.1.onnx [--ww ...] [--vad vad.onnx] [options] a.wav ...
+//
+// Without --realtime each chunk is scored before the next one is fed, so nothing
+// is dropped and stage timings are pure compute; with --realtime chunks arrive
+// on the audio clock as they would from AudioRecord. With --compare-fp32 every
+// file is replayed a second time through FP32 models and the per-frame score
+// drift of the selected FP16/INT8 variants is reported. With --offline the
+// files skip the streaming threads and are scored in batches with
+// WakeupDetector::processFiles, one file per core. With --streams N every file
+// is fed to N streams of one MultiStreamDetector in lockstep, as the beams of a
+// microphone array would be, so the shared models score them in batches.
+// With --cascade T each wake word model with a .stage1 first-stage model runs
+// only after that model scores above T; offline, every file is also scored
+// without the cascade and the detections it loses are reported. With
+// --adaptive-stride MS embeddings are computed only every MS while idle.
+// --overload and --max-lag choose what a stage that falls behind drops; only
+// --realtime replays, where the audio does not wait for the pipeline, build lag.
+// Streaming single-detector replays also take WAV files at other rates, such as
+// 48 kHz, and feed them through the detector's native-rate resampler. With
+// --pause-resume every file is streamed twice around the service's end-of-turn
+// pause()/resume(), and the tool fails if VAD or gating behave differently after it.
+// With --compare-mels only the mel model is loaded: every file, plus digital
+// silence and low-level noise where log10 is most sensitive, goes through both
+// the model and MelFrontEnd, and the per-frame error of the native front end is
+// reported against the model's own frames.
+
+#include "audio_convert.h"
+#include "mel_frontend.h"
+#include "multi_stream_detector.h"
+#include "wakeup_detector.h"
+#include "platform_log.h"
+#include "wav_file.h"
+#include <onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kSampleRate = 16000;
+
+struct Options {
+    std::string melModel;
+    std::string embModel;
+    std::vector<std::string> wwModels;
+    std::string vadModel;
+    std::string cacheDirectory;
+    std::vector<std::string> wavFiles;
+    size_t chunkSamples = 1280;
+    bool realtime = false;
+    bool nativeMels = false;
+    int gatingHangoverMs = -1;  // < 0: gating off
+    int endHangoverMs = -1;     // < 0: default endpointing hangover
+    int earlyHangoverMs = -1;   // < 0: early endpointing off
+    float cascadeThreshold = -1.0f;  // < 0: cascade off
+    int idleStrideMs = -1;           // < 0: fixed 80 ms embedding stride
+    QueueConfig queues;
+    bool queuesSet = false;
+    std::vector<std::string> lowPriority;  // wake word names shed first by degrade
+    StagePrecisions precisions;
+    bool compareFp32 = false;
+    bool offline = false;
+    OfflineOptions offlineOptions;
+    size_t streams = 0;  // 0: single-stream WakeupDetector
+    bool lowMemory = false;
+    bool pauseResume = false;
+    bool compareMels = false;
+    bool verbose = false;
+};
+
+// Every score of every wake word head, in frame order
+using ScoreTrace = std::vector<std::vector<float>>;
+
+struct Detection {
+    std::string wakeWord;
+    double seconds;
+};
+
+void printUsage(const char* argv0) {
+    std::fprintf(stderr,
+        "usage: %s --mel MODEL --emb MODEL --ww MODEL [--ww MODEL ...] [options] WAV...\n"
+        "  --vad MODEL        run Silero VAD alongside the wake word models\n"
+        "  --gating MS        suspend wake word models during silence (needs --vad)\n"
+        "  --hangover MS      silence that ends a speech segment (default 500, needs --vad)\n"
+        "  --early-endpoint MS  end segments after MS when speech stops crisply (needs --vad)\n"
+        "  --native-mels      use the native mel front end instead of the mel model\n"
+        "  --cascade T        run wake word models only after their .stage1 model scores above T\n"
+        "  --adaptive-stride MS  compute embeddings only every MS while idle (80 ms otherwise)\n"
+        "  --realtime         feed audio at 1x speed instead of as fast as possible\n"
+        "  --overload P       policy of a stage behind real time: drop-newest, drop-oldest\n"
+        "                     (default), skip-to-live, degrade\n"
+        "  --max-lag MS       lag the overload policy allows (default 1000)\n"
+        "  --low-priority NAME  wake word degrade skips first\n"
+        "  --chunk N          samples per processAudio call (default 1280)\n"
+        "  --mel-precision P, --emb-precision P, --ww-precision P\n"
+        "                     model variant per stage: fp32 (default), fp16, int8, int8-static\n"
+        "  --compare-fp32     also replay through FP32 models and report score drift\n"
+        "  --cache DIR        cache optimized graphs of .onnx models in DIR\n"
+        "  --offline          score files in batches without the streaming threads\n"
+        "  --threads N        offline worker threads (default: one per core)\n"
+        "  --batch N          offline windows per model run (default 64)\n"
+        "  --streams N        feed every file to N streams of a multi-stream detector\n"
+        "  --low-memory       minimal queues and lean sessions, as on 2 GB devices\n"
+        "  --pause-resume     replay every file again after the service's end-of-turn\n"
+        "                     enableVAD(false), pause(), resume() and check VAD and gating (needs --vad)\n"
+        "  --compare-mels     only compare the native mel front end with the mel model, on\n"
+        "                     every file and on silence and low-level noise (needs only --mel)\n"
+        "  --verbose          keep the pipeline's info logs\n",
+        argv0);
+}
+
+bool parsePrecision(const char* value, ModelPrecision& precision) {
+    const std::string name = value;
+    if (name == "fp32") precision = ModelPrecision::Fp32;
+    else if (name == "fp16") precision = ModelPrecision::Fp16;
+    else if (name == "int8") precision = ModelPrecision::Int8Dynamic;
+    else if (name == "int8-static") precision = ModelPrecision::Int8Static;
+    else return false;
+    return true;
+}
+
+bool parseOverloadPolicy(const char* value, OverloadPolicy& policy) {
+    const std::string name = value;
+    if (name == "drop-newest") policy = OverloadPolicy::DropNewest;
+    else if (name == "drop-oldest") policy = OverloadPolicy::DropOldest;
+    else if (name == "skip-to-live") policy = OverloadPolicy::SkipToLive;
+    else if (name == "degrade") policy = OverloadPolicy::Degrade;
+    else return false;
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (arg == "--mel" && (v = value())) options.melModel = v;
+        else if (arg == "--emb" && (v = value())) options.embModel = v;
+        else if (arg == "--ww" && (v = value())) options.wwModels.emplace_back(v);
+        else if (arg == "--vad" && (v = value())) options.vadModel = v;
+        else if (arg == "--cache" && (v = value())) options.cacheDirectory = v;
+        else if (arg == "--gating" && (v = value())) options.gatingHangoverMs = std::atoi(v);
+        else if (arg == "--cascade" && (v = value())) options.cascadeThreshold = std::strtof(v, nullptr);
+        else if (arg == "--adaptive-stride" && (v = value())) options.idleStrideMs = std::atoi(v);
+        else if (arg == "--chunk" && (v = value())) options.chunkSamples = std::strtoul(v, nullptr, 10);
+        else if (arg == "--mel-precision" && (v = value())) {
+            if (!parsePrecision(v, options.precisions.mel)) return false;
+        } else if (arg == "--emb-precision" && (v = value())) {
+            if (!parsePrecision(v, options.precisions.embedding)) return false;
+        } else if (arg == "--ww-precision" && (v = value())) {
+            if (!parsePrecision(v, options.precisions.wakeWord)) return false;
+        }
+        else if (arg == "--overload" && (v = value())) {
+            if (!parseOverloadPolicy(v, options.queues.policy)) return false;
+            options.queuesSet = true;
+        } else if (arg == "--max-lag" && (v = value())) {
+            options.queues.maxLagMs = std::atoi(v);
+            options.queuesSet = true;
+        }
+        else if (arg == "--hangover" && (v = value())) options.endHangoverMs = std::atoi(v);
+        else if (arg == "--early-endpoint" && (v = value())) options.earlyHangoverMs = std::atoi(v);
+        else if (arg == "--low-priority" && (v = value())) options.lowPriority.emplace_back(v);
+        else if (arg == "--threads" && (v = value())) options.offlineOptions.threads = std::strtoul(v, nullptr, 10);
+        else if (arg == "--batch" && (v = value())) options.offlineOptions.batchSize = std::strtoul(v, nullptr, 10);
+        else if (arg == "--streams" && (v = value())) options.streams = std::strtoul(v, nullptr, 10);
+        else if (arg == "--compare-fp32") options.compareFp32 = true;
+        else if (arg == "--offline") options.offline = true;
+        else if (arg == "--native-mels") options.nativeMels = true;
+        else if (arg == "--realtime") options.realtime = true;
+        else if (arg == "--low-memory") options.lowMemory = true;
+        else if (arg == "--pause-resume") options.pauseResume = true;
+        else if (arg == "--compare-mels") options.compareMels = true;
+        else if (arg == "--verbose") options.verbose = true;
+        else if (!arg.empty() && arg[0] != '-') options.wavFiles.push_back(arg);
+        else return false;
+    }
+    // Score drift compares frame by frame, which needs the deterministic fast mode;
+    // offline scoring has no clock, VAD, per-stage latencies or queues; multi-stream
+    // detectors have no precision comparison, gating, cascade, overload policy,
+    // endpointing options, low-memory mode, pause/resume checks or offline mode;
+    // endpointing and the pause/resume check need the VAD; the mel comparison runs
+    // the mel model on its own
+    if (options.compareMels) {
+        return !options.melModel.empty() && !options.nativeMels && !options.wavFiles.empty() &&
+               !options.offline && options.streams == 0;
+    }
+    const bool endpointingSet = options.endHangoverMs >= 0 || options.earlyHangoverMs >= 0;
+    return (!options.melModel.empty() || options.nativeMels) && !options.embModel.empty() &&
+           !options.wwModels.empty() && !options.wavFiles.empty() && options.chunkSamples > 0 &&
+           !(options.compareFp32 && options.realtime) &&
+           !((endpointingSet || options.pauseResume) && options.vadModel.empty()) &&
+           !(options.offline && (options.realtime || options.compareFp32 || !options.vadModel.empty() ||
+                                 options.idleStrideMs >= 0 || options.queuesSet)) &&
+           !(options.streams > 0 && (options.offline || options.compareFp32 ||
+                                     options.gatingHangoverMs >= 0 ||
+                                     options.cascadeThreshold >= 0 || options.idleStrideMs >= 0 ||
+                                     options.queuesSet || !options.lowPriority.empty() ||
+                                     endpointingSet || options.lowMemory ||
+                                     options.pauseResume));
+}
+
+void waitUntilDrained(const WakeupDetector& detector) {
+    while (!detector.isDrained()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+bool setUpDetector(WakeupDetector& detector, const Options& options,
+                   const StagePrecisions& precisions) {
+    detector.setNativeMelFrontEnd(options.nativeMels);
+    detector.setLowMemoryMode(options.lowMemory);
+    if (options.cascadeThreshold >= 0) {
+        detector.setCascade(true, options.cascadeThreshold);
+    }
+    detector.setQueueConfig(options.queues);
+    if (!detector.initialize(options.melModel, options.embModel, options.wwModels,
+                             StageProviders(), precisions)) {
+        std::fprintf(stderr, "failed to initialize detector\n");
+        return false;
+    }
+    const std::vector<std::string> names = detector.wakeWordNames();
+    for (const auto& name : options.lowPriority) {
+        const auto it = std::find(names.begin(), names.end(), name);
+        if (it == names.end()) {
+            std::fprintf(stderr, "no wake word named %s\n", name.c_str());
+            return false;
+        }
+        detector.setWakeWordPriority(static_cast<size_t>(it - names.begin()), false);
+    }
+    if (!options.vadModel.empty()) {
+        if (!detector.initializeVAD(options.vadModel)) {
+            std::fprintf(stderr, "failed to initialize VAD\n");
+            return false;
+        }
+        if (options.gatingHangoverMs >= 0) {
+            detector.setVadGating(true, options.gatingHangoverMs);
+        }
+        EndpointConfig endpointing = detector.endpointConfig();
+        if (options.endHangoverMs >= 0) {
+            endpointing.hangoverMs = options.endHangoverMs;
+        }
+        if (options.earlyHangoverMs >= 0) {
+            endpointing.earlyEndpoint = true;
+            endpointing.earlyHangoverMs = options.earlyHangoverMs;
+        }
+        detector.setEndpointConfig(endpointing);
+    }
+    if (options.idleStrideMs >= 0) {
+        detector.setAdaptiveStride(true, options.idleStrideMs);
+    }
+    return true;
+}
+
+// Feed one file in chunks and wait until it has been scored; returns wall seconds
+double streamFile(WakeupDetector& detector, const std::vector<int16_t>& samples,
+                  const Options& options, std::atomic<size_t>& fedSamples, uint32_t sampleRate) {
+    const auto wallStart = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < samples.size(); offset += options.chunkSamples) {
+        const size_t count = std::min(options.chunkSamples, samples.size() - offset);
+        if (options.realtime) {
+            std::this_thread::sleep_until(wallStart + std::chrono::microseconds(
+                static_cast<int64_t>(offset) * 1000000 / sampleRate));
+        }
+        fedSamples = offset + count;
+        detector.processAudio(samples.data() + offset, count);
+        if (!options.realtime) {
+            waitUntilDrained(detector);
+        }
+    }
+    waitUntilDrained(detector);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+}
+
+// Per-head score difference between a reduced-precision run and its FP32 reference
+void printDrift(const std::vector<std::string>& names, const ScoreTrace& scores,
+                const ScoreTrace& reference, size_t detections, size_t referenceDetections) {
+    std::printf("  drift vs FP32 (%zu vs %zu detection(s)):\n", detections, referenceDetections);
+    for (size_t head = 0; head < names.size(); head++) {
+        const size_t frames = std::min(scores[head].size(), reference[head].size());
+        double sum = 0.0, maxDrift = 0.0;
+        for (size_t i = 0; i < frames; i++) {
+            const double drift = std::fabs(scores[head][i] - reference[head][i]);
+            sum += drift;
+            maxDrift = std::max(maxDrift, drift);
+        }
+        std::printf("    %-20s %8zu frames  mean %.5f  max %.5f\n", names[head].c_str(), frames,
+                    frames ? sum / frames : 0.0, maxDrift);
+        if (scores[head].size() != reference[head].size()) {
+            std::printf("    %-20s frame count differs: %zu vs %zu\n", "", scores[head].size(),
+                        reference[head].size());
+        }
+    }
+}
+
+// Detections of `reference` with no detection of the same wake word in `result`
+// within half a second, i.e. the false rejects the cascade added
+size_t missedDetections(const OfflineResult& result, const OfflineResult& reference) {
+    constexpr uint64_t tolerance = kSampleRate / 2;
+    size_t missed = 0;
+    for (const auto& expected : reference.detections) {
+        const bool found = std::any_of(result.detections.begin(), result.detections.end(),
+                                       [&](const OfflineDetection& detection) {
+            const uint64_t distance = detection.sample > expected.sample
+                ? detection.sample - expected.sample : expected.sample - detection.sample;
+            return detection.wakeWord == expected.wakeWord && distance <= tolerance;
+        });
+        if (!found) missed++;
+    }
+    return missed;
+}
+
+// Batched scoring of every file at once; prints detections and the overall RTF
+int runOffline(const WakeupDetector& detector, const Options& options) {
+    const std::vector<std::string> names = detector.wakeWordNames();
+    const auto wallStart = std::chrono::steady_clock::now();
+    const std::vector<OfflineResult> results =
+        detector.processFiles(options.wavFiles, options.offlineOptions);
+    const double wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // The same files with every frame scored, to measure what the cascade costs
+    std::vector<OfflineResult> references;
+    if (options.cascadeThreshold >= 0) {
+        OfflineOptions uncascaded = options.offlineOptions;
+        uncascaded.cascade = false;
+        references = detector.processFiles(options.wavFiles, uncascaded);
+    }
+    size_t totalFrames = 0, totalEvaluated = 0, totalMissed = 0, totalExtra = 0;
+
+    double totalAudioSeconds = 0.0;
+    size_t totalDetections = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        const OfflineResult& result = results[i];
+        if (!result.ok) {
+            std::fprintf(stderr, "%s: offline scoring failed\n", options.wavFiles[i].c_str());
+            continue;
+        }
+        const double audioSeconds = static_cast<double>(result.samples) / kSampleRate;
+        totalAudioSeconds += audioSeconds;
+        totalDetections += result.detections.size();
+        std::printf("%s: %.2f s audio, %zu frames, %zu detection(s)\n",
+                    options.wavFiles[i].c_str(), audioSeconds, result.frameEndSamples.size(),
+                    result.detections.size());
+        for (const auto& detection : result.detections) {
+            std::printf("  %8.3f s  %s  (%.4f)\n", static_cast<double>(detection.sample) / kSampleRate,
+                        names[detection.wakeWord].c_str(), detection.score);
+        }
+        if (!references.empty() && references[i].ok) {
+            const size_t missed = missedDetections(result, references[i]);
+            const size_t extra = missedDetections(references[i], result);
+            size_t evaluated = 0;
+            for (size_t frames : result.evaluatedFrames) evaluated += frames;
+            const size_t headFrames = result.frameEndSamples.size() * names.size();
+            totalFrames += headFrames;
+            totalEvaluated += evaluated;
+            totalMissed += missed;
+            totalExtra += extra;
+            std::printf("  cascade: %zu of %zu head frames evaluated, %zu detection(s) lost, %zu added\n",
+                        evaluated, headFrames, missed, extra);
+        }
+    }
+    if (totalAudioSeconds <= 0.0) {
+        return 1;
+    }
+    std::printf("\nTotal: %.2f s audio, %.3f s wall, RTF %.5f (%.0fx real time), %zu detection(s)\n",
+                totalAudioSeconds, wallSeconds, wallSeconds / totalAudioSeconds,
+                wallSeconds > 0 ? totalAudioSeconds / wallSeconds : 0.0, totalDetections);
+    if (!references.empty()) {
+        std::printf("Cascade: %.1f%% of head frames evaluated, %zu detection(s) lost, %zu added\n",
+                    totalFrames ? 100.0 * totalEvaluated / totalFrames : 0.0, totalMissed, totalExtra);
+    }
+    return 0;
+}
+
+void printStage(const char* name, const LatencyHistogram& histogram) {
+    if (histogram.count() == 0) return;
+    std::printf("  %-10s %8llu %9.1f %8llu %8llu %8llu %8llu\n", name,
+                static_cast<unsigned long long>(histogram.count()), histogram.mean(),
+                static_cast<unsigned long long>(histogram.percentile(50)),
+                static_cast<unsigned long long>(histogram.percentile(90)),
+                static_cast<unsigned long long>(histogram.percentile(99)),
+                static_cast<unsigned long long>(histogram.max()));
+}
+
+void printCpu(const char* name, int64_t cpuNanos, double audioSeconds) {
+    if (cpuNanos == 0) return;
+    const double ms = cpuNanos / 1e6;
+    std::printf("  %-10s %10.1f ms  %6.2f%% of audio time\n", name, ms,
+                audioSeconds > 0 ? 100.0 * ms / (audioSeconds * 1000.0) : 0.0);
+}
+
+// Every file through options.streams streams at once; prints per-stream
+// detections and the RTF over all streams' audio
+int runMultiStream(const Options& options) {
+    MultiStreamDetector detector;
+    const auto initStart = std::chrono::steady_clock::now();
+    detector.setNativeMelFrontEnd(options.nativeMels);
+    if (!detector.initialize(options.melModel, options.embModel, options.wwModels, options.streams,
+                             StageProviders(), options.precisions)) {
+        std::fprintf(stderr, "failed to initialize multi-stream detector\n");
+        return 1;
+    }
+    if (!options.vadModel.empty() && !detector.initializeVAD(options.vadModel)) {
+        std::fprintf(stderr, "failed to initialize VAD\n");
+        return 1;
+    }
+    std::vector<int> streamIds;
+    for (size_t i = 0; i < options.streams; i++) {
+        streamIds.push_back(detector.addStream());
+    }
+    std::printf("Initialization: %.1f ms, %zu streams\n", std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - initStart).count(), options.streams);
+
+    const std::vector<std::string> names = detector.wakeWordNames();
+    std::atomic<size_t> fedSamples{0};
+    std::atomic<int> voiceSegments{0};
+    std::mutex detectionsMutex;
+    std::vector<std::vector<Detection>> detections(options.streams);
+    detector.setVoiceActivityCallback([&](int, bool active) {
+        if (active) voiceSegments++;
+    });
+
+    auto waitForStreams = [&]() {
+        while (!detector.isDrained()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    };
+
+    double totalAudioSeconds = 0.0;
+    double totalWallSeconds = 0.0;
+    int64_t cpuMel = 0, cpuEmbedding = 0, cpuWakeWord = 0, cpuVad = 0;
+    size_t totalDetections = 0;
+    detector.resetStats();
+
+    for (const auto& path : options.wavFiles) {
+        std::vector<int16_t> samples;
+        if (!readWavFile(path, samples)) continue;
+
+        for (auto& list : detections) list.clear();
+        fedSamples = 0;
+        if (!detector.start([&](int stream, size_t wakeWord) {
+                std::lock_guard<std::mutex> lock(detectionsMutex);
+                detections[stream].push_back(
+                    {names[wakeWord], static_cast<double>(fedSamples) / kSampleRate});
+            })) {
+            std::fprintf(stderr, "failed to start multi-stream detector\n");
+            return 1;
+        }
+
+        const auto wallStart = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < samples.size(); offset += options.chunkSamples) {
+            const size_t count = std::min(options.chunkSamples, samples.size() - offset);
+            if (options.realtime) {
+                std::this_thread::sleep_until(wallStart + std::chrono::microseconds(
+                    static_cast<int64_t>(offset) * 1000000 / kSampleRate));
+            }
+            fedSamples = offset + count;
+            for (int id : streamIds) {
+                detector.processAudio(id, samples.data() + offset, count);
+            }
+            if (!options.realtime) {
+                waitForStreams();
+            }
+        }
+        waitForStreams();
+        const double wallSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        detector.stop();
+
+        const auto& stats = detector.stats();
+        cpuMel += stats.mel.cpuNanos;
+        cpuEmbedding += stats.embedding.cpuNanos;
+        cpuWakeWord += stats.wakeWord.cpuNanos;
+        cpuVad += stats.vad.cpuNanos;
+
+        const double audioSeconds =
+            static_cast<double>(samples.size()) * options.streams / kSampleRate;
+        totalAudioSeconds += audioSeconds;
+        totalWallSeconds += wallSeconds;
+        size_t fileDetections = 0;
+        for (const auto& list : detections) fileDetections += list.size();
+        totalDetections += fileDetections;
+
+        std::printf("%s: %.2f s audio over %zu streams, %.3f s wall, RTF %.4f, %zu detection(s)\n",
+                    path.c_str(), audioSeconds, options.streams, wallSeconds,
+                    audioSeconds > 0 ? wallSeconds / audioSeconds : 0.0, fileDetections);
+        for (size_t stream = 0; stream < detections.size(); stream++) {
+            for (const auto& detection : detections[stream]) {
+                std::printf("  stream %-3zu %8.2f s  %s\n", stream, detection.seconds,
+                            detection.wakeWord.c_str());
+            }
+        }
+    }
+
+    if (totalAudioSeconds <= 0.0) {
+        return 1;
+    }
+    const auto& stats = detector.stats();
+    if (options.verbose) {
+        std::printf("\n%s\n", stats.toJson().c_str());
+    }
+    std::printf("\nTotal: %.2f s audio, %.3f s wall, RTF %.4f, %zu detection(s)",
+                totalAudioSeconds, totalWallSeconds, totalWallSeconds / totalAudioSeconds,
+                totalDetections);
+    if (!options.vadModel.empty()) {
+        std::printf(", %d voice segment(s)", voiceSegments.load());
+    }
+    if (stats.mel.droppedNanos > 0 || stats.vad.droppedNanos > 0) {
+        std::printf("\nDropped: %.0f ms of samples, %.0f ms of VAD audio", stats.mel.droppedNanos / 1e6,
+                    stats.vad.droppedNanos / 1e6);
+    }
+    std::printf("\n\nWorker CPU time\n");
+    printCpu("mel", cpuMel, totalAudioSeconds);
+    printCpu("embedding", cpuEmbedding, totalAudioSeconds);
+    printCpu("wakeword", cpuWakeWord, totalAudioSeconds);
+    printCpu("vad", cpuVad, totalAudioSeconds);
+    return 0;
+}
+
+} // namespace
+
+// Largest difference after rescale the native front end may show against the
+// mel model on values above the 80 dB floor
+constexpr double kMelTolerance = 5e-4;
+
+struct MelError {
+    size_t frames = 0;
+    size_t floored = 0;  // values at either side's 80 dB floor, not compared
+    double sum = 0.0;
+    double max = 0.0;
+    double worstFrameMean = 0.0;
+    size_t compared = 0;
+};
+
+// Every frameSize block of `samples` through the mel model and through a fresh
+// MelFrontEnd. The front end emits the frame ending at (k + 1) * hopLength, so
+// `align` leading zeros put its frames on the model's grid of frames starting at
+// multiples of hopLength within the block, and the first `skip` frames, which
+// start before the block, are dropped. The floor is taken per call on both
+// sides, but the front end's dropped frames can raise its peak, so values at
+// either floor are counted and skipped rather than compared.
+MelError compareMelBlocks(Ort::Session& session, const std::string& inputName,
+                          const std::string& outputName, const std::vector<int16_t>& samples) {
+    constexpr size_t frameSize = StandardGeometry::frameSize;
+    constexpr size_t numMels = MelFrontEnd::numMels;
+    constexpr size_t history = MelFrontEnd::fftSize - MelFrontEnd::hopLength;
+    constexpr size_t align = (MelFrontEnd::hopLength - history % MelFrontEnd::hopLength) %
+                             MelFrontEnd::hopLength;
+    constexpr size_t skip = (history + align) / MelFrontEnd::hopLength;
+    constexpr float floorBelowPeak = 8.0f;  // 80 dB after the (x / 10) rescale
+    constexpr float floorMargin = 1e-5f;
+
+    MelFrontEnd frontEnd(frameSize + align);
+    const std::vector<float> zeros(align, 0.0f);
+    std::vector<float> block(frameSize);
+    const auto memoryInfo = Ort::MemoryInfo::CreateCpu(
+        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    const char* inputNames[] = {inputName.c_str()};
+    const char* outputNames[] = {outputName.c_str()};
+
+    MelError error;
+    for (size_t offset = 0; offset + frameSize <= samples.size(); offset += frameSize) {
+        convertPcm16(samples.data() + offset, block.data(), nullptr, frameSize);
+
+        Ort::Value input = Ort::Value::CreateTensor<float>(
+            memoryInfo, block.data(), block.size(), StandardGeometry::melInputShape.data(),
+            StandardGeometry::melInputShape.size());
+        auto outputs = session.Run(Ort::RunOptions{nullptr}, inputNames, &input, 1, outputNames, 1);
+        const float* modelData = outputs.front().GetTensorData<float>();
+        const size_t modelValues = outputs.front().GetTensorTypeAndShapeInfo().GetElementCount();
+        std::vector<float> model(modelData, modelData + modelValues);
+        float modelPeak = -INFINITY;
+        for (float& value : model) {
+            value = (value / 10.0f) + 2.0f;
+            modelPeak = std::max(modelPeak, value);
+        }
+
+        frontEnd.reset();
+        frontEnd.process(zeros.data(), zeros.size());
+        const size_t nativeFrames = frontEnd.process(block.data(), frameSize);
+        const float* native = frontEnd.frames();
+        float nativePeak = -INFINITY;
+        for (size_t i = 0; i < nativeFrames * numMels; i++) {
+            nativePeak = std::max(nativePeak, native[i]);
+        }
+
+        const size_t frames = std::min(model.size() / numMels, nativeFrames - skip);
+        for (size_t frame = 0; frame < frames; frame++) {
+            double frameSum = 0.0;
+            size_t frameCompared = 0;
+            for (size_t m = 0; m < numMels; m++) {
+                const float expected = model[frame * numMels + m];
+                const float actual = native[(frame + skip) * numMels + m];
+                if (expected <= modelPeak - floorBelowPeak + floorMargin ||
+                    actual <= nativePeak - floorBelowPeak + floorMargin) {
+                    error.floored++;
+                    continue;
+                }
+                const double difference = std::fabs(static_cast<double>(actual) - expected);
+                frameSum += difference;
+                frameCompared++;
+                error.max = std::max(error.max, difference);
+            }
+            error.sum += frameSum;
+            error.compared += frameCompared;
+            if (frameCompared > 0) {
+                error.worstFrameMean = std::max(error.worstFrameMean, frameSum / frameCompared);
+            }
+        }
+        error.frames += frames;
+    }
+    return error;
+}
+
+// Inputs near silence, where a small power error moves log10 the most
+std::vector<std::pair<std::string, std::vector<int16_t>>> lowLevelInputs() {
+    const size_t count = 4 * kSampleRate;
+    std::vector<std::pair<std::string, std::vector<int16_t>>> inputs;
+    inputs.emplace_back("digital silence", std::vector<int16_t>(count, 0));
+
+    std::mt19937 random(1);
+    for (double sigma : {0.5, 1.0, 4.0}) {
+        std::normal_distribution<double> noise(0.0, sigma);
+        std::vector<int16_t> samples(count);
+        for (int16_t& sample : samples) {
+            sample = static_cast<int16_t>(std::lrint(noise(random)));
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "noise %.1f LSB rms", sigma);
+        inputs.emplace_back(name, std::move(samples));
+    }
+
+    std::vector<int16_t> tone(count);
+    const double step = 2.0 * 3.14159265358979323846 * 440.0 / kSampleRate;
+    for (size_t i = 0; i < count; i++) {
+        tone[i] = static_cast<int16_t>(std::lrint(3.0 * std::sin(step * i)));
+    }
+    inputs.emplace_back("440 Hz at 3 LSB", std::move(tone));
+    return inputs;
+}
+
+// Native mel front end against the mel model; fails above kMelTolerance
+int runMelComparison(const Options& options) {
+    std::unique_ptr<Ort::Session> session =
+        loadStageSession(options.melModel, StageProviders().mel, options.precisions.mel);
+    const std::vector<int64_t> inputShape(StandardGeometry::melInputShape.begin(),
+                                          StandardGeometry::melInputShape.end());
+    if (!session || !validateSessionIo(*session, "mel", inputShape)) {
+        std::fprintf(stderr, "failed to load mel model\n");
+        return 1;
+    }
+    Ort::AllocatorWithDefaultOptions allocator;
+    const std::string inputName = session->GetInputNameAllocated(0, allocator).get();
+    const std::string outputName = session->GetOutputNameAllocated(0, allocator).get();
+
+    std::vector<std::pair<std::string, std::vector<int16_t>>> inputs;
+    for (const auto& path : options.wavFiles) {
+        std::vector<int16_t> samples;
+        uint32_t sampleRate = 0;
+        if (!readWavFile(path, samples, sampleRate)) continue;
+        if (sampleRate != kSampleRate) {
+            std::fprintf(stderr, "%s: %u Hz, the mel model takes %d Hz\n", path.c_str(), sampleRate,
+                         kSampleRate);
+            continue;
+        }
+        inputs.emplace_back(path, std::move(samples));
+    }
+    for (auto& input : lowLevelInputs()) {
+        inputs.push_back(std::move(input));
+    }
+
+    double worst = 0.0;
+    std::printf("Native mels vs model, absolute error after rescale:\n");
+    std::printf("  %-28s %8s %10s %10s %12s %8s\n", "input", "frames", "max", "mean",
+                "worst frame", "floored");
+    for (const auto& input : inputs) {
+        const MelError error = compareMelBlocks(*session, inputName, outputName, input.second);
+        std::printf("  %-28s %8zu %10.2e %10.2e %12.2e %8zu\n", input.first.c_str(), error.frames,
+                    error.max, error.compared ? error.sum / error.compared : 0.0,
+                    error.worstFrameMean, error.floored);
+        worst = std::max(worst, error.max);
+    }
+    const bool ok = worst <= kMelTolerance;
+    std::printf("Largest error %.2e (tolerance %.0e): %s\n", worst, kMelTolerance,
+                ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (!options.verbose) {
+        platformLogMinPriority() = PLATFORM_LOG_WARN;
+    }
+
+    setOptimizedModelCacheDirectory(options.cacheDirectory);
+    if (options.compareMels) {
+        return runMelComparison(options);
+    }
+    if (options.streams > 0) {
+        return runMultiStream(options);
+    }
+    
+    WakeupDetector detector;
+    const auto initStart = std::chrono::steady_clock::now();
+    if (!setUpDetector(detector, options, options.precisions)) {
+        return 1;
+    }
+    std::printf("Initialization: %.1f ms\n", std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - initStart).count());
+    if (options.offline) {
+        return runOffline(detector, options);
+    }
+    const std::vector<std::string> names = detector.wakeWordNames();
+    
+    // FP32 reference run on the same audio, scored frame by frame
+    std::unique_ptr<WakeupDetector> reference;
+    if (options.compareFp32) {
+        reference = std::make_unique<WakeupDetector>();
+        if (!setUpDetector(*reference, options, StagePrecisions())) {
+            return 1;
+        }
+    }
+    ScoreTrace scores(names.size()), referenceScores(names.size());
+    detector.setScoreCallback([&](size_t head, float score) { scores[head].push_back(score); });
+    if (reference) {
+        reference->setScoreCallback([&](size_t head, float score) {
+            referenceScores[head].push_back(score);
+        });
+    }
+
+    std::atomic<size_t> fedSamples{0};
+    std::atomic<int> voiceSegments{0};
+    std::mutex detectionsMutex;
+    std::vector<Detection> detections;
+    std::vector<EndpointEvent> endpoints;  // VAD thread only, read after stop()
+    detector.setEndpointCallback([&](const EndpointEvent& event) {
+        if (event.speech) voiceSegments++;
+        endpoints.push_back(event);
+    });
+
+    double totalAudioSeconds = 0.0;
+    double totalWallSeconds = 0.0;
+    int64_t cpuMel = 0, cpuEmbedding = 0, cpuWakeWord = 0, cpuVad = 0;
+    size_t totalDetections = 0;
+    bool pauseResumeFailed = false;
+    detector.resetStats();
+
+    for (const auto& path : options.wavFiles) {
+        std::vector<int16_t> samples;
+        uint32_t sampleRate = 0;
+        if (!readWavFile(path, samples, sampleRate)) continue;
+        if (!detector.setInputSampleRate(static_cast<int>(sampleRate)) ||
+            (reference && !reference->setInputSampleRate(static_cast<int>(sampleRate)))) {
+            std::fprintf(stderr, "%s: cannot resample %u Hz\n", path.c_str(), sampleRate);
+            continue;
+        }
+
+        detections.clear();
+        endpoints.clear();
+        for (auto& trace : scores) trace.clear();
+        fedSamples = 0;
+        if (!detector.start([&](const std::string& wakeWord) {
+                std::lock_guard<std::mutex> lock(detectionsMutex);
+                detections.push_back({wakeWord, static_cast<double>(fedSamples) / sampleRate});
+            })) {
+            std::fprintf(stderr, "failed to start detector\n");
+            return 1;
+        }
+
+        double wallSeconds = streamFile(detector, samples, options, fedSamples, sampleRate);
+        double audioSeconds = static_cast<double>(samples.size()) / sampleRate;
+        
+        // The service ends each voice turn this way; the second pass must see the
+        // same speech and, with gating, keep the gate closing on silence. Events
+        // are counted while paused, when the VAD thread is parked.
+        size_t firstPassEvents = 0;
+        if (options.pauseResume) {
+            detector.enableVAD(false);
+            detector.pause();
+            firstPassEvents = endpoints.size();
+            const int64_t firstGated = detector.stats().gatedNanos;
+            size_t firstSegments = 0;
+            for (const auto& event : endpoints) firstSegments += event.speech;
+
+            detector.resume();
+            wallSeconds += streamFile(detector, samples, options, fedSamples, sampleRate);
+            audioSeconds *= 2;
+            detector.pause();
+
+            const int64_t secondGated = detector.stats().gatedNanos - firstGated;
+            size_t secondSegments = 0;
+            for (size_t i = firstPassEvents; i < endpoints.size(); i++) {
+                secondSegments += endpoints[i].speech;
+            }
+            const bool ok = secondSegments == firstSegments &&
+                            (firstGated == 0) == (secondGated == 0);
+            pauseResumeFailed |= !ok;
+            std::printf("%s: after pause/resume %zu voice segment(s) (%zu before), "
+                        "gated %.0f ms (%.0f ms before): %s\n", path.c_str(), secondSegments,
+                        firstSegments, secondGated / 1e6, firstGated / 1e6, ok ? "ok" : "FAILED");
+        }
+        detector.stop();
+        if (options.pauseResume) {
+            endpoints.resize(firstPassEvents);
+        }
+
+        const auto& stats = detector.stats();
+        cpuMel += stats.mel.cpuNanos;
+        cpuEmbedding += stats.embedding.cpuNanos;
+        cpuWakeWord += stats.wakeWord.cpuNanos;
+        cpuVad += stats.vad.cpuNanos;
+
+        totalAudioSeconds += audioSeconds;
+        totalWallSeconds += wallSeconds;
+        totalDetections += detections.size();
+
+        std::printf("%s: %.2f s audio, %.3f s wall, RTF %.4f, %zu detection(s)\n", path.c_str(),
+                    audioSeconds, wallSeconds, audioSeconds > 0 ? wallSeconds / audioSeconds : 0.0,
+                    detections.size());
+        for (const auto& detection : detections) {
+            std::printf("  %8.2f s  %s\n", detection.seconds, detection.wakeWord.c_str());
+        }
+        // Speech segments on the VAD sample clock, with how long after the last
+        // speech each end was decided
+        for (size_t i = 0; i < endpoints.size(); i++) {
+            if (!endpoints[i].speech) continue;
+            const double start = static_cast<double>(endpoints[i].sample) / kSampleRate;
+            if (i + 1 < endpoints.size() && !endpoints[i + 1].speech) {
+                const EndpointEvent& end = endpoints[i + 1];
+                std::printf("  speech %8.3f - %8.3f s  (ended +%.0f ms%s)\n", start,
+                            static_cast<double>(end.sample) / kSampleRate,
+                            static_cast<double>(end.decidedSample - end.sample) * 1000.0 / kSampleRate,
+                            end.early ? ", early" : "");
+            } else {
+                std::printf("  speech %8.3f s -\n", start);
+            }
+        }
+        
+        if (reference) {
+            for (auto& trace : referenceScores) trace.clear();
+            std::atomic<size_t> referenceDetections{0};
+            if (!reference->start([&](const std::string&) { referenceDetections++; })) {
+                std::fprintf(stderr, "failed to start FP32 reference\n");
+                return 1;
+            }
+            streamFile(*reference, samples, options, fedSamples, sampleRate);
+            reference->stop();
+            printDrift(names, scores, referenceScores, detections.size(), referenceDetections);
+        }
+    }
+
+    if (totalAudioSeconds <= 0.0) {
+        return 1;
+    }
+
+    const auto& stats = detector.stats();
+    if (options.verbose) {
+        std::printf("\n%s\n", stats.toJson().c_str());
+    }
+    std::printf("\nTotal: %.2f s audio, %.3f s wall, RTF %.4f, %zu detection(s)",
+                totalAudioSeconds, totalWallSeconds, totalWallSeconds / totalAudioSeconds,
+                totalDetections);
+    if (!options.vadModel.empty()) {
+        std::printf(", %d voice segment(s)", voiceSegments.load());
+    }
+    if (options.cascadeThreshold >= 0) {
+        std::printf(", %llu wake word run(s), %llu skipped by the cascade",
+                    static_cast<unsigned long long>(stats.wakeWordRuns.load()),
+                    static_cast<unsigned long long>(stats.wakeWordSkips.load()));
+    }
+    if (options.idleStrideMs >= 0) {
+        std::printf(", %llu embedding(s) of %llu interpolated",
+                    static_cast<unsigned long long>(stats.embeddingsInterpolated.load()),
+                    static_cast<unsigned long long>(stats.embeddingsInterpolated.load() +
+                                                    stats.embedding.compute.count()));
+    }
+    std::printf("\n\nStage latency (us)\n");
+    std::printf("  %-10s %8s %9s %8s %8s %8s %8s\n", "stage", "count", "mean", "p50", "p90", "p99", "max");
+    printStage("ingest", stats.ingest);
+    printStage("mel wait", stats.mel.wait);
+    printStage("mel", stats.mel.compute);
+    printStage("emb wait", stats.embedding.wait);
+    printStage("embedding", stats.embedding.compute);
+    printStage("ww wait", stats.wakeWord.wait);
+    printStage("wakeword", stats.wakeWord.compute);
+    printStage("vad", stats.vad.compute);
+    printStage("end-to-end", stats.endToEnd);
+    printStage("detection", stats.detection);
+    printStage("mel lag", stats.mel.lag);
+    printStage("emb lag", stats.embedding.lag);
+    printStage("ww lag", stats.wakeWord.lag);
+    printStage("vad lag", stats.vad.lag);
+    
+    const StageStats* stages[] = {&stats.mel, &stats.embedding, &stats.wakeWord, &stats.vad};
+    int64_t droppedNanos = 0;
+    for (const StageStats* stage : stages) droppedNanos += stage->droppedNanos;
+    if (droppedNanos > 0 || stats.overloadSkips > 0) {
+        std::printf("\nOverload: dropped mel %.0f ms, embedding %.0f ms, wake word %.0f ms, "
+                    "VAD %.0f ms; %llu low-priority run(s) shed\n",
+                    stats.mel.droppedNanos / 1e6, stats.embedding.droppedNanos / 1e6,
+                    stats.wakeWord.droppedNanos / 1e6, stats.vad.droppedNanos / 1e6,
+                    static_cast<unsigned long long>(stats.overloadSkips.load()));
+    }
+
+    std::printf("\nWorker CPU time\n");
+    printCpu("mel", cpuMel, totalAudioSeconds);
+    printCpu("embedding", cpuEmbedding, totalAudioSeconds);
+    printCpu("wakeword", cpuWakeWord, totalAudioSeconds);
+    printCpu("vad", cpuVad, totalAudioSeconds);
+
+    const MemoryReport memory = detector.memoryReport();
+    std::printf("\nMemory: pipeline %.0f KB, models %.1f MB mapped (%.1f MB resident), "
+                "RSS %.1f MB (peak %.1f MB, %.1f MB anonymous)\n",
+                memory.pipelineBytes() / 1024.0, memory.modelMappedBytes / 1048576.0,
+                memory.modelResidentBytes / 1048576.0, memory.residentBytes / 1048576.0,
+                memory.peakResidentBytes / 1048576.0, memory.anonymousBytes / 1048576.0);
+    if (options.verbose) {
+        std::printf("%s\n", memory.toJson().c_str());
+    }
+    return pauseResumeFailed ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Optional Perfetto/systrace markers around each pipeline stage. Compiled in
+// only for Android builds configured with -DVOICEASSISTANT_ATRACE=ON; otherwise
+// TRACE_SECTION expands to nothing.
+#if defined(__ANDROID__) && defined(VOICEASSISTANT_ATRACE)
+#include <android/trace.h>
+
+class TraceSection {
+public:
+    explicit TraceSection(const char* name) { ATrace_beginSection(name); }
+    ~TraceSection() { ATrace_endSection(); }
+    TraceSection(const TraceSection&) = delete;
+    TraceSection& operator=(const TraceSection&) = delete;
+};
+
+#define TRACE_SECTION(name) TraceSection traceSection(name)
+#else
+#define TRACE_SECTION(name) ((void)0)
+#endif
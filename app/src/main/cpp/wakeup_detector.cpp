@@ -1,91 +1,23 @@
 #include "wakeup_detector.h"
-#include <android/log.h>
+#include "platform_log.h"
 #include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <filesystem>
-#include <numeric>
 #include <string>
 
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, "WakeupDetector", __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "WakeupDetector", __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "WakeupDetector", __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, "WakeupDetector", __VA_ARGS__)
-// JNI helper functions for voice activity callback
-static jmethodID onVoiceActivityStartedMethod = nullptr;
-static jmethodID onVoiceActivityEndedMethod = nullptr;
-// Global callback to pass data from C++ to Java
-static JavaVM* javaVM = nullptr;
-static jweak wakeupDetectorCallback = nullptr;
-static jmethodID onWakeWordDetectedMethod = nullptr;
-static jmethodID onDetectionScoreUpdateMethod = nullptr;
-
-// JNI helper function to handle wake word detection callback
-void notifyWakeWordDetected(const std::string& wakeWord) {
-    JNIEnv* env;
-    bool detach = false;
-    int getEnvStat = javaVM->GetEnv((void**)&env, JNI_VERSION_1_6);
-    
-    if (getEnvStat == JNI_EDETACHED) {
-        javaVM->AttachCurrentThread(&env, nullptr);
-        detach = true;
-    }
-    
-    if (env && wakeupDetectorCallback) {
-        jobject callback = env->NewLocalRef(wakeupDetectorCallback);
-        if (callback) {
-            jstring jWakeWord = env->NewStringUTF(wakeWord.c_str());
-            env->CallVoidMethod(callback, onWakeWordDetectedMethod, jWakeWord);
-            env->DeleteLocalRef(jWakeWord);
-            env->DeleteLocalRef(callback);
-            
-            if (env->ExceptionCheck()) {
-                env->ExceptionDescribe();
-                env->ExceptionClear();
-            }
-        }
-    }
-    
-    if (detach) {
-        javaVM->DetachCurrentThread();
-    }
-}
-
-// JNI helper function to handle detection score updates
-void notifyDetectionScoreUpdate(const std::string& wakeWord, float score, float threshold, 
-                               int activation, int triggerLevel) {
-    JNIEnv* env;
-    bool detach = false;
-    int getEnvStat = javaVM->GetEnv((void**)&env, JNI_VERSION_1_6);
-    
-    if (getEnvStat == JNI_EDETACHED) {
-        javaVM->AttachCurrentThread(&env, nullptr);
-        detach = true;
-    }
-    
-    if (env && wakeupDetectorCallback && onDetectionScoreUpdateMethod) {
-        jobject callback = env->NewLocalRef(wakeupDetectorCallback);
-        if (callback) {
-            jstring jWakeWord = env->NewStringUTF(wakeWord.c_str());
-            env->CallVoidMethod(callback, onDetectionScoreUpdateMethod, jWakeWord, 
-                               score, threshold, activation, triggerLevel);
-            env->DeleteLocalRef(jWakeWord);
-            env->DeleteLocalRef(callback);
-            
-            if (env->ExceptionCheck()) {
-                env->ExceptionDescribe();
-                env->ExceptionClear();
-            }
-        }
-    }
-    
-    if (detach) {
-        javaVM->DetachCurrentThread();
-    }
-}
+#define LOGD(...) PLATFORM_LOG(PLATFORM_LOG_DEBUG, "WakeupDetector", __VA_ARGS__)
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "WakeupDetector", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "WakeupDetector", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "WakeupDetector", __VA_ARGS__)
 
 // Constructor
 WakeupDetector::WakeupDetector() 
-    : isRunning(false), isInitialized(false), samplesReady(false), melsReady(false) {
+    : isRunning(false), isInitialized(false) {
     LOGI("WakeupDetector constructor called");
+    resampler.configure(vadSampleRate, vadSampleRate);
+    enableArenaShrinkage(arenaShrinkOptions);
 }
 
 // Destructor
@@ -96,37 +28,159 @@ WakeupDetector::~WakeupDetector() {
 
 // Initialize with model paths
 bool WakeupDetector::initialize(const std::string& melModelPath, const std::string& embModelPath, 
-                               const std::vector<std::string>& wakeWordModelPaths) {
+                               const std::vector<std::string>& wakeWordModelPaths,
+                               const StageProviders& providers,
+                               const StagePrecisions& precisions) {
     LOGI("Initializing WakeupDetector with models");
     
     this->melModelPath = melModelPath;
     this->embModelPath = embModelPath;
-    this->wwModelPaths = wakeWordModelPaths;
+    this->stageProviders = providers;
+    this->stagePrecisions = precisions;
     
-    if (wwModelPaths.empty()) {
+    if (wakeWordModelPaths.empty()) {
         LOGE("No wake word models provided");
         return false;
     }
     
+    if (isRunning) {
+        LOGE("Cannot initialize while the detector is running");
+        return false;
+    }
+    
     try {
-        // Initialize ONNX Runtime
-        env = std::make_unique<Ort::Env>(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "WakeupDetector");
-        env->DisableTelemetryEvents();
+        // Allocate the hand-off rings once; nothing on the audio path allocates after this.
+        // Each queue holds at least what its consumer needs for one inference at the
+        // longest idle stride; the sample ring is rounded up to a power of two.
+        // Low-memory mode keeps just that minimum.
+        const size_t numWakeWords = wakeWordModelPaths.size();
+        QueueConfig sizes = queues;
+        if (lowMemory) {
+            sizes.sampleQueueMs = sizes.melQueueMs = sizes.featureQueueMs = 0;
+        }
+        const size_t melCapacity = std::max<size_t>(
+            static_cast<size_t>(std::max(sizes.melQueueMs, 0)) * 1000000 / melFrameNanos,
+            embWindowSize + maxIdleStrideSteps * embStepSize);
+        const size_t featureCapacity = std::max<size_t>(
+            static_cast<size_t>(std::max(sizes.featureQueueMs, 0)) * 1000000 / featureFrameNanos,
+            2 * maxWakeWordFrames);
+        sampleRing.allocate(std::max<size_t>(
+            static_cast<size_t>(std::max(sizes.sampleQueueMs, 0)) * vadSampleRate / 1000, 2 * frameSize));
+        preRollRing.allocate(preRollSamples);
+        sampleMarks.allocate(sampleMarkCapacity);
+        melOrigin.assign(melCapacity, 0);
+        melReady.assign(melCapacity, 0);
+        featureOrigin.assign(featureCapacity, 0);
+        featureReady.assign(featureCapacity, 0);
+        melWindow.allocate(numMels, melCapacity);
+        featureWindow.allocate(embFeatures, featureCapacity);
+        
+        captureScratch.resize(chunkSamples);
+        vadScratch.resize(chunkSamples);
+        
+        Ort::AllocatorWithDefaultOptions allocator;
+        auto memoryInfo = Ort::MemoryInfo::CreateCpu(
+            OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
         
-        // Initialize mutexes and condition variables for wake word models
-        const size_t numWakeWords = wwModelPaths.size();
-        // Replace resize calls with direct initialization to avoid copy/move operations
-        mutFeatures = std::vector<std::mutex>(numWakeWords);
-        cvFeatures = std::vector<std::condition_variable>(numWakeWords);
+        // Load every model once and run a dummy inference so the first real
+        // frame after start() does not pay for lazy allocation and kernel setup.
+        // The warm-up also tells us each output shape, which is fixed from here on.
+        melInput.assign(frameSize, 0.0f);
+        if (useNativeMels) {
+            // The native front end replaces the mel session entirely
+            melFrontEnd = std::make_unique<MelFrontEnd>(chunkSamples);
+            melBinding.reset();
+            melSession.reset();
+            melOutput.clear();
+            LOGI("Using native mel front end");
+        } else {
+            melFrontEnd.reset();
+            constexpr auto& melInputShape = Geometry::melInputShape;
+            melSession = loadStageSession(melModelPath, stageProviders.mel, stagePrecisions.mel);
+            if (!validateSessionIo(*melSession, "mel", melInputShape)) {
+                return false;
+            }
+            melInputName = melSession->GetInputNameAllocated(0, allocator).get();
+            melOutputName = melSession->GetOutputNameAllocated(0, allocator).get();
+            const auto melOutputShape = warmUpSession(*melSession, melInputName, melOutputName,
+                                                      melInputShape);
+        
+            melOutput.assign(shapeElementCount(melOutputShape), 0.0f);
+            if (melOutput.empty() || melOutput.size() % numMels != 0) {
+                LOGE("Unexpected mel model output size %zu", melOutput.size());
+                return false;
+            }
+            melBinding = std::make_unique<Ort::IoBinding>(*melSession);
+            melBinding->BindInput(melInputName.c_str(), Ort::Value::CreateTensor<float>(
+                memoryInfo, melInput.data(), melInput.size(), melInputShape.data(), melInputShape.size()));
+            melBinding->BindOutput(melOutputName.c_str(), Ort::Value::CreateTensor<float>(
+                memoryInfo, melOutput.data(), melOutput.size(), melOutputShape.data(), melOutputShape.size()));
+            LOGI("Mel spectrogram model loaded");
+        }
+        
+        constexpr auto& embInputShape = Geometry::embInputShape;
+        embSession = loadStageSession(embModelPath, stageProviders.embedding, stagePrecisions.embedding);
+        if (!validateSessionIo(*embSession, "embedding", embInputShape)) {
+            return false;
+        }
+        embInputName = embSession->GetInputNameAllocated(0, allocator).get();
+        embOutputName = embSession->GetOutputNameAllocated(0, allocator).get();
+        const auto embOutputShape = warmUpSession(*embSession, embInputName, embOutputName,
+                                                  embInputShape);
+        if (shapeElementCount(embOutputShape) != embFeatures) {
+            LOGE("Unexpected embedding model output size %zu", shapeElementCount(embOutputShape));
+            return false;
+        }
         
-        // Initialize atomic vector with proper size (no resize)
-        featuresReady = std::vector<std::atomic<bool>>(numWakeWords);
-        features.resize(numWakeWords);
+        // One input view per mel window slot and one output view per feature window
+        // slot, so each embedding is read in place and lands directly in the window
+        embInputViews.clear();
+        for (size_t slot = 0; slot < melWindow.capacityFrames(); slot++) {
+            embInputViews.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo, melWindow.slotData(slot), Geometry::embInputFloats,
+                embInputShape.data(), embInputShape.size()));
+        }
+        embOutputViews.clear();
+        for (size_t slot = 0; slot < featureWindow.capacityFrames(); slot++) {
+            embOutputViews.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo, featureWindow.slotData(slot), embFeatures,
+                embOutputShape.data(), embOutputShape.size()));
+        }
+        embScratch.assign(embFeatures, 0.0f);
+        lastEmbedding.assign(embFeatures, 0.0f);
+        embScratchView = Ort::Value::CreateTensor<float>(
+            memoryInfo, embScratch.data(), embScratch.size(),
+            embOutputShape.data(), embOutputShape.size());
+        embBinding = std::make_unique<Ort::IoBinding>(*embSession);
+        LOGI("Embedding model loaded");
         
-        for (auto& ready : featuresReady) {
-            ready = false;
+        // One input view per feature window slot for each head geometry, so a
+        // head of either window length can be added later without allocating here
+        wwInputViews.clear();
+        wwWideInputViews.clear();
+        for (size_t slot = 0; slot < featureWindow.capacityFrames(); slot++) {
+            wwInputViews.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo, featureWindow.slotData(slot), StandardGeometry::wwInputFloats,
+                StandardGeometry::wwInputShape.data(), StandardGeometry::wwInputShape.size()));
+            wwWideInputViews.push_back(Ort::Value::CreateTensor<float>(
+                memoryInfo, featureWindow.slotData(slot), WideHeadGeometry::wwInputFloats,
+                WideHeadGeometry::wwInputShape.data(), WideHeadGeometry::wwInputShape.size()));
         }
         
+        auto table = std::make_shared<WakeWordTable>();
+        for (size_t i = 0; i < wakeWordModelPaths.size(); i++) {
+            auto head = loadWakeWordHead(wakeWordModelPaths[i], i);
+            if (!head) {
+                return false;
+            }
+            table->heads.push_back(std::move(head));
+        }
+        {
+            std::lock_guard<std::mutex> lock(wwTableMutex);
+            publishTable(std::move(table));
+        }
+        frameScores.reserve(wwTable->outputs);
+        
         isInitialized = true;
         LOGI("WakeupDetector initialized successfully with %zu wake word models", numWakeWords);
         return true;
@@ -136,8 +190,183 @@ bool WakeupDetector::initialize(const std::string& melModelPath, const std::stri
     }
 }
 
+// One wake word model, and its cascade first stage, loaded and warmed up with
+// preallocated outputs; the same path for initialize() and addWakeWord()
+std::shared_ptr<WakeupDetector::WakeWordHead> WakeupDetector::loadWakeWordHead(
+        const std::string& modelPath, size_t index) {
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto memoryInfo = Ort::MemoryInfo::CreateCpu(
+        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    
+    auto head = std::make_shared<WakeWordHead>();
+    head->index = index;
+    
+    // Extract wake word name from filename
+    head->name = std::filesystem::path(modelPath).stem().string();
+    head->session = loadStageSession(modelPath, stageProviders.wakeWord, stagePrecisions.wakeWord);
+    
+    // A model with a fixed window of WideHeadGeometry frames gets the wide views;
+    // anything else must fit the standard window
+    const bool wide = !inputShapeMatches(*head->session, StandardGeometry::wwInputShape) &&
+                      inputShapeMatches(*head->session, WideHeadGeometry::wwInputShape);
+    head->frames = wide ? WideHeadGeometry::wwFeatures : StandardGeometry::wwFeatures;
+    head->inputShape = wide ? WideHeadGeometry::wwInputShape : StandardGeometry::wwInputShape;
+    head->inputViews = wide ? &wwWideInputViews : &wwInputViews;
+    if (!validateSessionIo(*head->session, head->name.c_str(), head->inputShape)) {
+        return nullptr;
+    }
+    head->inputName = head->session->GetInputNameAllocated(0, allocator).get();
+    head->outputName = head->session->GetOutputNameAllocated(0, allocator).get();
+    const auto wwOutputShape = warmUpSession(*head->session, head->inputName,
+                                             head->outputName, head->inputShape);
+    
+    head->scores.assign(shapeElementCount(wwOutputShape), 0.0f);
+    if (head->scores.empty()) {
+        LOGE("Wake word model %s produces no scores", head->name.c_str());
+        return nullptr;
+    }
+    head->binding = std::make_unique<Ort::IoBinding>(*head->session);
+    head->binding->BindOutput(head->outputName.c_str(), Ort::Value::CreateTensor<float>(
+        memoryInfo, head->scores.data(), head->scores.size(),
+        wwOutputShape.data(), wwOutputShape.size()));
+    
+    if (cascadeEnabled) {
+        const std::string firstStagePath = cascadeModelPath(modelPath);
+        if (firstStagePath.empty()) {
+            LOGW("No first-stage model for %s, it runs on every frame", head->name.c_str());
+        } else {
+            // Tiny by design, so always the FP32 file
+            head->firstStage = loadStageSession(firstStagePath, stageProviders.wakeWord,
+                                                ModelPrecision::Fp32);
+            if (!validateSessionIo(*head->firstStage, head->name.c_str(), head->inputShape)) {
+                return nullptr;
+            }
+            head->firstStageInputName = head->firstStage->GetInputNameAllocated(0, allocator).get();
+            head->firstStageOutputName = head->firstStage->GetOutputNameAllocated(0, allocator).get();
+            const auto firstStageShape = warmUpSession(*head->firstStage, head->firstStageInputName,
+                                                       head->firstStageOutputName, head->inputShape);
+            head->firstStageScores.assign(shapeElementCount(firstStageShape), 0.0f);
+            if (head->firstStageScores.empty()) {
+                LOGE("First-stage model of %s produces no scores", head->name.c_str());
+                return nullptr;
+            }
+            head->firstStageBinding = std::make_unique<Ort::IoBinding>(*head->firstStage);
+            head->firstStageBinding->BindOutput(head->firstStageOutputName.c_str(),
+                Ort::Value::CreateTensor<float>(memoryInfo, head->firstStageScores.data(),
+                    head->firstStageScores.size(), firstStageShape.data(), firstStageShape.size()));
+            LOGI("Cascade first stage for %s loaded", head->name.c_str());
+        }
+    }
+    
+    LOGI("Wake word model %s loaded (%zu-embedding window)", head->name.c_str(), head->frames);
+    return head;
+}
+
+void WakeupDetector::publishTable(std::shared_ptr<WakeWordTable> table) {
+    table->windowFrames = wwFeatures;
+    table->outputs = 0;
+    for (const auto& head : table->heads) {
+        if (!head) continue;
+        table->windowFrames = std::max(table->windowFrames, head->frames);
+        table->outputs += head->scores.size();
+    }
+    
+    // Grace period: once the worker is seen reading anything but the old table,
+    // every later read starts from the new one
+    std::shared_ptr<const WakeWordTable> previous = std::move(wwTable);
+    wwTable = std::move(table);
+    activeTable.store(wwTable.get());
+    wwWindowFrames.store(wwTable->windowFrames);
+    featuresSignal.notify();
+    while (previous && tableInUse.load() == previous.get()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+std::shared_ptr<const WakeupDetector::WakeWordTable> WakeupDetector::loadedTable() const {
+    std::lock_guard<std::mutex> lock(wwTableMutex);
+    return wwTable;
+}
+
+int WakeupDetector::addWakeWord(const std::string& modelPath) {
+    if (!isInitialized) {
+        LOGE("Cannot add a wake word: not initialized");
+        return -1;
+    }
+    
+    try {
+        std::lock_guard<std::mutex> lock(wwTableMutex);
+        const std::string name = std::filesystem::path(modelPath).stem().string();
+        size_t index = wwTable->heads.size();
+        for (size_t i = 0; i < wwTable->heads.size(); i++) {
+            const auto& head = wwTable->heads[i];
+            if (head && head->name == name) {
+                LOGE("Wake word %s is already loaded", name.c_str());
+                return -1;
+            }
+            if (!head) {
+                index = std::min(index, i);
+            }
+        }
+        
+        // Loaded and warmed up before the worker can see it
+        auto head = loadWakeWordHead(modelPath, index);
+        if (!head) {
+            return -1;
+        }
+        auto table = std::make_shared<WakeWordTable>(*wwTable);
+        if (index == table->heads.size()) {
+            table->heads.push_back(std::move(head));
+        } else {
+            table->heads[index] = std::move(head);
+        }
+        publishTable(std::move(table));
+        LOGI("Wake word %s added as %zu", name.c_str(), index);
+        return static_cast<int>(index);
+    } catch (const std::exception& e) {
+        LOGE("Error adding wake word model %s: %s", modelPath.c_str(), e.what());
+        return -1;
+    }
+}
+
+bool WakeupDetector::removeWakeWord(const std::string& name) {
+    std::lock_guard<std::mutex> lock(wwTableMutex);
+    if (!wwTable) {
+        LOGE("Cannot remove a wake word: not initialized");
+        return false;
+    }
+    
+    auto table = std::make_shared<WakeWordTable>(*wwTable);
+    auto it = std::find_if(table->heads.begin(), table->heads.end(),
+                           [&](const std::shared_ptr<WakeWordHead>& head) {
+                               return head && head->name == name;
+                           });
+    if (it == table->heads.end()) {
+        LOGE("No wake word %s to remove", name.c_str());
+        return false;
+    }
+    it->reset();
+    // Trailing free slots are dropped, so the index space shrinks back
+    while (!table->heads.empty() && !table->heads.back()) {
+        table->heads.pop_back();
+    }
+    // The removed head is released with the last table holding it, after the grace period
+    publishTable(std::move(table));
+    LOGI("Wake word %s removed", name.c_str());
+    return true;
+}
+
 // Start detection
 bool WakeupDetector::start(std::function<void(const std::string&)> callback) {
+    if (!callback) {
+        return start(std::function<void(size_t, const std::string&)>());
+    }
+    return start([callback = std::move(callback)](size_t, const std::string& name) {
+        callback(name);
+    });
+}
+
+bool WakeupDetector::start(std::function<void(size_t, const std::string&)> callback) {
     if (!isInitialized) {
         LOGE("Cannot start detector: not initialized");
         return false;
@@ -154,38 +383,38 @@ bool WakeupDetector::start(std::function<void(const std::string&)> callback) {
         // Set callback
         wakeWordCallback = std::move(callback);
         
-        // Reset state
+        // Reset state while no worker is touching the rings
+        sampleRing.clear();
+        preRollRing.clear();
+        sampleMarks.clear();
+        samplesWritten = 0;
+        samplesConsumed = 0;
+        pendingMark = SampleMark{0, 0};
+        resampler.reset();
+        resetStreamState();
+        gateOpen = true;
+        gateHangoverRemaining = 0;
+        ingestResumeCount = resumeCount.load();
+        captureRequest = -1;
+        paused = false;
+        parkedWorkers = 0;
+        liveWorkers = vadInitialized ? 4 : 3;
+        runOptions.UnsetTerminate();
+        arenaShrinkOptions.UnsetTerminate();
         isRunning = true;
-        samplesReady = false;
-        melsReady = false;
-        
-        for (auto& ready : featuresReady) {
-            ready = false;
-        }
-        
-        floatSamples.clear();
-        mels.clear();
-        for (auto& feature : features) {
-            feature.clear();
-        }
         
         // Reset VAD state if initialized
         if (vadInitialized) {
-            vadSamples.clear();
-            vadSamplesReady = false;
             vadEnabled = true;
             isVoiceDetected = false;
-            previousVoiceState = false;
+            speechEndPending = false;
         }
         
         // Start threads
         melThread = std::thread(&WakeupDetector::audioToMels, this);
         featuresThread = std::thread(&WakeupDetector::melsToFeatures, this);
         
-        wwThreads.clear();
-        for (size_t i = 0; i < wwModelPaths.size(); i++) {
-            wwThreads.emplace_back(&WakeupDetector::featuresToOutput, this, i);
-        }
+        wwThread = std::thread(&WakeupDetector::featuresToOutput, this);
         
         // Start VAD processing thread if initialized
         if (vadInitialized) {
@@ -209,295 +438,614 @@ void WakeupDetector::stop() {
     }
     
     LOGI("Stopping WakeupDetector");
+    const int64_t stopStart = monotonicNanos();
     
-    // Set running flag to false first to signal all threads they should exit
+    // Set running flag to false first to signal all threads they should exit,
+    // and cancel any Run() in flight; its worker sees the exception and exits
     isRunning = false;
+    runOptions.SetTerminate();
+    arenaShrinkOptions.SetTerminate();
     
     // Make sure VAD is disabled to prevent any callbacks during shutdown
     if (vadInitialized) {
         vadEnabled = false;
     }
     
-    // Wake up all threads to check isRunning and exit by notifying ALL threads waiting
-    try {
-        // Notify mel thread
-        {
-            std::unique_lock<std::mutex> lockSamples(mutSamples);
-            samplesReady = true;
-            cvSamples.notify_all();  // Notify all threads waiting on this condition
-        }
-        
-        // Notify features thread
-        {
-            std::unique_lock<std::mutex> lockMels(mutMels);
-            melsReady = true;
-            cvMels.notify_all();  // Notify all threads waiting on this condition
-        }
-        
-        // Notify all wake word model threads
-        for (size_t i = 0; i < featuresReady.size(); i++) {
-            std::unique_lock<std::mutex> lockFeatures(mutFeatures[i]);
-            featuresReady[i] = true;
-            cvFeatures[i].notify_all();  // Notify all threads waiting on this condition
-        }
-        
-        // Notify VAD thread if it exists
-        if (vadInitialized) {
-            std::unique_lock<std::mutex> lockVAD(mutVAD);
-            vadSamplesReady = true;
-            cvVAD.notify_all();  // Notify all threads waiting on this condition
-        }
-        
-        // Define timeout values for thread joins
-        const int JOIN_TIMEOUT_MS = 2000;  // 2 seconds timeout
-        
-        // Join threads with timeouts to prevent deadlocks
-        if (melThread.joinable()) {
-            if (joinThreadWithTimeout(melThread, JOIN_TIMEOUT_MS)) {
-                LOGI("Mel thread joined successfully");
-            } else {
-                LOGW("Mel thread join timed out after %d ms", JOIN_TIMEOUT_MS);
-            }
-        }
-        
-        if (featuresThread.joinable()) {
-            if (joinThreadWithTimeout(featuresThread, JOIN_TIMEOUT_MS)) {
-                LOGI("Features thread joined successfully");
-            } else {
-                LOGW("Features thread join timed out after %d ms", JOIN_TIMEOUT_MS);
-            }
+    // Wake every waiting or parked worker so it sees isRunning and exits
+    samplesSignal.notify();
+    melsSignal.notify();
+    featuresSignal.notify();
+    vadSignal.notify();
+    
+    for (std::thread* thread : {&melThread, &featuresThread, &wwThread, &vadThread}) {
+        if (thread->joinable()) {
+            thread->join();
         }
-        
-        // Join wake word threads
-        for (size_t i = 0; i < wwThreads.size(); i++) {
-            if (wwThreads[i].joinable()) {
-                if (joinThreadWithTimeout(wwThreads[i], JOIN_TIMEOUT_MS)) {
-                    LOGI("Wake word thread %zu joined successfully", i);
-                } else {
-                    LOGW("Wake word thread %zu join timed out after %d ms", i, JOIN_TIMEOUT_MS);
-                }
+    }
+    paused = false;
+    captureRequest = -1;
+    closeCapture(captureBuffer.written());
+    
+    // Clear any pending data to prevent processing during shutdown
+    sampleRing.clear();
+    melWindow.clear();
+    featureWindow.clear();
+    vadRing.clear();
+    
+    LOGI("WakeupDetector stopped in %.1f ms", (monotonicNanos() - stopStart) / 1e6);
+}
+
+bool WakeupDetector::pause() {
+    if (!isRunning) {
+        LOGE("Cannot pause: detector is not running");
+        return false;
+    }
+    if (paused.exchange(true)) {
+        return true;
+    }
+    
+    // Wake every worker; each parks once its current inference has finished
+    samplesSignal.notify();
+    melsSignal.notify();
+    featuresSignal.notify();
+    vadSignal.notify();
+    for (;;) {
+        const uint32_t seen = parkSignal.epoch();
+        if (parkedWorkers.load() >= liveWorkers.load()) break;
+        parkSignal.wait(seen);
+    }
+    
+    // Nothing runs now, so the stages can be reset from here. Speech in
+    // progress ends where the VAD stopped.
+    {
+        std::unique_lock<std::mutex> lockVAD(mutVAD);
+        const bool wasSpeaking = isVoiceDetected.exchange(false);
+        speechEndPending = false;
+        if (wasSpeaking) {
+            const EndpointEvent event{false, vadSampleClock, vadSampleClock, false};
+            if (vadCallback) {
+                vadCallback(false);
             }
-        }
-        
-        // Join VAD thread if joinable
-        if (vadThread.joinable()) {
-            if (joinThreadWithTimeout(vadThread, JOIN_TIMEOUT_MS)) {
-                LOGI("VAD thread joined successfully");
-            } else {
-                LOGW("VAD thread join timed out after %d ms", JOIN_TIMEOUT_MS);
+            if (endpointCallback) {
+                endpointCallback(event);
             }
         }
     }
-    catch (const std::exception& e) {
-        LOGE("Error during detector shutdown: %s", e.what());
+    resetStreamState();
+    // A detection from before the pause must not open a session after resume()
+    captureRequest = -1;
+    closeCapture(captureBuffer.written());
+    if (lowMemory) {
+        shrinkArena();
+    }
+    LOGI("WakeupDetector paused");
+    return true;
+}
+
+bool WakeupDetector::resume() {
+    if (!isRunning) {
+        LOGE("Cannot resume: detector is not running");
+        return false;
+    }
+    if (!paused) {
+        return true;
     }
     
-    // Clear any pending data to prevent processing during shutdown
-    floatSamples.clear();
-    mels.clear();
-    for (auto& feature : features) {
-        feature.clear();
+    // Listen for voice activity again, as start() does, whatever enableVAD()
+    // left while paused; the VAD state itself was reset by pause()
+    if (vadInitialized) {
+        vadEnabled = true;
     }
-    vadSamples.clear();
     
-    LOGI("WakeupDetector stopped");
+    // Counted before unpausing so the first processAudio() after resume sees it
+    resumeCount.fetch_add(1);
+    paused = false;
+    samplesSignal.notify();
+    melsSignal.notify();
+    featuresSignal.notify();
+    vadSignal.notify();
+    LOGI("WakeupDetector resumed");
+    return true;
 }
 
-// Helper function to join a thread with timeout
-bool WakeupDetector::joinThreadWithTimeout(std::thread& thread, int timeoutMs) {
-    if (!thread.joinable()) return true;
-    
-    // Try to join the thread normally for a short time
-    auto start = std::chrono::steady_clock::now();
+// Worker side of pause(): called at the top of each loop pass with the epoch
+// the pass read; returns true if the worker was parked and should loop again
+bool WakeupDetector::parkWhilePaused(EventSignal& signal, uint32_t seen) {
+    if (!paused) {
+        return false;
+    }
+    parkedWorkers.fetch_add(1);
+    parkSignal.notify();
+    if (paused && isRunning) {
+        signal.wait(seen);
+    }
+    parkedWorkers.fetch_sub(1);
+    return true;
+}
+
+// Called by every worker on its way out, so pause() never waits for it
+void WakeupDetector::exitWorker() {
+    liveWorkers.fetch_sub(1);
+    parkSignal.notify();
+}
+
+// Drop buffered audio and return every stage to its start() state. Only called
+// while no worker runs, or all of them are parked; processAudio may still be
+// writing, so its rings are emptied from the consumer side.
+void WakeupDetector::resetStreamState() {
+    for (const auto& head : loadedTable()->heads) {
+        if (!head) continue;
+        head->activation = 0;
+        head->cascadeHold = 0;
+    }
+    haveLastEmbedding = false;
+    embeddingDegraded = false;
+    gateReopenSample = noStageReset;
+    melResetFrame = noStageReset;
+    featureResetFrame = noStageReset;
+    samplesConsumed += sampleRing.discard(sampleRing.size());
+    sampleMarks.discard(sampleMarks.size());
+    melWindow.clear();
+    featureWindow.clear();
+    if (melFrontEnd) {
+        melFrontEnd->reset();
+    }
+    if (vadInitialized) {
+        vadRing.discard(vadRing.size());
+        vadResetPending = false;
+        if (vadIterator) {
+            vadIterator->reset();
+        }
+        resetEndpointer();
+    }
+}
+
+// Process audio data
+void WakeupDetector::processAudio(const int16_t* audioData, size_t numSamples) {
+    if (!isRunning || paused || !audioData || numSamples == 0) {
+        return;
+    }
     
-    // Use a separate thread to join with timeout
-    std::thread joiner = std::thread([&thread]() {
-        thread.join();
-    });
+    // First call after a resume(): audio held back for the gate, and the
+    // resampler's history, predate the pause
+    const uint32_t resumes = resumeCount.load();
+    if (resumes != ingestResumeCount) {
+        ingestResumeCount = resumes;
+        preRollRing.clear();
+        gateOpen = true;
+        gateHangoverRemaining = 0;
+        resampler.reset();
+    }
     
-    // Wait for short time (timeoutMs)
-    if (joiner.joinable()) {
-        auto status = std::cv_status::no_timeout;
-        {
-            std::mutex m;
-            std::unique_lock<std::mutex> lock(m);
-            std::condition_variable cv;
-            status = cv.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+    TRACE_SECTION("WakeupDetector::processAudio");
+    const int64_t ingestStart = monotonicNanos();
+    if (resampler.active()) {
+        for (size_t offset = 0; offset < numSamples; offset += PolyphaseResampler::blockSamples) {
+            const size_t count = std::min(PolyphaseResampler::blockSamples, numSamples - offset);
+            const size_t resampled = resampler.process(audioData + offset, count, resampleScratch.data());
+            if (resampled > 0) {
+                ingestAudio(resampleScratch.data(), resampled, ingestStart);
+            }
         }
-        
-        // If the joiner thread is still running (didn't join in time)
-        if (status == std::cv_status::timeout) {
-            // We can't actually terminate a thread safely in C++
-            // Just detach the joiner thread and return false
-            joiner.detach();
-            return false;
+    } else {
+        ingestAudio(audioData, numSamples, ingestStart);
+    }
+    pipelineStats.ingest.record(monotonicNanos() - ingestStart);
+}
+
+// One block of 16 kHz audio, from processAudio
+void WakeupDetector::ingestAudio(const int16_t* audioData, size_t numSamples, int64_t arrivalNanos) {
+    const bool capture = audioCaptureEnabled;
+    if (capture) {
+        captureBuffer.write(audioData, numSamples);
+    }
+    const bool feedVAD = vadInitialized && vadEnabled;
+    const bool open = updateGate(feedVAD, numSamples);
+    
+    // Convert each block once into both the raw (mel) and normalized (VAD) scalings.
+    // While the gate is closed the raw samples only go to the pre-roll ring.
+    size_t dropped = 0;
+    size_t vadDropped = 0;
+    for (size_t offset = 0; offset < numSamples; offset += captureScratch.size()) {
+        const size_t count = std::min(captureScratch.size(), numSamples - offset);
+        convertPcm16(audioData + offset, captureScratch.data(),
+                     feedVAD ? vadScratch.data() : nullptr, count);
+        if (open) {
+            const size_t written = sampleRing.write(captureScratch.data(), count);
+            samplesWritten += written;
+            dropped += count - written;
+        } else {
+            holdPreRoll(captureScratch.data(), count);
         }
-        else {
-            // Join completed in time
-            joiner.join();
-            return true;
+        if (feedVAD) {
+            vadDropped += count - vadRing.write(vadScratch.data(), count);
         }
     }
+    if (!open) {
+        pipelineStats.gatedNanos += samplesToNanos(numSamples);
+    }
+    if (open) {
+        // A lost mark only makes the next one stand in for these samples
+        const SampleMark mark{samplesWritten, arrivalNanos};
+        sampleMarks.write(&mark, 1);
+        samplesSignal.notify();
+    }
     
-    return true;
+    if (dropped > 0) {
+        pipelineStats.mel.droppedNanos += samplesToNanos(dropped);
+        LOGW("Sample ring full, dropped %zu samples", dropped);
+    }
+    
+    // Process for VAD if enabled
+    if (feedVAD) {
+        if (vadDropped > 0) {
+            pipelineStats.vad.droppedNanos += samplesToNanos(vadDropped);
+            LOGW("VAD ring full, dropped %zu samples", vadDropped);
+        }
+        vadSignal.notify();
+    }
+    
+    // The VAD thread ends speech; the capture session closes from here
+    if (capture) {
+        updateCapture(speechEndPending.exchange(false));
+    }
 }
 
-// Notify that voice activity has ended
-void notifyVoiceActivityEnded() {
-    JNIEnv* env;
-    bool detach = false;
-    int getEnvStat = javaVM->GetEnv((void**)&env, JNI_VERSION_1_6);
+bool WakeupDetector::setLowMemoryMode(bool enable) {
+    if (isRunning) {
+        LOGE("Cannot change low-memory mode while the detector is running");
+        return false;
+    }
+    lowMemory = enable;
+    setLowMemorySessions(enable);
+    LOGI("Low-memory mode %s", enable ? "on" : "off");
+    return true;
+}
 
-    if (getEnvStat == JNI_EDETACHED) {
-        javaVM->AttachCurrentThread(&env, nullptr);
-        detach = true;
+void WakeupDetector::trimMemory() {
+    if (isRunning) {
+        arenaShrinkPending = true;
+    } else {
+        shrinkArena();
     }
+}
 
-    if (env && wakeupDetectorCallback && onVoiceActivityEndedMethod) {
-        jobject callback = env->NewLocalRef(wakeupDetectorCallback);
-        if (callback) {
-            env->CallVoidMethod(callback, onVoiceActivityEndedMethod);
-            env->DeleteLocalRef(callback);
+// ORT only shrinks an arena at the end of a Run, so run one embedding on
+// whatever the window holds; the result goes to scratch and the stream state
+// is reset before the next frame anyway
+void WakeupDetector::shrinkArena() {
+    if (!embSession || !embBinding || embInputViews.empty()) {
+        return;
+    }
+    try {
+        embBinding->BindInput(embInputName.c_str(), embInputViews.front());
+        embBinding->BindOutput(embOutputName.c_str(), embScratchView);
+        embSession->Run(arenaShrinkOptions, *embBinding);
+        LOGI("Released free arena memory");
+    } catch (const std::exception& e) {
+        LOGW("Could not shrink the arena: %s", e.what());
+    }
+}
 
-            if (env->ExceptionCheck()) {
-                env->ExceptionDescribe();
-                env->ExceptionClear();
-            }
+MemoryReport WakeupDetector::memoryReport() const {
+    MemoryReport report;
+    report.sampleRing = sampleRing.capacity() * sizeof(float) +
+                        sampleMarks.capacity() * sizeof(SampleMark);
+    report.vadRing = vadRing.capacity() * sizeof(float);
+    report.preRoll = preRollRing.capacity() * sizeof(float);
+    report.melWindow = melWindow.storageBytes() + (melOrigin.size() + melReady.size()) * sizeof(int64_t);
+    report.featureWindow = featureWindow.storageBytes() +
+                           (featureOrigin.size() + featureReady.size()) * sizeof(int64_t);
+    if (const auto table = loadedTable()) {
+        for (const auto& head : table->heads) {
+            if (!head) continue;
+            report.wakeWordHeads += (head->scores.size() + head->firstStageScores.size()) * sizeof(float);
         }
     }
+    report.captureRing = captureBuffer.capacity() * sizeof(int16_t);
+    report.scoreRing = scoreBuffer.capacity() * sizeof(ScoreRecord);
+    report.stageScratch = (melInput.size() + melOutput.size() + captureScratch.size() + vadScratch.size() +
+                           embScratch.size() + lastEmbedding.size()) * sizeof(float) +
+                          resampleScratch.size() * sizeof(int16_t) + resampler.memoryBytes() +
+                          frameScores.capacity() * sizeof(ScoreRecord) +
+                          (vadIterator ? vadIterator->buffer_bytes() : 0);
+    report.readProcessUsage();
+    return report;
+}
 
-    if (detach) {
-        javaVM->DetachCurrentThread();
+bool WakeupDetector::setInputSampleRate(int sampleRate) {
+    if (isRunning) {
+        LOGE("Cannot change the input sample rate while the detector is running");
+        return false;
+    }
+    if (sampleRate <= 0 || !resampler.configure(static_cast<size_t>(sampleRate), vadSampleRate)) {
+        LOGE("Unsupported input sample rate %d Hz", sampleRate);
+        resampler.configure(vadSampleRate, vadSampleRate);
+        return false;
     }
+    resampleScratch.assign(resampler.active() ? resampler.maxOutput(PolyphaseResampler::blockSamples) : 0, 0);
+    LOGI("Input sample rate %d Hz%s", sampleRate, resampler.active() ? ", resampled to 16 kHz" : "");
+    return true;
 }
-// Process audio data
-void WakeupDetector::processAudio(const int16_t* audioData, size_t numSamples) {
-    if (!isRunning || !audioData || numSamples == 0) {
+
+bool WakeupDetector::setAudioCapture(bool enable, int preRollMs, int postSilenceMs) {
+    if (isRunning) {
+        LOGE("Cannot change audio capture while the detector is running");
+        return false;
+    }
+    // Allocated once, so a buffer handed out by captureRing() stays valid
+    if (enable && captureBuffer.capacity() == 0) {
+        captureBuffer.allocate(captureRingCapacity);
+    }
+    capturePreRollSamples = std::min<size_t>(std::max(preRollMs, 0) * vadSampleRate / 1000,
+                                             captureRingCapacity / 2);
+    capturePostSilenceSamples = std::max(postSilenceMs, 0) * vadSampleRate / 1000;
+    audioCaptureEnabled = enable;
+    LOGI("Audio capture %s (pre-roll %d ms, post-silence %d ms)", enable ? "enabled" : "disabled",
+         preRollMs, postSilenceMs);
+    return true;
+}
+
+void WakeupDetector::setAudioCaptureCallbacks(std::function<void(size_t, uint64_t)> started,
+                                              std::function<void(size_t, uint64_t)> ended) {
+    captureStartedCallback = std::move(started);
+    captureEndedCallback = std::move(ended);
+}
+
+// End of every processAudio() block while capture is enabled: open a session
+// the wake word thread asked for, and close it once the post-silence tail is in
+void WakeupDetector::updateCapture(bool speechEnded) {
+    const uint64_t written = captureBuffer.written();
+    const int request = captureRequest.exchange(-1);
+    if (!captureOpen && request >= 0) {
+        // Pre-roll, but not into the previous session or audio already overwritten
+        uint64_t start = written > capturePreRollSamples ? written - capturePreRollSamples : 0;
+        start = std::max({start, captureSessionEnd.load(), captureBuffer.overwriteLimit()});
+        const size_t wakeWord = static_cast<size_t>(request);
+        captureWakeWord = wakeWord;
+        captureCloseAt = UINT64_MAX;
+        captureLimit = start + maxCaptureSeconds * vadSampleRate;
+        captureSessionEnd = UINT64_MAX;
+        captureSessionStart = start;
+        LOGI("Capture session started for wake word %zu, %llu samples of pre-roll",
+             wakeWord, static_cast<unsigned long long>(written - start));
+        if (captureStartedCallback) {
+            captureStartedCallback(wakeWord, start);
+        }
+        // Published last, so a racing closeCapture() sees a complete session
+        captureOpen = true;
+    }
+    if (!captureOpen) {
         return;
     }
     
-    // Process for wake word detection
-    std::unique_lock<std::mutex> lockSamples(mutSamples);
-    
-    // Convert int16_t samples to float and add to buffer
-    for (size_t i = 0; i < numSamples; i++) {
-        floatSamples.push_back(static_cast<float>(audioData[i]));
+    if (speechEnded && captureCloseAt == UINT64_MAX) {
+        captureCloseAt = written + capturePostSilenceSamples;
     }
-    
-    samplesReady = true;
-    cvSamples.notify_one();
-    
-    // Process for VAD if enabled
-    if (vadInitialized && vadEnabled) {
-        std::unique_lock<std::mutex> lockVAD(mutVAD);
-        
-        // Convert int16_t samples to float for VAD processing
-        for (size_t i = 0; i < numSamples; i++) {
-            // Normalize to float [-1.0, 1.0] range for VAD
-            vadSamples.push_back(static_cast<float>(audioData[i]) / 32768.0f);
+    const uint64_t end = std::min(captureCloseAt, captureLimit);
+    if (written >= end) {
+        closeCapture(end);
+    } else {
+        captureSignal.notify();
+    }
+}
+
+// Called from processAudio and from stop()/pause(), which may race an
+// in-flight processAudio(); whichever claims the open session ends it
+void WakeupDetector::closeCapture(uint64_t end) {
+    if (!captureOpen.exchange(false)) {
+        return;
+    }
+    captureSessionEnd = end;
+    captureSignal.notify();
+    LOGI("Capture session ended after %.2f s",
+         static_cast<double>(end - captureSessionStart.load()) / vadSampleRate);
+    if (captureEndedCallback) {
+        captureEndedCallback(captureWakeWord.load(), end);
+    }
+}
+
+int64_t WakeupDetector::waitForCapture(uint64_t sessionStart, uint64_t position, int timeoutMs) {
+    const int64_t deadline = monotonicNanos() + static_cast<int64_t>(timeoutMs) * 1000000;
+    for (;;) {
+        const uint32_t seen = captureSignal.epoch();
+        if (captureSessionStart.load() != sessionStart) {
+            return -1;
         }
-        
-        // Handle delayed voice activity end notification
-        if (voiceEndPending.load()) {
-            voiceEndFrameCount++;
-            
-            // Check if we've reached the delay threshold (500ms)
-            if (voiceEndFrameCount >= voiceEndDelayFrames) {
-                LOGD("Voice activity ended after delay - sending notification");
-                // Reset flags
-                isVoiceDetected = false;
-                voiceEndPending = false;
-                voiceEndFrameCount = 0;
-                // Notify voice activity ended through JNI
-                notifyVoiceActivityEnded();
-            }
+        const uint64_t end = captureSessionEnd.load();
+        const uint64_t available = std::min(captureBuffer.written(), end);
+        if (available > position) {
+            return static_cast<int64_t>(available);
         }
-        
-        vadSamplesReady = true;
-        cvVAD.notify_one();
+        if (position >= end) {
+            return -1;
+        }
+        const int64_t remaining = deadline - monotonicNanos();
+        if (remaining <= 0) {
+            return static_cast<int64_t>(position);
+        }
+        captureSignal.waitFor(seen, remaining);
     }
 }
 
+// Decide whether this block reaches the wake-word chain. The gate follows the
+// VAD speech state plus a hangover; reopening replays the pre-roll first so the
+// start of the utterance is heard in order.
+bool WakeupDetector::updateGate(bool feedVAD, size_t numSamples) {
+    bool open = true;
+    if (feedVAD && vadGating) {
+        if (isVoiceDetected) {
+            gateHangoverRemaining = gateHangoverSamples;
+        } else {
+            gateHangoverRemaining -= std::min(gateHangoverRemaining, numSamples);
+        }
+        open = isVoiceDetected || gateHangoverRemaining > 0;
+    }
+    
+    if (open && !gateOpen) {
+        // Published before the replay, so the mel thread sees it with the samples
+        gateReopenSample.store(samplesWritten, std::memory_order_release);
+        const size_t replayed = replayPreRoll();
+        LOGD("Wake word gate opened, replayed %zu pre-roll samples", replayed);
+    } else if (!open && gateOpen) {
+        LOGD("Wake word gate closed");
+    }
+    gateOpen = open;
+    return open;
+}
+
+// Keep the most recent preRollSamples while the gate is closed
+void WakeupDetector::holdPreRoll(const float* samples, size_t count) {
+    if (count > preRollSamples) {
+        samples += count - preRollSamples;
+        count = preRollSamples;
+    }
+    const size_t held = preRollRing.size();
+    if (held + count > preRollSamples) {
+        preRollRing.discard(held + count - preRollSamples);
+    }
+    preRollRing.write(samples, count);
+}
+
+// Move the held pre-roll into the sample ring ahead of the live audio
+size_t WakeupDetector::replayPreRoll() {
+    size_t replayed = 0;
+    while (preRollRing.size() > 0) {
+        const size_t count = preRollRing.read(captureScratch.data(), captureScratch.size());
+        const size_t written = sampleRing.write(captureScratch.data(), count);
+        samplesWritten += written;
+        replayed += written;
+    }
+    return replayed;
+}
+
+// The snapshot only counts if no worker started or finished while it was taken
+bool WakeupDetector::isDrained() const {
+    const uint64_t transitions = stageTransitions.load();
+    if (busyStages.load() != 0) {
+        return false;
+    }
+    
+    const size_t melBlock = melFrontEnd ? chunkSamples : frameSize;
+    const bool idle = sampleRing.size() < melBlock &&
+                      melWindow.frames() < embWindowSize &&
+                      featureWindow.frames() < wwWindowFrames &&
+                      (!vadInitialized || !vadEnabled || vadRing.size() == 0);
+    return idle && stageTransitions.load() == transitions;
+}
+
 // Audio to mel spectrogram conversion thread
 void WakeupDetector::audioToMels() {
     LOGI("audioToMels thread started");
     
     try {
-        // Create ONNX Runtime session for mel spectrogram model
-        Ort::SessionOptions sessionOptions;
-        sessionOptions.SetIntraOpNumThreads(1);
-        sessionOptions.SetInterOpNumThreads(1);
-        
-        auto melSession = Ort::Session(*env, melModelPath.c_str(), sessionOptions);
-        
-        Ort::AllocatorWithDefaultOptions allocator;
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(
-            OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+        // The native front end keeps its own overlap, so it can run on every
+        // chunk; the ONNX model needs a full frameSize block per call
+        const size_t blockSize = melFrontEnd ? chunkSamples : frameSize;
         
-        auto melInputName = melSession.GetInputNameAllocated(0, allocator);
-        std::vector<const char*> melInputNames{melInputName.get()};
-        
-        auto melOutputName = melSession.GetOutputNameAllocated(0, allocator);
-        std::vector<const char*> melOutputNames{melOutputName.get()};
-        
-        std::vector<float> todoSamples;
-        std::vector<int64_t> samplesShape{1, static_cast<int64_t>(frameSize)};
-        
-        LOGI("Mel spectrogram model loaded");
+        ThreadAffinity affinity;
+        applyAffinity(affinity, scheduling.mel, false);
         
         while (isRunning) {
-            {
-                std::unique_lock<std::mutex> lockSamples(mutSamples);
-                cvSamples.wait(lockSamples, [this] { 
-                    return samplesReady || !isRunning; 
-                });
-                
-                if (!isRunning) break;
-                
-                // Copy samples to processing buffer
-                todoSamples.insert(todoSamples.end(), floatSamples.begin(), floatSamples.end());
-                floatSamples.clear();
-                samplesReady = false;
+            const uint32_t seen = samplesSignal.epoch();
+            if (parkWhilePaused(samplesSignal, seen)) continue;
+            if (sampleRing.size() < blockSize) {
+                if (isRunning) samplesSignal.wait(seen);
+                continue;
             }
             
-            // Process samples in frameSize chunks
-            while (todoSamples.size() >= frameSize && isRunning) {
-                // Generate mels for audio samples
-                std::vector<Ort::Value> melInputTensors;
-                melInputTensors.push_back(Ort::Value::CreateTensor<float>(
-                    memoryInfo, todoSamples.data(), frameSize, samplesShape.data(), 
-                    samplesShape.size()));
+            // Process samples in blockSize chunks
+            while (sampleRing.size() >= blockSize && isRunning && !paused) {
+                BusyScope busy(*this);
                 
-                auto melOutputTensors = melSession.Run(Ort::RunOptions{nullptr}, 
-                    melInputNames.data(), melInputTensors.data(), melInputNames.size(),
-                    melOutputNames.data(), melOutputNames.size());
+                // The VAD gate reopened: audio from before the silence is stale.
+                // Read after the ring size, so it covers every sample seen there.
+                const uint64_t reopen = gateReopenSample.exchange(noStageReset, std::memory_order_acq_rel);
+                if (reopen != noStageReset) {
+                    if (reopen > samplesConsumed) {
+                        samplesConsumed += sampleRing.discard(static_cast<size_t>(reopen - samplesConsumed));
+                    }
+                    if (melFrontEnd) {
+                        melFrontEnd->reset();
+                    }
+                    melResetFrame.store(melWindow.writtenFrames(), std::memory_order_release);
+                    melsSignal.notify();
+                    continue;
+                }
                 
-                const auto& melOut = melOutputTensors.front();
-                const auto melInfo = melOut.GetTensorTypeAndShapeInfo();
-                const auto melShape = melInfo.GetShape();
+                // Behind real time: skip whole blocks of the oldest audio
+                const int64_t lagNanos = samplesToNanos(sampleRing.size() - blockSize);
+                recordLag(pipelineStats.mel, lagNanos);
+                const size_t drop = static_cast<size_t>(overloadDropNanos(lagNanos) *
+                    static_cast<int64_t>(vadSampleRate) / 1000000000) / blockSize * blockSize;
+                if (drop > 0) {
+                    samplesConsumed += sampleRing.discard(drop);
+                    if (melFrontEnd) {
+                        melFrontEnd->reset();
+                    }
+                    pipelineStats.mel.droppedNanos += samplesToNanos(drop);
+                    LOGW("Mel stage %.0f ms behind, dropped %zu samples", lagNanos / 1e6, drop);
+                }
+                sampleRing.read(melInput.data(), blockSize);
                 
-                const float* melData = melOut.GetTensorData<float>();
-                size_t melCount = std::accumulate(melShape.begin(), melShape.end(), 
-                                                 1, std::multiplies<>());
+                // Arrival time of the newest sample in this block
+                samplesConsumed += blockSize;
+                while (pendingMark.endSample < samplesConsumed && sampleMarks.read(&pendingMark, 1) == 1) {
+                }
+                const int64_t originNanos = pendingMark.arrivalNanos;
                 
-                {
-                    std::unique_lock<std::mutex> lockMels(mutMels);
-                    for (size_t i = 0; i < melCount; i++) {
-                        // Scale mels for Google speech embedding model
-                        mels.push_back((melData[i] / 10.0f) + 2.0f);
+                const int64_t startNanos = monotonicNanos();
+                pipelineStats.mel.wait.record(startNanos - originNanos);
+                TRACE_SECTION("WakeupDetector::mel");
+                
+                size_t melFrames = 0;
+                size_t written = 0;
+                if (melFrontEnd) {
+                    // Frames come out already scaled for the embedding model
+                    melFrames = melFrontEnd->process(melInput.data(), blockSize);
+                    const size_t tail = melWindow.tailSlot();
+                    const int64_t readyNanos = monotonicNanos();
+                    for (size_t i = 0; i < std::min(melFrames, melWindow.freeFrames()); i++) {
+                        melOrigin[(tail + i) % melWindow.capacityFrames()] = originNanos;
+                        melReady[(tail + i) % melWindow.capacityFrames()] = readyNanos;
+                    }
+                    written = melWindow.writeFrames(melFrontEnd->frames(), melFrames);
+                } else {
+                    // melInput and melOutput are bound to the session once in initialize()
+                    melSession->Run(runOptions, *melBinding);
+                    const int64_t readyNanos = monotonicNanos();
+                    
+                    // Scale mels for Google speech embedding model straight into the mel window
+                    melFrames = melOutput.size() / numMels;
+                    for (; written < melFrames; written++) {
+                        float* frame = melWindow.frameToWrite();
+                        if (!frame) break;
+                        
+                        const float* melData = &melOutput[written * numMels];
+                        for (size_t i = 0; i < numMels; i++) {
+                            frame[i] = (melData[i] / 10.0f) + 2.0f;
+                        }
+                        melOrigin[melWindow.tailSlot()] = originNanos;
+                        melReady[melWindow.tailSlot()] = readyNanos;
+                        melWindow.commitFrame();
                     }
-                    melsReady = true;
-                    cvMels.notify_one();
                 }
+                pipelineStats.mel.compute.record(monotonicNanos() - startNanos);
                 
-                // Remove processed samples
-                todoSamples.erase(todoSamples.begin(), 
-                                 todoSamples.begin() + frameSize);
+                if (written < melFrames) {
+                    pipelineStats.embedding.droppedNanos +=
+                        static_cast<int64_t>(melFrames - written) * melFrameNanos;
+                    LOGW("Mel window full, dropping mel frames");
+                }
+                melsSignal.notify();
             }
         }
     } catch (const std::exception& e) {
-        LOGE("Error in audioToMels: %s", e.what());
+        // stop() terminates the Run in flight; that is not an error
+        if (isRunning) LOGE("Error in audioToMels: %s", e.what());
     }
+    pipelineStats.mel.cpuNanos = threadCpuNanos();
+    exitWorker();
     
     LOGI("audioToMels thread exiting");
 }
@@ -507,217 +1055,470 @@ void WakeupDetector::melsToFeatures() {
     LOGI("melsToFeatures thread started");
     
     try {
-        // Create ONNX Runtime session for embedding model
-        Ort::SessionOptions sessionOptions;
-        sessionOptions.SetIntraOpNumThreads(1);
-        sessionOptions.SetInterOpNumThreads(1);
-        
-        auto embSession = Ort::Session(*env, embModelPath.c_str(), sessionOptions);
-        
-        Ort::AllocatorWithDefaultOptions allocator;
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(
-            OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-        
-        auto embInputName = embSession.GetInputNameAllocated(0, allocator);
-        std::vector<const char*> embInputNames{embInputName.get()};
-        
-        auto embOutputName = embSession.GetOutputNameAllocated(0, allocator);
-        std::vector<const char*> embOutputNames{embOutputName.get()};
-        
-        std::vector<float> todoMels;
-        size_t melFrames = 0;
-        std::vector<int64_t> embShape{1, static_cast<int64_t>(embWindowSize), 
-                                     static_cast<int64_t>(numMels), 1};
-        
-        LOGI("Embedding model loaded");
-        
+        ThreadAffinity affinity;
         while (isRunning) {
-            {
-                std::unique_lock<std::mutex> lockMels(mutMels);
-                cvMels.wait(lockMels, [this] { 
-                    return melsReady || !isRunning; 
-                });
-                
-                if (!isRunning) break;
-                
-                // Copy mels to processing buffer
-                todoMels.insert(todoMels.end(), mels.begin(), mels.end());
-                mels.clear();
-                melsReady = false;
+            const uint32_t seen = melsSignal.epoch();
+            if (parkWhilePaused(melsSignal, seen)) continue;
+            // The embedding at the last step of the stride needs all of its mels
+            size_t stride = embeddingStride();
+            if (melWindow.frames() < embWindowSize + (stride - 1) * embStepSize) {
+                if (isRunning) melsSignal.wait(seen);
+                continue;
             }
             
-            melFrames = todoMels.size() / numMels;
-            while (melFrames >= embWindowSize && isRunning) {
-                // Generate embeddings for mels
-                std::vector<Ort::Value> embInputTensors;
-                embInputTensors.push_back(Ort::Value::CreateTensor<float>(
-                    memoryInfo, todoMels.data(), embWindowSize * numMels, 
-                    embShape.data(), embShape.size()));
+            while (melWindow.frames() >= embWindowSize + (stride - 1) * embStepSize &&
+                   isRunning && !paused) {
+                BusyScope busy(*this);
+                applyAffinity(affinity, scheduling.embedding, true);
+                
+                // Mels from before the gate reopened never share a window with the pre-roll
+                const uint64_t melReset = melResetFrame.exchange(noStageReset, std::memory_order_acq_rel);
+                if (melReset != noStageReset) {
+                    if (melReset > melWindow.readFrames()) {
+                        melWindow.advance(static_cast<size_t>(melReset - melWindow.readFrames()));
+                    }
+                    haveLastEmbedding = false;
+                    featureResetFrame.store(featureWindow.writtenFrames(), std::memory_order_release);
+                    featuresSignal.notify();
+                    stride = embeddingStride();
+                    continue;
+                }
+                
+                // Behind real time: skip whole steps of the oldest mels, or under
+                // Degrade fall back to the idle stride until the lag halves
+                const size_t needed = embWindowSize + (stride - 1) * embStepSize;
+                const int64_t lagNanos = static_cast<int64_t>(melWindow.frames() - needed) * melFrameNanos;
+                recordLag(pipelineStats.embedding, lagNanos);
+                const size_t drop = static_cast<size_t>(overloadDropNanos(lagNanos) / melFrameNanos) /
+                                    embStepSize * embStepSize;
+                if (drop > 0) {
+                    melWindow.advance(drop);
+                    haveLastEmbedding = false;  // nothing to interpolate from across the gap
+                    pipelineStats.embedding.droppedNanos += static_cast<int64_t>(drop) * melFrameNanos;
+                    LOGW("Embedding stage %.0f ms behind, dropped %zu mel frames", lagNanos / 1e6, drop);
+                }
+                if (queues.policy == OverloadPolicy::Degrade) {
+                    if (overloaded(lagNanos)) {
+                        embeddingDegraded = true;
+                    } else if (!overloaded(2 * lagNanos)) {
+                        embeddingDegraded = false;
+                    }
+                }
                 
-                auto embOutputTensors = embSession.Run(Ort::RunOptions{nullptr}, 
-                    embInputNames.data(), embInputTensors.data(), embInputTensors.size(),
-                    embOutputNames.data(), embOutputNames.size());
+                // Skipped steps are interpolated once the embedding after them exists
+                melWindow.advance((stride - 1) * embStepSize);
                 
-                const auto& embOut = embOutputTensors.front();
-                const auto embOutInfo = embOut.GetTensorTypeAndShapeInfo();
-                const auto embOutShape = embOutInfo.GetShape();
+                // The newest mel frame in the window carries the timing forward
+                const size_t newest = (melWindow.headSlot() + embWindowSize - 1) % melWindow.capacityFrames();
+                const int64_t originNanos = melOrigin[newest];
                 
-                const float* embOutData = embOut.GetTensorData<float>();
-                size_t embOutCount = std::accumulate(embOutShape.begin(), embOutShape.end(), 
-                                                    1, std::multiplies<>());
+                // Read the mel window in place through the view for its head slot
+                embBinding->BindInput(embInputName.c_str(), embInputViews[melWindow.headSlot()]);
                 
-                // Send to each wake word model
-                for (size_t i = 0; i < features.size() && isRunning; i++) {
-                    std::unique_lock<std::mutex> lockFeatures(mutFeatures[i]);
-                    std::copy(embOutData, embOutData + embOutCount, 
-                            std::back_inserter(features[i]));
-                    featuresReady[i] = true;
-                    cvFeatures[i].notify_one();
+                // At full rate the embedding goes straight into the next feature window slot
+                const bool direct = stride == 1 && featureWindow.frameToWrite() != nullptr;
+                embBinding->BindOutput(embOutputName.c_str(),
+                    direct ? embOutputViews[featureWindow.tailSlot()] : embScratchView);
+                
+                const int64_t startNanos = monotonicNanos();
+                pipelineStats.embedding.wait.record(startNanos - melReady[newest]);
+                {
+                    TRACE_SECTION("WakeupDetector::embedding");
+                    const bool shrink = arenaShrinkPending.load(std::memory_order_relaxed) &&
+                                        arenaShrinkPending.exchange(false);
+                    embSession->Run(shrink ? arenaShrinkOptions : runOptions, *embBinding);
                 }
+                const int64_t readyNanos = monotonicNanos();
+                pipelineStats.embedding.compute.record(readyNanos - startNanos);
                 
-                // Erase a step's worth of mels
-                todoMels.erase(todoMels.begin(),
-                              todoMels.begin() + (embStepSize * numMels));
+                // Publish once; every wake word head reads the same feature window
+                if (direct) {
+                    if (adaptiveStride || queues.policy == OverloadPolicy::Degrade) {
+                        std::memcpy(lastEmbedding.data(), featureWindow.frameToWrite(),
+                                    embFeatures * sizeof(float));
+                        haveLastEmbedding = true;
+                    }
+                    featureOrigin[featureWindow.tailSlot()] = originNanos;
+                    featureReady[featureWindow.tailSlot()] = readyNanos;
+                    featureWindow.commitFrame();
+                } else {
+                    writeStridedFeatures(stride, originNanos, readyNanos);
+                }
+                featuresSignal.notify();
                 
-                melFrames = todoMels.size() / numMels;
+                // Slide forward by a step's worth of mels
+                melWindow.advance(embStepSize);
+                stride = embeddingStride();
             }
         }
     } catch (const std::exception& e) {
-        LOGE("Error in melsToFeatures: %s", e.what());
+        // stop() terminates the Run in flight; that is not an error
+        if (isRunning) LOGE("Error in melsToFeatures: %s", e.what());
     }
+    pipelineStats.embedding.cpuNanos = threadCpuNanos();
+    exitWorker();
     
     LOGI("melsToFeatures thread exiting");
 }
 
-// Features to wake word detection thread
-void WakeupDetector::featuresToOutput(size_t wwIdx) {
-    if (wwIdx >= wwModelPaths.size()) {
-        LOGE("Invalid wake word model index: %zu", wwIdx);
-        return;
+// Stride in embStepSize steps for the next embedding: the idle stride only
+// while nothing suggests a wake word may be starting, or while Degrade sheds load
+size_t WakeupDetector::embeddingStride() const {
+    if (embeddingDegraded && haveLastEmbedding) {
+        return idleStrideSteps;
     }
-    
-    LOGI("featuresToOutput thread %zu started", wwIdx);
+    if (!adaptiveStride || !haveLastEmbedding || isVoiceDetected ||
+        monotonicNanos() < fullRateUntilNanos.load(std::memory_order_relaxed)) {
+        return 1;
+    }
+    return idleStrideSteps;
+}
+
+void WakeupDetector::requestFullRate() {
+    fullRateUntilNanos.store(monotonicNanos() + fullRateHoldNanos, std::memory_order_relaxed);
+}
+
+// Write the `steps` feature frames ending at the embedding in embScratch. The
+// steps before it are interpolated from the previous embedding, so the wake
+// word window keeps one frame per embStepSize whatever the stride.
+void WakeupDetector::writeStridedFeatures(size_t steps, int64_t originNanos, int64_t readyNanos) {
+    for (size_t step = 1; step <= steps; step++) {
+        float* frame = featureWindow.frameToWrite();
+        if (!frame) {
+            pipelineStats.wakeWord.droppedNanos +=
+                static_cast<int64_t>(steps - step + 1) * featureFrameNanos;
+            LOGW("Feature window full, dropping embedding");
+            break;
+        }
+        if (step == steps || !haveLastEmbedding) {
+            std::memcpy(frame, embScratch.data(), embFeatures * sizeof(float));
+        } else {
+            const float t = static_cast<float>(step) / static_cast<float>(steps);
+            for (size_t k = 0; k < embFeatures; k++) {
+                frame[k] = lastEmbedding[k] + t * (embScratch[k] - lastEmbedding[k]);
+            }
+        }
+        featureOrigin[featureWindow.tailSlot()] = originNanos;
+        featureReady[featureWindow.tailSlot()] = readyNanos;
+        featureWindow.commitFrame();
+    }
+    if (steps > 1) {
+        pipelineStats.embeddingsInterpolated += steps - 1;
+    }
+    lastEmbedding = embScratch;
+    haveLastEmbedding = true;
+}
+
+// Features to wake word detection thread; runs every wake word head
+void WakeupDetector::featuresToOutput() {
+    LOGI("featuresToOutput thread started");
     
     try {
-        // Create ONNX Runtime session for wake word model
-        Ort::SessionOptions sessionOptions;
-        sessionOptions.SetIntraOpNumThreads(1);
-        sessionOptions.SetInterOpNumThreads(1);
-        
-        auto wwModelPath = wwModelPaths[wwIdx];
-        
-        // Extract wake word name from filename
-        std::string wwName = std::filesystem::path(wwModelPath).stem().string();
-        
-        auto wwSession = Ort::Session(*env, wwModelPath.c_str(), sessionOptions);
-        
-        Ort::AllocatorWithDefaultOptions allocator;
-        auto memoryInfo = Ort::MemoryInfo::CreateCpu(
-            OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-        
-        auto wwInputName = wwSession.GetInputNameAllocated(0, allocator);
-        std::vector<const char*> wwInputNames{wwInputName.get()};
-        
-        auto wwOutputName = wwSession.GetOutputNameAllocated(0, allocator);
-        std::vector<const char*> wwOutputNames{wwOutputName.get()};
-        
-        std::vector<float> todoFeatures;
-        size_t numBufferedFeatures = 0;
-        int activation = 0;
-        std::vector<int64_t> wwShape{1, static_cast<int64_t>(wwFeatures), 
-                                    static_cast<int64_t>(embFeatures)};
-        
-        LOGI("Wake word model %s loaded", wwName.c_str());
-        
         // For logging scores
         int logCounter = 0;
         const int logFrequency = 20; // Log every 20th score to avoid flooding logs
+        ThreadAffinity affinity;
+        bool shedLowPriority = false;  // Degrade, until the lag halves
         
         while (isRunning) {
-            {
-                std::unique_lock<std::mutex> lockFeatures(mutFeatures[wwIdx]);
-                cvFeatures[wwIdx].wait(lockFeatures, [this, wwIdx] { 
-                    return featuresReady[wwIdx] || !isRunning; 
-                });
-                
-                if (!isRunning) break;
-                
-                // Copy features to processing buffer
-                todoFeatures.insert(todoFeatures.end(), features[wwIdx].begin(), 
-                                    features[wwIdx].end());
-                features[wwIdx].clear();
-                featuresReady[wwIdx] = false;
+            const uint32_t seen = featuresSignal.epoch();
+            if (parkWhilePaused(featuresSignal, seen)) continue;
+            if (featureWindow.frames() < wwWindowFrames) {
+                if (isRunning) featuresSignal.wait(seen);
+                continue;
             }
             
-            numBufferedFeatures = todoFeatures.size() / embFeatures;
-            while (numBufferedFeatures >= wwFeatures && isRunning) {
-                std::vector<Ort::Value> wwInputTensors;
-                wwInputTensors.push_back(Ort::Value::CreateTensor<float>(
-                    memoryInfo, todoFeatures.data(), wwFeatures * embFeatures,
-                    wwShape.data(), wwShape.size()));
+            while (isRunning && !paused) {
+                // The keyword set for this frame; a table published meanwhile is
+                // picked up at the next one
+                TableReadScope reader(*this);
+                const WakeWordTable& table = *reader.table;
+                const size_t windowFrames = table.windowFrames;
+                if (featureWindow.frames() < windowFrames) break;
+                BusyScope busy(*this);
+                applyAffinity(affinity, scheduling.wakeWord, true);
                 
-                auto wwOutputTensors = wwSession.Run(Ort::RunOptions{nullptr}, 
-                    wwInputNames.data(), wwInputTensors.data(), 1, 
-                    wwOutputNames.data(), 1);
-                
-                const auto& wwOut = wwOutputTensors.front();
-                const auto wwOutInfo = wwOut.GetTensorTypeAndShapeInfo();
-                const auto wwOutShape = wwOutInfo.GetShape();
-                const float* wwOutData = wwOut.GetTensorData<float>();
-                size_t wwOutCount = std::accumulate(wwOutShape.begin(), wwOutShape.end(), 
-                                                   1, std::multiplies<>());
+                // Embeddings from before the gate reopened, and the activations
+                // they built, do not carry over into the onset
+                const uint64_t featureReset =
+                    featureResetFrame.exchange(noStageReset, std::memory_order_acq_rel);
+                if (featureReset != noStageReset) {
+                    if (featureReset > featureWindow.readFrames()) {
+                        featureWindow.advance(static_cast<size_t>(featureReset - featureWindow.readFrames()));
+                    }
+                    for (const auto& head : table.heads) {
+                        if (!head) continue;
+                        head->activation = 0;
+                        head->cascadeHold = 0;
+                    }
+                    continue;
+                }
                 
-                for (size_t i = 0; i < wwOutCount; i++) {
-                    auto probability = wwOutData[i];
-                    
-                    // Log detection score periodically or if it's close to threshold
-                    logCounter++;
-                    if (logCounter % logFrequency == 0 || probability > threshold * 0.7) {
-                        LOGD("[%s] Detection score: %.4f (threshold: %.2f, activation: %d/%d)", 
-                            wwName.c_str(), probability, threshold, activation, triggerLevel);
+                // Behind real time: skip the oldest windows, or under Degrade stop
+                // running low-priority wake words until the lag halves
+                const int64_t lagNanos =
+                    static_cast<int64_t>(featureWindow.frames() - windowFrames) * featureFrameNanos;
+                recordLag(pipelineStats.wakeWord, lagNanos);
+                const size_t drop = static_cast<size_t>(overloadDropNanos(lagNanos) / featureFrameNanos);
+                if (drop > 0) {
+                    featureWindow.advance(drop);
+                    pipelineStats.wakeWord.droppedNanos += static_cast<int64_t>(drop) * featureFrameNanos;
+                    LOGW("Wake word stage %.0f ms behind, dropped %zu embeddings", lagNanos / 1e6, drop);
+                }
+                if (queues.policy == OverloadPolicy::Degrade) {
+                    if (overloaded(lagNanos)) {
+                        shedLowPriority = true;
+                    } else if (!overloaded(2 * lagNanos)) {
+                        shedLowPriority = false;
                     }
-                    
-                    if (probability > threshold) {
-                        // Activated
-                        activation++;
-                        LOGI("[%s] Score %.4f exceeded threshold (%.2f), activation %d/%d", 
-                             wwName.c_str(), probability, threshold, activation, triggerLevel);
+                }
+                
+                // The newest embedding in the window carries the timing forward
+                const size_t newest = (featureWindow.headSlot() + windowFrames - 1) % featureWindow.capacityFrames();
+                const int64_t originNanos = featureOrigin[newest];
+                const int64_t startNanos = monotonicNanos();
+                pipelineStats.wakeWord.wait.record(startNanos - featureReady[newest]);
+                
+                // Views over the shared window, each head bound to its newest
+                // head.frames embeddings; scores land in preallocated output buffers
+                const size_t windowSlot = featureWindow.headSlot() + windowFrames;
+                
+                logCounter++;
+                {
+                    TRACE_SECTION("WakeupDetector::wakeWord");
+                    for (const auto& slot : table.heads) {
+                        if (!slot) continue;
+                        WakeWordHead& head = *slot;
+                        if (shedLowPriority && head.lowPriority) {
+                            std::fill(head.scores.begin(), head.scores.end(), 0.0f);
+                            head.evaluated = false;
+                            pipelineStats.overloadSkips++;
+                            continue;
+                        }
+                        const Ort::Value& wwInput =
+                            (*head.inputViews)[(windowSlot - head.frames) % featureWindow.capacityFrames()];
                         
-                        if (activation >= triggerLevel) {
-                            // Trigger level reached
-                            LOGI("Wake word detected: %s (score: %.4f)", wwName.c_str(), probability);
-                            
-                            if (wakeWordCallback) {
-                                wakeWordCallback(wwName);
+                        // In cascade mode the first stage decides whether the full model runs
+                        if (head.firstStage) {
+                            head.firstStageBinding->BindInput(head.firstStageInputName.c_str(), wwInput);
+                            head.firstStage->Run(runOptions, *head.firstStageBinding);
+                            if (*std::max_element(head.firstStageScores.begin(),
+                                                  head.firstStageScores.end()) > cascadeThreshold) {
+                                head.cascadeHold = cascadeHoldFrames;
                             }
-                            
-                            activation = -refractory;
                         }
-                    } else {
-                        // Back towards 0
-                        if (activation > 0) {
-                            activation = std::max(0, activation - 1);
-                            if (logCounter % logFrequency == 0) {
-                                LOGD("[%s] Activation decaying: %d", wwName.c_str(), activation);
-                            }
-                        } else {
-                            activation = std::min(0, activation + 1);
+                        head.evaluated = !head.firstStage || head.cascadeHold > 0 || head.activation > 0;
+                        if (head.cascadeHold > 0) {
+                            head.cascadeHold--;
+                        }
+                        if (!head.evaluated) {
+                            std::fill(head.scores.begin(), head.scores.end(), 0.0f);
+                            pipelineStats.wakeWordSkips++;
+                            continue;
                         }
+                        head.binding->BindInput(head.inputName.c_str(), wwInput);
+                        head.session->Run(runOptions, *head.binding);
+                        pipelineStats.wakeWordRuns++;
                     }
                 }
+                const int64_t scoredNanos = monotonicNanos();
+                pipelineStats.wakeWord.compute.record(scoredNanos - startNanos);
+                pipelineStats.endToEnd.record(scoredNanos - originNanos);
                 
-                // Remove 1 embedding
-                todoFeatures.erase(todoFeatures.begin(),
-                                  todoFeatures.begin() + (1 * embFeatures));
+                // Anything close to a detection keeps the embeddings at full rate
+                const float fullRateScore = threshold * strideScoreFraction.load();
+                const bool telemetry = scoreTelemetryEnabled;
+                bool wantFullRate = false;
+                frameScores.clear();
+                if (telemetry && frameScores.capacity() < table.outputs) {
+                    frameScores.reserve(table.outputs);  // once per larger keyword set
+                }
+                for (size_t i = 0; i < table.heads.size(); i++) {
+                    if (!table.heads[i]) continue;
+                    WakeWordHead& head = *table.heads[i];
+                    wantFullRate |= head.firstStage && head.cascadeHold > 0;
+                    for (float probability : head.scores) {
+                        wantFullRate |= probability > fullRateScore;
+                        if (scoreCallback) {
+                            scoreCallback(i, probability);
+                        }
+                        updateActivation(head, probability, logCounter % logFrequency == 0,
+                                         originNanos);
+                        if (telemetry) {
+                            frameScores.push_back({originNanos, probability, static_cast<uint16_t>(i),
+                                                   static_cast<int16_t>(head.activation)});
+                        }
+                    }
+                }
+                // One publish per frame, whatever the number of heads
+                scoreBuffer.write(frameScores.data(), frameScores.size());
+                if (wantFullRate && adaptiveStride) {
+                    requestFullRate();
+                }
                 
-                numBufferedFeatures = todoFeatures.size() / embFeatures;
+                // Slide forward by 1 embedding
+                featureWindow.advance(1);
             }
         }
     } catch (const std::exception& e) {
-        LOGE("Error in featuresToOutput (%zu): %s", wwIdx, e.what());
+        // stop() terminates the Run in flight; that is not an error
+        if (isRunning) LOGE("Error in featuresToOutput: %s", e.what());
     }
+    pipelineStats.wakeWord.cpuNanos = threadCpuNanos();
+    exitWorker();
     
-    LOGI("featuresToOutput thread %zu exiting", wwIdx);
+    LOGI("featuresToOutput thread exiting");
+}
+
+// Per-keyword activation/refractory logic for one wake word score
+void WakeupDetector::updateActivation(WakeWordHead& head, float probability, bool logThisFrame,
+                                      int64_t originNanos) {
+    int& activation = head.activation;
+    const char* wwName = head.name.c_str();
+    
+    // Log detection score periodically or if it's close to threshold
+    if (logThisFrame || probability > threshold * 0.7) {
+        LOGD("[%s] Detection score: %.4f (threshold: %.2f, activation: %d/%d)", 
+            wwName, probability, threshold, activation, triggerLevel);
+    }
+    
+    if (probability > threshold) {
+        // Activated; let confirmation run on fast cores
+        activation++;
+        requestBurst();
+        LOGD("[%s] Score %.4f exceeded threshold (%.2f), activation %d/%d", 
+             wwName, probability, threshold, activation, triggerLevel);
+        
+        if (activation >= triggerLevel) {
+            // Trigger level reached
+            LOGI("Wake word detected: %s (score: %.4f)", wwName, probability);
+            
+            pipelineStats.detection.record(monotonicNanos() - originNanos);
+            pipelineStats.detections++;
+            if (audioCaptureEnabled) {
+                captureRequest = static_cast<int>(head.index);
+            }
+            if (wakeWordCallback) {
+                wakeWordCallback(head.index, head.name);
+            }
+            
+            activation = -refractory;
+        }
+    } else {
+        // Back towards 0
+        if (activation > 0) {
+            activation = std::max(0, activation - 1);
+            if (logThisFrame) {
+                LOGD("[%s] Activation decaying: %d", wwName, activation);
+            }
+        } else {
+            activation = std::min(0, activation + 1);
+        }
+    }
+}
+
+bool WakeupDetector::setSchedulingConfig(const SchedulingConfig& config) {
+    if (isRunning) {
+        LOGE("Cannot change the scheduling policy while the detector is running");
+        return false;
+    }
+    scheduling = config;
+    LOGI("Scheduling: mel %s, embedding %s, wake word %s, VAD %s, burst %s for %d ms%s",
+         coreClassName(config.mel), coreClassName(config.embedding),
+         coreClassName(config.wakeWord), coreClassName(config.vad),
+         coreClassName(config.burst), config.burstHoldMs, config.pinThreads ? "" : " (pinning off)");
+    return true;
+}
+
+void WakeupDetector::requestBurst() {
+    burstUntilNanos.store(monotonicNanos() + static_cast<int64_t>(scheduling.burstHoldMs) * 1000000,
+                          std::memory_order_relaxed);
+}
+
+// Called by a worker between inferences; only changes of class reach the kernel
+void WakeupDetector::applyAffinity(ThreadAffinity& affinity, CoreClass steady, bool burstable) const {
+    if (!scheduling.pinThreads) return;
+    const bool burst = burstable &&
+        monotonicNanos() < burstUntilNanos.load(std::memory_order_relaxed);
+    affinity.apply(burst ? scheduling.burst : steady);
+}
+
+bool WakeupDetector::setQueueConfig(const QueueConfig& config) {
+    if (isRunning) {
+        LOGE("Cannot change the queue configuration while the detector is running");
+        return false;
+    }
+    queues = config;
+    queues.maxLagMs = std::max(config.maxLagMs, 0);
+    LOGI("Queues: samples %d ms, VAD %d ms, mels %d ms, features %d ms, overload policy %d "
+         "beyond %d ms", config.sampleQueueMs, config.vadQueueMs, config.melQueueMs,
+         config.featureQueueMs, static_cast<int>(config.policy), queues.maxLagMs);
+    return true;
+}
+
+bool WakeupDetector::setWakeWordPriority(size_t wakeWord, bool high) {
+    const auto table = loadedTable();
+    if (!table || wakeWord >= table->heads.size() || !table->heads[wakeWord]) {
+        LOGE("No wake word %zu to change the priority of", wakeWord);
+        return false;
+    }
+    WakeWordHead& head = *table->heads[wakeWord];
+    head.lowPriority = !high;
+    LOGI("Wake word %s has %s priority", head.name.c_str(), high ? "high" : "low");
+    return true;
+}
+
+// Lag a stage drops before its next inference under the overload policy; every
+// caller rounds it down to whole units of its queue
+int64_t WakeupDetector::overloadDropNanos(int64_t lagNanos) const {
+    const int64_t maxLagNanos = static_cast<int64_t>(queues.maxLagMs) * 1000000;
+    switch (queues.policy) {
+        case OverloadPolicy::DropOldest:
+            return lagNanos > maxLagNanos ? lagNanos - maxLagNanos : 0;
+        case OverloadPolicy::SkipToLive:
+            return lagNanos > maxLagNanos ? lagNanos : 0;
+        case OverloadPolicy::Degrade:
+            return lagNanos > 2 * maxLagNanos ? lagNanos - maxLagNanos : 0;
+        case OverloadPolicy::DropNewest:
+        default:
+            return 0;
+    }
+}
+
+void WakeupDetector::recordLag(StageStats& stage, int64_t lagNanos) {
+    stage.lag.record(lagNanos);
+    stage.lagNanos.store(lagNanos, std::memory_order_relaxed);
+}
+
+void WakeupDetector::setScoreCallback(std::function<void(size_t, float)> callback) {
+    scoreCallback = std::move(callback);
+}
+
+bool WakeupDetector::setScoreTelemetry(bool enable) {
+    if (isRunning) {
+        LOGE("Cannot change score telemetry while the detector is running");
+        return false;
+    }
+    // Allocated once, so a buffer handed out by scoreRing() stays valid
+    if (enable && scoreBuffer.capacity() == 0) {
+        scoreBuffer.allocate(scoreRingCapacity);
+    }
+    scoreTelemetryEnabled = enable;
+    LOGI("Score telemetry %s", enable ? "enabled" : "disabled");
+    return true;
+}
+
+std::vector<std::string> WakeupDetector::wakeWordNames() const {
+    std::vector<std::string> names;
+    const auto table = loadedTable();
+    if (!table) {
+        return names;
+    }
+    names.reserve(table->heads.size());
+    for (const auto& head : table->heads) {
+        names.push_back(head ? head->name : std::string());
+    }
+    return names;
 }
 
 // VAD processing thread
@@ -726,121 +1527,104 @@ void WakeupDetector::vadProcessing() {
     
     if (!vadIterator) {
         LOGE("VAD processor not initialized");
+        exitWorker();
         return;
     }
     
-    // Process audio in chunks
-    std::vector<float> audioChunk;
-    const size_t chunkSize = 512; // 32ms at 16kHz (same as vadIterator window size)
+    // Whatever the ring holds is streamed into the iterator, which runs a window
+    // every 512 samples and carries any partial window over to the next read
+    std::array<float, vadReadBlock> block;
     
     try {
+        ThreadAffinity affinity;
+        applyAffinity(affinity, scheduling.vad, false);
+        
         while (isRunning) {
-            {
-                std::unique_lock<std::mutex> lockVAD(mutVAD);
-                cvVAD.wait(lockVAD, [this] { 
-                    return vadSamplesReady || !isRunning; 
-                });
-                
-                if (!isRunning) break;
-                
-                // Copy samples to processing buffer
-                audioChunk = vadSamples;
-                vadSamples.clear();
-                vadSamplesReady = false;
+            const uint32_t seen = vadSignal.epoch();
+            if (parkWhilePaused(vadSignal, seen)) continue;
+            
+            // enableVAD() asks us to drop stale audio; only this thread may consume the ring
+            if (vadResetPending.exchange(false)) {
+                vadRing.discard(vadRing.size());
+                vadIterator->reset();
+                resetEndpointer();
+            }
+            
+            if (vadRing.size() == 0) {
+                if (isRunning) vadSignal.wait(seen);
+                continue;
             }
             
-            if (audioChunk.size() >= chunkSize) {
-                // Process each chunk
-                for (size_t offset = 0; offset + chunkSize <= audioChunk.size() && isRunning; offset += chunkSize) {
-                    std::vector<float> chunk(audioChunk.begin() + offset, audioChunk.begin() + offset + chunkSize);
-                    vadIterator->predict(chunk);
+            while (vadRing.size() > 0 && isRunning && !paused) {
+                BusyScope busy(*this);
+                
+                // Behind real time: skip the oldest audio; the iterator carries on
+                // from its state as after a short gap
+                const int64_t lagNanos = samplesToNanos(vadRing.size() - std::min(vadRing.size(), block.size()));
+                recordLag(pipelineStats.vad, lagNanos);
+                const size_t drop = static_cast<size_t>(overloadDropNanos(lagNanos) *
+                    static_cast<int64_t>(vadSampleRate) / 1000000000);
+                if (drop > 0) {
+                    vadRing.discard(drop);
+                    vadSampleClock += drop;  // positions stay those of the input
+                    pipelineStats.vad.droppedNanos += samplesToNanos(drop);
+                    LOGW("VAD %.0f ms behind, dropped %zu samples", lagNanos / 1e6, drop);
+                }
+                const size_t count = vadRing.read(block.data(), block.size());
+                
+                const int64_t startNanos = monotonicNanos();
+                {
+                    TRACE_SECTION("WakeupDetector::vad");
+                    vadIterator->feed(block.data(), count);
                 }
+                pipelineStats.vad.compute.record(monotonicNanos() - startNanos);
             }
         }
     } catch (const std::exception& e) {
-        LOGE("Error in VAD processing: %s", e.what());
+        if (isRunning) LOGE("Error in VAD processing: %s", e.what());
     }
+    pipelineStats.vad.cpuNanos = threadCpuNanos();
+    exitWorker();
     
     LOGI("VAD processing thread exiting");
 }
 
 
 
-// Notify that voice activity has started
-void notifyVoiceActivityStarted() {
-    JNIEnv* env;
-    bool detach = false;
-    int getEnvStat = javaVM->GetEnv((void**)&env, JNI_VERSION_1_6);
-    
-    if (getEnvStat == JNI_EDETACHED) {
-        javaVM->AttachCurrentThread(&env, nullptr);
-        detach = true;
-    }
-    
-    if (env && wakeupDetectorCallback && onVoiceActivityStartedMethod) {
-        jobject callback = env->NewLocalRef(wakeupDetectorCallback);
-        if (callback) {
-            env->CallVoidMethod(callback, onVoiceActivityStartedMethod);
-            env->DeleteLocalRef(callback);
-            
-            if (env->ExceptionCheck()) {
-                env->ExceptionDescribe();
-                env->ExceptionClear();
-            }
-        }
-    }
-    
-    if (detach) {
-        javaVM->DetachCurrentThread();
-    }
-}
-
-
 // Initialize VAD with model path
 bool WakeupDetector::initializeVAD(const std::string& vadModelPath) {
-    LOGI("Initializing VAD with model: %s", vadModelPath.c_str());
+    LOGI("Initializing VAD with model: %s (%s)", vadModelPath.c_str(),
+         executionProviderName(stageProviders.vad));
     
     this->vadModelPath = vadModelPath;
     
     try {
+        vadRing.allocate(std::max<size_t>(
+            static_cast<size_t>(lowMemory ? 0 : std::max(queues.vadQueueMs, 0)) * vadSampleRate / 1000,
+            vadReadBlock));
+        
         // Create VAD Iterator
         vadIterator = std::make_unique<VadIterator>(
             vadModelPath,               // Model path
             vadSampleRate,              // Sample rate (16kHz)
-            32,                         // Window size in ms (512 samples)
+            static_cast<int>(Geometry::vadWindowSamples * 1000 / Geometry::sampleRate),  // 32 ms window
             vadThreshold,               // Threshold (0.5)
             100,                        // Min silence duration ms
             30,                         // Speech padding ms
             250,                        // Min speech duration ms
-            30.0f                       // Max speech duration seconds
+            30.0f,                      // Max speech duration seconds
+            stageProviders.vad          // Execution provider
         );
         
-        // Setup VAD callback with 0.5 second delay for voice end detection
-        vadIterator->set_callback([this](bool isSpeaking) {
-            // Update the voice detection state
-            bool previousState = previousVoiceState.exchange(isVoiceDetected);
-            
-            if (isSpeaking) {
-                // If state changed to speaking
-                if (!previousState) {
-                    LOGD("Voice activity started");
-                    isVoiceDetected = true;
-                    // Cancel any pending voice end notification
-                    voiceEndPending = false;
-                    voiceEndFrameCount = 0;
-                    // Notify voice activity started through JNI
-                    notifyVoiceActivityStarted();
-                }
-            } else {
-                // If we were speaking but now we're not, start the delay
-                if (isVoiceDetected) {
-                    // Don't immediately mark as not speaking, instead flag for delayed notification
-                    voiceEndPending = true;
-                    voiceEndFrameCount = 0;
-                    LOGD("Voice activity potentially ending - starting delay");
-                }
-            }
+        vadIterator->warmup();
+        vadIterator->set_run_options(&runOptions);
+        
+        // Every window's probability drives the endpointer on this clock
+        vadIterator->set_probability_callback([this](float probability) {
+            onVadWindow(probability);
         });
+        endpointer.configure(endpointing, vadSampleRate);
+        resetEndpointer();
         
         vadInitialized = true;
         LOGI("VAD initialized successfully");
@@ -860,42 +1644,25 @@ bool WakeupDetector::enableVAD(bool enable) {
     
     LOGI("Setting VAD enabled: %s", enable ? "true" : "false");
     
-    // If we're enabling VAD, make sure states are reset
-    if (enable) {
-        // Reset VAD iterator's internal state for a fresh start
+    // Reset states related to voice activity
+    {
+        std::unique_lock<std::mutex> lockVAD(mutVAD);
+        isVoiceDetected = false;
+        speechEndPending = false;
+    }
+    
+    // Drop buffered VAD samples and reset the iterator for a fresh start. While
+    // running, the VAD thread owns the ring and the iterator, so it does the reset.
+    if (isRunning) {
+        vadResetPending = true;
+        vadSignal.notify();
+    } else {
+        vadRing.clear();
         if (vadIterator) {
             vadIterator->reset();
-            LOGI("VAD state reset");
-        }
-
-        // Reset VAD states
-        isVoiceDetected = false;
-        previousVoiceState = false;
-        voiceEndPending = false;
-        voiceEndFrameCount = 0;
-        
-        // Clear VAD samples buffer
-        {
-            std::unique_lock<std::mutex> lockVAD(mutVAD);
-            vadSamples.clear();
-            vadSamplesReady = false;
-        }
-    } 
-    // If we're disabling VAD
-    else {
-        // Reset states related to voice activity
-        isVoiceDetected = false;
-        previousVoiceState = false;
-        voiceEndPending = false;
-        voiceEndFrameCount = 0;
-        
-        // Clear VAD samples buffer
-        {
-            std::unique_lock<std::mutex> lockVAD(mutVAD);
-            vadSamples.clear();
-            vadSamplesReady = false;
         }
     }
+    LOGI("VAD state reset");
     
     // Set the enabled state after all cleanup
     vadEnabled = enable;
@@ -903,172 +1670,101 @@ bool WakeupDetector::enableVAD(bool enable) {
     return true;
 }
 
-// JNI implementation
-extern "C" {
-
-JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
-    javaVM = vm;
-    JNIEnv* env;
-    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
-        return JNI_ERR;
-    }
-    
-    // Get the WakeupDetectorCallback class
-    jclass callbackClass = env->FindClass("com/vinhpx/voiceassistant/WakeupDetectorCallback");
-    if (callbackClass == nullptr) {
-        LOGE("Failed to find WakeupDetectorCallback class");
-        return JNI_ERR;
-    }
-    
-    // Get the onWakeWordDetected method ID
-    onWakeWordDetectedMethod = env->GetMethodID(callbackClass, "onWakeWordDetected", "(Ljava/lang/String;)V");
-    if (onWakeWordDetectedMethod == nullptr) {
-        LOGE("Failed to find onWakeWordDetected method");
-        return JNI_ERR;
-    }
-    
-    // Get the onDetectionScoreUpdate method ID
-    onDetectionScoreUpdateMethod = env->GetMethodID(callbackClass, "onDetectionScoreUpdate", 
-                                                  "(Ljava/lang/String;FFII)V");
-    if (onDetectionScoreUpdateMethod == nullptr) {
-        LOGE("Failed to find onDetectionScoreUpdate method");
-        return JNI_ERR;
-    }
-    
-    // Get the onVoiceActivityStarted method ID
-    onVoiceActivityStartedMethod = env->GetMethodID(callbackClass, "onVoiceActivityStarted", "()V");
-    if (onVoiceActivityStartedMethod == nullptr) {
-        LOGE("Failed to find onVoiceActivityStarted method");
-        // Non-fatal - continue with initialization
-    }
-    
-    // Get the onVoiceActivityEnded method ID
-    onVoiceActivityEndedMethod = env->GetMethodID(callbackClass, "onVoiceActivityEnded", "()V");
-    if (onVoiceActivityEndedMethod == nullptr) {
-        LOGE("Failed to find onVoiceActivityEnded method");
-        // Non-fatal - continue with initialization
+bool WakeupDetector::setCascade(bool enable, float firstStageThreshold, int holdFrames) {
+    if (isRunning) {
+        LOGE("Cannot change cascade mode while the detector is running");
+        return false;
     }
-    
-    return JNI_VERSION_1_6;
+    cascadeEnabled = enable;
+    cascadeThreshold = firstStageThreshold;
+    cascadeHoldFrames = std::max(holdFrames, 1);
+    LOGI("Cascade mode %s (first-stage threshold %.2f, hold %d frames)",
+         enable ? "enabled" : "disabled", cascadeThreshold, cascadeHoldFrames);
+    return true;
 }
 
-JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_createWakeupDetector(
-        JNIEnv* env, jobject thiz) {
-    LOGI("Creating WakeupDetector");
-    auto* detector = new WakeupDetector();
-    return reinterpret_cast<jlong>(detector);
+// Choose the mel front end used by the next initialize()
+bool WakeupDetector::setNativeMelFrontEnd(bool enable) {
+    if (isRunning) {
+        LOGE("Cannot change the mel front end while the detector is running");
+        return false;
+    }
+    LOGI("Native mel front end: %s", enable ? "true" : "false");
+    useNativeMels = enable;
+    return true;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_initializeDetector(
-        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring melModelPath, 
-        jstring embModelPath, jobjectArray wwModelPaths) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (!detector) return JNI_FALSE;
-    
-    // Convert Java strings to C++ strings
-    const char* melModelChars = env->GetStringUTFChars(melModelPath, nullptr);
-    const char* embModelChars = env->GetStringUTFChars(embModelPath, nullptr);
-    
-    std::string melModelStr(melModelChars);
-    std::string embModelStr(embModelChars);
-    
-    env->ReleaseStringUTFChars(melModelPath, melModelChars);
-    env->ReleaseStringUTFChars(embModelPath, embModelChars);
-    
-    // Convert Java string array to C++ vector of strings
-    std::vector<std::string> wwModelPathsVec;
-    jsize wwModelCount = env->GetArrayLength(wwModelPaths);
-    
-    for (jsize i = 0; i < wwModelCount; i++) {
-        jstring pathStr = (jstring)env->GetObjectArrayElement(wwModelPaths, i);
-        const char* pathChars = env->GetStringUTFChars(pathStr, nullptr);
-        wwModelPathsVec.emplace_back(pathChars);
-        env->ReleaseStringUTFChars(pathStr, pathChars);
-        env->DeleteLocalRef(pathStr);
-    }
-    
-    return detector->initialize(melModelStr, embModelStr, wwModelPathsVec) ? JNI_TRUE : JNI_FALSE;
+// Set the callback for voice activity start (true) and end (false)
+void WakeupDetector::setVoiceActivityCallback(std::function<void(bool)> callback) {
+    vadCallback = std::move(callback);
 }
 
-JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_startDetector(
-        JNIEnv* env, jobject thiz, jlong detectorPtr) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (!detector) return JNI_FALSE;
-    
-    // Store the callback object as a global reference
-    if (wakeupDetectorCallback) {
-        env->DeleteWeakGlobalRef(wakeupDetectorCallback);
-        wakeupDetectorCallback = nullptr;
+bool WakeupDetector::setEndpointConfig(const EndpointConfig& config) {
+    if (isRunning) {
+        LOGE("Cannot change endpointing while the detector is running");
+        return false;
     }
-    
-    // Create a global reference to the callback object
-    wakeupDetectorCallback = env->NewWeakGlobalRef(thiz);
-    
-    // Start the detector with a C++ callback that calls the Java callback
-    return detector->start([](const std::string& wakeWord) {
-        notifyWakeWordDetected(wakeWord);
-    }) ? JNI_TRUE : JNI_FALSE;
+    endpointing = config;
+    endpointer.configure(endpointing, vadSampleRate);
+    LOGI("Endpointing: threshold %.2f, hangover %d ms, early endpointing %s (%d ms)",
+         config.threshold, config.hangoverMs, config.earlyEndpoint ? "on" : "off",
+         config.earlyHangoverMs);
+    return true;
 }
 
-JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_stopDetector(
-        JNIEnv* env, jobject thiz, jlong detectorPtr) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (detector) {
-        detector->stop();
-    }
+void WakeupDetector::setEndpointCallback(std::function<void(const EndpointEvent&)> callback) {
+    endpointCallback = std::move(callback);
 }
 
-JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_processAudio(
-        JNIEnv* env, jobject thiz, jlong detectorPtr, jshortArray audioData, jint numSamples) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (!detector) return;
-    
-    // Get the audio data from Java
-    jshort* audioBuffer = env->GetShortArrayElements(audioData, nullptr);
-    if (!audioBuffer) return;
-    
-    // Process the audio
-    detector->processAudio(reinterpret_cast<int16_t*>(audioBuffer), numSamples);
-    
-    // Release the Java array
-    env->ReleaseShortArrayElements(audioData, audioBuffer, JNI_ABORT);
+// VAD thread, or while it is stopped or parked
+void WakeupDetector::resetEndpointer() {
+    endpointer.reset();
+    vadSampleClock = 0;
 }
 
-JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_destroyWakeupDetector(
-        JNIEnv* env, jobject thiz, jlong detectorPtr) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (detector) {
-        delete detector;
+// VAD thread: one window scored, on the clock of samples it has consumed
+void WakeupDetector::onVadWindow(float probability) {
+    const size_t windowSamples = static_cast<size_t>(vadIterator->window_samples());
+    vadSampleClock += windowSamples;
+    EndpointEvent event;
+    if (!endpointer.update(probability, vadSampleClock, windowSamples, event)) {
+        return;
     }
     
-    // Clean up global reference if needed
-    if (wakeupDetectorCallback) {
-        env->DeleteWeakGlobalRef(wakeupDetectorCallback);
-        wakeupDetectorCallback = nullptr;
+    if (event.speech) {
+        LOGD("Voice activity started at sample %llu", static_cast<unsigned long long>(event.sample));
+        isVoiceDetected = true;
+        // Speech onset: the embedding and wake word stages are about to get busy
+        requestBurst();
+    } else {
+        LOGD("Voice activity ended at sample %llu, %llu samples later%s",
+             static_cast<unsigned long long>(event.sample),
+             static_cast<unsigned long long>(event.decidedSample - event.sample),
+             event.early ? " (early)" : "");
+        isVoiceDetected = false;
+        speechEndPending = true;
+    }
+    if (vadCallback) {
+        vadCallback(event.speech);
+    }
+    if (endpointCallback) {
+        endpointCallback(event);
     }
 }
 
-JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_initializeVAD(
-        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring vadModelPath) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (!detector) return JNI_FALSE;
-    
-    // Convert Java string to C++ string
-    const char* vadModelChars = env->GetStringUTFChars(vadModelPath, nullptr);
-    std::string vadModelStr(vadModelChars);
-    env->ReleaseStringUTFChars(vadModelPath, vadModelChars);
-    
-    // Initialize VAD with the model path
-    return detector->initializeVAD(vadModelStr) ? JNI_TRUE : JNI_FALSE;
+void WakeupDetector::setAdaptiveStride(bool enable, int idleStrideMs, float scoreFraction) {
+    const int stepMs = static_cast<int>(embStepSize * MelFrontEnd::hopLength * 1000 / vadSampleRate);
+    const size_t steps = static_cast<size_t>((std::max(idleStrideMs, 0) + stepMs / 2) / stepMs);
+    idleStrideSteps = std::clamp<size_t>(steps, 1, maxIdleStrideSteps);
+    strideScoreFraction = scoreFraction;
+    adaptiveStride = enable;
+    LOGI("Adaptive embedding stride: %s (idle stride %zu ms, score fraction %.2f)",
+         enable ? "true" : "false", idleStrideSteps.load() * stepMs, scoreFraction);
 }
 
-JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_enableVAD(
-        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled) {
-    auto* detector = reinterpret_cast<WakeupDetector*>(detectorPtr);
-    if (!detector) return JNI_FALSE;
-    
-    // Call the enableVAD method
-    return detector->enableVAD(enabled) ? JNI_TRUE : JNI_FALSE;
+// Enable or disable VAD gating of the wake-word chain
+void WakeupDetector::setVadGating(bool enable, int hangoverMs) {
+    LOGI("Setting VAD gating: %s (hangover %d ms)", enable ? "true" : "false", hangoverMs);
+    gateHangoverSamples = static_cast<size_t>(std::max(hangoverMs, 0)) * vadSampleRate / 1000;
+    vadGating = enable;
 }
-
-} // extern "C"
\ No newline at end of file
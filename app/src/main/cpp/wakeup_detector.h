@@ -1,15 +1,28 @@
 #pragma once
 
-#include <jni.h>
 #include <string>
 #include <vector>
 #include <thread>
+#include <memory>
 #include <mutex>
 #include <onnxruntime_cxx_api.h>
-#include <condition_variable>
 #include <atomic>
 #include <functional>
-#include <deque>
+#include "spsc_ring_buffer.h"
+#include "capture_ring.h"
+#include "endpointer.h"
+#include "score_ring.h"
+#include "sliding_window.h"
+#include "audio_convert.h"
+#include "event_signal.h"
+#include "session_factory.h"
+#include "mel_frontend.h"
+#include "memory_report.h"
+#include "pipeline_geometry.h"
+#include "pipeline_stats.h"
+#include "polyphase_resampler.h"
+#include "trace_section.h"
+#include "thread_affinity.h"
 
 // Timestamp class for storing VAD segments
 class timestamp_t {
@@ -34,16 +47,13 @@ public:
 // VadIterator class for voice activity detection
 class VadIterator {
 private:
-    // ONNX Runtime resources
-    Ort::Env env;
-    Ort::SessionOptions session_options;
+    // ONNX Runtime resources; the session lives in sharedOrtEnv()
     std::shared_ptr<Ort::Session> session = nullptr;
     Ort::AllocatorWithDefaultOptions allocator;
     Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeCPU);
 
     // Context-related additions
     const int context_samples = 64;  // For 16kHz, 64 samples as context
-    std::vector<float> _context;     // Holds the last samples from previous chunk
 
     // Original window size (e.g., 32ms corresponds to 512 samples)
     int window_size_samples;
@@ -54,17 +64,31 @@ private:
     int sr_per_ms;
 
     // ONNX Runtime input/output buffers
-    std::vector<Ort::Value> ort_inputs;
     std::vector<const char*> input_node_names = { "input", "state", "sr" };
+    // Bound model input: the last context_samples of the previous window followed
+    // by the current window. Audio is written straight into the window part and
+    // the context is slid in place after each Run.
     std::vector<float> input;
+    int pending_samples = 0;  // samples of the current window received so far
     unsigned int size_state = 2 * 1 * 128;
     std::vector<float> _state;
+    std::vector<float> _state_next;
     std::vector<int64_t> sr;
     int64_t input_node_dims[2] = {};
     const int64_t state_node_dims[3] = { 2, 1, 128 };
     const int64_t sr_node_dims[1] = { 1 };
-    std::vector<Ort::Value> ort_outputs;
     std::vector<const char*> output_node_names = { "output", "stateN" };
+    float speech_prob_out[1] = { 0.0f };
+    const int64_t output_node_dims[2] = { 1, 1 };
+    
+    // Two bindings that ping-pong the recurrent state: binding 0 reads _state and
+    // writes stateN into _state_next, binding 1 does the reverse. stateN lands
+    // directly in the buffer the next window reads, with no copy and no allocation.
+    std::unique_ptr<Ort::IoBinding> bindings[2];
+    int current_binding = 0;
+    
+    // Owner's run options, so its stop() can cancel an in-flight window
+    const Ort::RunOptions* run_options = nullptr;
 
     // Model configuration parameters
     int sample_rate;
@@ -87,65 +111,65 @@ private:
 
     // Callback function for VAD status updates
     std::function<void(bool)> vad_callback;
+    // Speech probability of every window, in order
+    std::function<void(float)> probability_callback;
 
-    // Loads the ONNX model
-    void init_onnx_model(const std::string& model_path) {
-        init_engine_threads(1, 1);
-        session = std::make_shared<Ort::Session>(env, model_path.c_str(), session_options);
-    }
-
-    // Initializes threading settings
-    void init_engine_threads(int inter_threads, int intra_threads) {
-        session_options.SetIntraOpNumThreads(intra_threads);
-        session_options.SetInterOpNumThreads(inter_threads);
-        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    // Binds the persistent input, state and output buffers once
+    void init_bindings() {
+        std::vector<float>* states[2] = { &_state, &_state_next };
+        for (int i = 0; i < 2; i++) {
+            std::vector<float>& state_in = *states[i];
+            std::vector<float>& state_out = *states[1 - i];
+            bindings[i] = std::make_unique<Ort::IoBinding>(*session);
+            bindings[i]->BindInput(input_node_names[0], Ort::Value::CreateTensor<float>(
+                memory_info, input.data(), input.size(), input_node_dims, 2));
+            bindings[i]->BindInput(input_node_names[1], Ort::Value::CreateTensor<float>(
+                memory_info, state_in.data(), state_in.size(), state_node_dims, 3));
+            bindings[i]->BindInput(input_node_names[2], Ort::Value::CreateTensor<int64_t>(
+                memory_info, sr.data(), sr.size(), sr_node_dims, 1));
+            bindings[i]->BindOutput(output_node_names[0], Ort::Value::CreateTensor<float>(
+                memory_info, speech_prob_out, 1, output_node_dims, 2));
+            bindings[i]->BindOutput(output_node_names[1], Ort::Value::CreateTensor<float>(
+                memory_info, state_out.data(), state_out.size(), state_node_dims, 3));
+        }
+        current_binding = 0;
     }
 
-    // Resets internal state (_state, _context, etc.)
+    // Resets internal state (_state, context, etc.)
     void reset_states() {
         std::memset(_state.data(), 0, _state.size() * sizeof(float));
+        std::memset(_state_next.data(), 0, _state_next.size() * sizeof(float));
+        current_binding = 0;
         triggered = false;
         temp_end = 0;
         current_sample = 0;
         prev_end = next_start = 0;
         speeches.clear();
         current_speech = timestamp_t();
-        std::fill(_context.begin(), _context.end(), 0.0f);
+        std::fill(input.begin(), input.end(), 0.0f);
+        pending_samples = 0;
     }
 
-public:
-    // Process a chunk of audio data
-    bool predict(const std::vector<float>& data_chunk) {
+    // Runs the model on the window already in `input` and updates the speech state
+    bool run_window() {
         bool was_triggered = triggered;
-        
-        // Build new input: first context_samples from _context, followed by the current chunk
-        std::vector<float> new_data(effective_window_size, 0.0f);
-        std::copy(_context.begin(), _context.end(), new_data.begin());
-        std::copy(data_chunk.begin(), data_chunk.end(), new_data.begin() + context_samples);
-        input = new_data;
-
-        // Create input tensor
-        Ort::Value input_ort = Ort::Value::CreateTensor<float>(
-            memory_info, input.data(), input.size(), input_node_dims, 2);
-        Ort::Value state_ort = Ort::Value::CreateTensor<float>(
-            memory_info, _state.data(), _state.size(), state_node_dims, 3);
-        Ort::Value sr_ort = Ort::Value::CreateTensor<int64_t>(
-            memory_info, sr.data(), sr.size(), sr_node_dims, 1);
-        ort_inputs.clear();
-        ort_inputs.emplace_back(std::move(input_ort));
-        ort_inputs.emplace_back(std::move(state_ort));
-        ort_inputs.emplace_back(std::move(sr_ort));
-
-        // Run inference
-        ort_outputs = session->Run(
-            Ort::RunOptions{ nullptr },
-            input_node_names.data(), ort_inputs.data(), ort_inputs.size(),
-            output_node_names.data(), output_node_names.size());
-
-        float speech_prob = ort_outputs[0].GetTensorMutableData<float>()[0];
-        float* stateN = ort_outputs[1].GetTensorMutableData<float>();
-        std::memcpy(_state.data(), stateN, size_state * sizeof(float));
+
+        // Run inference; outputs land in speech_prob_out and the other state buffer
+        if (run_options) {
+            session->Run(*run_options, *bindings[current_binding]);
+        } else {
+            session->Run(Ort::RunOptions{ nullptr }, *bindings[current_binding]);
+        }
+        current_binding = 1 - current_binding;
+
+        // The tail of this window becomes the context of the next one
+        std::copy(input.end() - context_samples, input.end(), input.begin());
+
+        float speech_prob = speech_prob_out[0];
         current_sample += static_cast<unsigned int>(window_size_samples);
+        if (probability_callback) {
+            probability_callback(speech_prob);
+        }
 
         // If speech is detected (probability >= threshold)
         if (speech_prob >= threshold) {
@@ -162,8 +186,6 @@ public:
                     vad_callback(true);
                 }
             }
-            // Update context: copy the last context_samples from new_data
-            std::copy(new_data.end() - context_samples, new_data.end(), _context.begin());
             return triggered;
         }
 
@@ -196,13 +218,11 @@ public:
                 vad_callback(false);
             }
             
-            std::copy(new_data.end() - context_samples, new_data.end(), _context.begin());
             return triggered;
         }
 
         if ((speech_prob >= (threshold - 0.15)) && (speech_prob < threshold)) {
-            // When probability drops but is still in speech, update context without changing state
-            std::copy(new_data.end() - context_samples, new_data.end(), _context.begin());
+            // When probability drops but is still in speech, keep the current state
             return triggered;
         }
 
@@ -229,13 +249,42 @@ public:
                     }
                 }
             }
-            std::copy(new_data.end() - context_samples, new_data.end(), _context.begin());
             return triggered;
         }
         
         return triggered;
     }
 
+public:
+    // Streaming entry point: accepts any number of samples and runs one window
+    // each time window_size_samples have accumulated; a shorter tail is carried
+    // over to the next call. Returns the speech state after the last window.
+    bool feed(const float* samples, size_t count) {
+        while (count > 0) {
+            const size_t take = std::min(count, static_cast<size_t>(window_size_samples - pending_samples));
+            std::copy(samples, samples + take, input.begin() + context_samples + pending_samples);
+            pending_samples += static_cast<int>(take);
+            samples += take;
+            count -= take;
+            if (pending_samples == window_size_samples) {
+                pending_samples = 0;
+                run_window();
+            }
+        }
+        return triggered;
+    }
+
+    // Process exactly one window of window_size_samples samples
+    bool predict(const float* data_chunk) {
+        std::copy(data_chunk, data_chunk + window_size_samples, input.begin() + context_samples);
+        pending_samples = 0;
+        return run_window();
+    }
+
+    bool predict(const std::vector<float>& data_chunk) {
+        return predict(data_chunk.data());
+    }
+
     // Process the entire audio input (will be called in chunks in real-time)
     void process(const std::vector<float>& input_wav) {
         reset_states();
@@ -243,8 +292,7 @@ public:
         for (size_t j = 0; j < static_cast<size_t>(audio_length_samples); j += static_cast<size_t>(window_size_samples)) {
             if (j + static_cast<size_t>(window_size_samples) > static_cast<size_t>(audio_length_samples))
                 break;
-            std::vector<float> chunk(&input_wav[j], &input_wav[j] + window_size_samples);
-            predict(chunk);
+            predict(&input_wav[j]);
         }
         // Handle any remaining speech segment
         if (current_speech.start >= 0 && triggered) {
@@ -273,18 +321,59 @@ public:
         reset_states();
     }
     
+    // Run one inference on silence so the first real window does not pay for
+    // ORT's lazy initialization, then clear the state it left behind
+    void warmup() {
+        std::vector<float> silence(window_size_samples, 0.0f);
+        predict(silence);
+        reset_states();
+    }
+    
+    // Run every window with `options` (owned by the caller); null for defaults
+    void set_run_options(const Ort::RunOptions* options) {
+        run_options = options;
+    }
+    
     // Set callback for VAD status changes
     void set_callback(std::function<void(bool)> callback) {
         vad_callback = std::move(callback);
     }
+    
+    // Set callback for the speech probability of each window
+    void set_probability_callback(std::function<void(float)> callback) {
+        probability_callback = std::move(callback);
+    }
+    
+    int window_samples() const {
+        return window_size_samples;
+    }
+    
+    // Bytes of the bound input and recurrent state buffers
+    size_t buffer_bytes() const {
+        return (input.size() + _state.size() + _state_next.size()) * sizeof(float) +
+               sr.size() * sizeof(int64_t);
+    }
 
-    // Constructor
+    // Constructor; loads the ONNX model on the requested provider (CPU if it is rejected)
     VadIterator(const std::string& modelPath,
+        int sample_rate = 16000, int windows_frame_size = 32,
+        float threshold = 0.5, int min_silence_duration_ms = 100,
+        int speech_pad_ms = 30, int min_speech_duration_ms = 250,
+        float max_speech_duration_s = 30.0f,
+        ExecutionProvider provider = ExecutionProvider::Cpu)
+        : VadIterator(std::shared_ptr<Ort::Session>(createSession(modelPath, provider)),
+                      sample_rate, windows_frame_size, threshold, min_silence_duration_ms,
+                      speech_pad_ms, min_speech_duration_ms, max_speech_duration_s) { }
+
+    // Constructor over a session shared with other iterators. Run() is thread-safe
+    // and all recurrent state lives in the iterator, so one Silero session can
+    // serve any number of streams.
+    VadIterator(std::shared_ptr<Ort::Session> shared_session,
         int sample_rate = 16000, int windows_frame_size = 32,
         float threshold = 0.5, int min_silence_duration_ms = 100,
         int speech_pad_ms = 30, int min_speech_duration_ms = 250,
         float max_speech_duration_s = 30.0f)
-        : sample_rate(sample_rate), threshold(threshold), 
+        : session(std::move(shared_session)), sample_rate(sample_rate), threshold(threshold), 
         speech_pad_samples(speech_pad_ms * sample_rate / 1000), prev_end(0)
     {
         sr_per_ms = sample_rate / 1000;  // e.g., 16000 / 1000 = 16
@@ -292,18 +381,23 @@ public:
         effective_window_size = window_size_samples + context_samples; // e.g., 512 + 64 = 576 samples
         input_node_dims[0] = 1;
         input_node_dims[1] = effective_window_size;
+        input.assign(effective_window_size, 0.0f);
         _state.resize(size_state);
+        _state_next.resize(size_state);
         sr.resize(1);
         sr[0] = sample_rate;
-        _context.assign(context_samples, 0.0f);
         min_speech_samples = sr_per_ms * min_speech_duration_ms;
         max_speech_samples = (sample_rate * max_speech_duration_s);
         min_silence_samples = sr_per_ms * min_silence_duration_ms;
         min_silence_samples_at_max_speech = sr_per_ms * 98;
         
         reset_states();
-        env = Ort::Env(OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING, "VADDetector");
-        init_onnx_model(modelPath);
+        init_bindings();
+    }
+
+    // The session this iterator runs on, for sharing with further iterators
+    const std::shared_ptr<Ort::Session>& shared_session() const {
+        return session;
     }
 };
 
@@ -314,156 +408,630 @@ namespace Ort {
     class Value;
 }
 
+// Where each worker thread may run. The always-on stages sit on efficiency
+// cores; when VAD reports speech onset or a wake word score crosses the
+// threshold, the embedding and wake-word workers switch to `burst` for
+// `burstHoldMs` so confirmation is not throttled by little cores.
+struct SchedulingConfig {
+    bool pinThreads = true;
+    CoreClass mel = CoreClass::Efficiency;
+    CoreClass embedding = CoreClass::Efficiency;
+    CoreClass wakeWord = CoreClass::Efficiency;
+    CoreClass vad = CoreClass::Efficiency;
+    CoreClass burst = CoreClass::Any;
+    int burstHoldMs = 1500;
+};
+
+// What a stage does once more than `maxLagMs` of audio is queued in front of it
+// (it has fallen behind real time, e.g. under thermal throttling). Lag is what
+// the stage still has to consume beyond its next inference.
+enum class OverloadPolicy : int {
+    DropNewest = 0,  // never drop queued input; producers drop what no longer fits
+    DropOldest = 1,  // drop the oldest input until the lag is back to maxLagMs
+    SkipToLive = 2,  // drop everything but the newest inference's input
+    Degrade = 3,     // shed work first (idle embedding stride, low-priority wake
+                     // words), and drop as DropOldest only beyond 2 * maxLagMs
+};
+
+// Inter-stage queue capacities, in milliseconds of audio, and the overload policy
+struct QueueConfig {
+    int sampleQueueMs = 4000;    // PCM waiting for the mel stage
+    int vadQueueMs = 2000;       // PCM waiting for VAD
+    int melQueueMs = 2560;       // mel frames (10 ms each) waiting for the embedding stage
+    int featureQueueMs = 5120;   // embeddings (80 ms each) waiting for the wake word stage
+    OverloadPolicy policy = OverloadPolicy::DropOldest;
+    int maxLagMs = 1000;
+};
+
+// Offline scoring (processBuffer/processFiles). Stages whose model has a
+// dynamic batch dimension stack up to `batchSize` windows per Run(); batches
+// are spread over `threads` threads (0: one per core).
+struct OfflineOptions {
+    size_t threads = 0;
+    size_t batchSize = 64;
+    bool cascade = true;  // apply loaded first-stage models; false scores every frame
+};
+
+struct OfflineDetection {
+    size_t wakeWord = 0;   // index into wakeWordNames()
+    uint64_t sample = 0;   // end (exclusive) of the audio the triggering score depends on
+    float score = 0.0f;
+};
+
+// Scores for one buffer or file. Frame f is one wake word inference, the one the
+// live pipeline would run once frameEndSamples[f] samples had arrived; each
+// head contributes scoresPerFrame values per frame to scores[head].
+struct OfflineResult {
+    bool ok = false;
+    size_t samples = 0;
+    std::vector<uint64_t> frameEndSamples;
+    std::vector<size_t> scoresPerFrame;
+    std::vector<std::vector<float>> scores;
+    std::vector<OfflineDetection> detections;  // in time order
+    std::vector<size_t> evaluatedFrames;       // per head, frames the full model scored
+};
+
 class WakeupDetector {
 public:
     WakeupDetector();
     ~WakeupDetector();
 
-    // Initialize the detector with model paths
+    // Initialize the detector with model paths; each stage runs on the provider
+    // selected in `providers` and falls back to CPU if that provider rejects its graph.
+    // `precisions` picks the FP16/INT8 variant stored next to each FP32 model
+    // (see modelVariantPath), using the FP32 file where no variant exists.
     bool initialize(const std::string& melModelPath, const std::string& embModelPath, 
-                    const std::vector<std::string>& wakeWordModelPaths);
+                    const std::vector<std::string>& wakeWordModelPaths,
+                    const StageProviders& providers = StageProviders(),
+                    const StagePrecisions& precisions = StagePrecisions());
                     
-    // Initialize VAD with model path
+    // Initialize VAD with model path, on the VAD provider passed to initialize()
     bool initializeVAD(const std::string& vadModelPath);
     
     // Enable or disable VAD processing
     bool enableVAD(bool enable);
     
+    // Compute mels natively instead of with melspectrogram.onnx. Takes effect at
+    // the next initialize(), which then skips the mel model; fails while running.
+    bool setNativeMelFrontEnd(bool enable);
+    
+    // Cascade mode. Each wake word model with a first-stage model next to it
+    // (see cascadeModelPath) runs only for `holdFrames` frames after that tiny
+    // model scores above `firstStageThreshold`, and while its activation is
+    // building; the first stage runs on every frame. Frames the full model
+    // skips score 0. Takes effect at the next initialize(); fails while running.
+    bool setCascade(bool enable, float firstStageThreshold = defaultCascadeThreshold,
+                    int holdFrames = defaultCascadeHoldFrames);
+    
+    // Adaptive embedding stride. While VAD reports no speech and every score stays
+    // below `scoreFraction` * threshold, embeddings are computed only every
+    // `idleStrideMs` (rounded to 80 ms steps) and the steps in between are
+    // linearly interpolated, so the wake word window keeps its 80 ms spacing.
+    // Speech, a score or first-stage hit above that fraction return to the full
+    // 80 ms rate for fullRateHoldMs. Offline scoring always runs at full rate.
+    void setAdaptiveStride(bool enable, int idleStrideMs = defaultIdleStrideMs,
+                           float scoreFraction = defaultStrideScoreFraction);
+    
+    // Core affinity policy for the worker threads; fails while running
+    bool setSchedulingConfig(const SchedulingConfig& config);
+    const SchedulingConfig& schedulingConfig() const { return scheduling; }
+
+    // Queue capacities and overload policy. Capacities take effect at the next
+    // initialize() (initializeVAD() for the VAD queue), the policy at start();
+    // fails while running.
+    bool setQueueConfig(const QueueConfig& config);
+    const QueueConfig& queueConfig() const { return queues; }
+
+    // Low-memory mode; takes effect at the next initialize() and fails while
+    // running. Every queue shrinks to the smallest size its consumer works with
+    // (QueueConfig capacities are ignored, so a stall of more than one window
+    // drops audio), models load as low-memory sessions (see
+    // setLowMemorySessions(), which this sets for the whole process), and
+    // pause() hands the shared arena's free chunks back to the system.
+    bool setLowMemoryMode(bool enable);
+    bool lowMemoryMode() const { return lowMemory; }
+    
+    // Give back memory not needed right now, e.g. from onTrimMemory(): the
+    // shared ORT arena's free chunks are released at the end of the next
+    // embedding run while running, or right away while stopped. Detection goes
+    // on; the arena grows again as inference needs it.
+    void trimMemory();
+    
+    // This detector's buffers, plus model and process usage; not concurrently
+    // with initialize() or the setters that allocate
+    MemoryReport memoryReport() const;
+    
+    // Low-priority wake words are the first skipped by OverloadPolicy::Degrade;
+    // `wakeWord` indexes wakeWordNames(). Wake words start with high priority.
+    bool setWakeWordPriority(size_t wakeWord, bool high);
+    
+    // Keyword changes without a restart, safe while running. addWakeWord() loads,
+    // validates and warms up one more wake word model (with its first stage in
+    // cascade mode) on the calling thread, then hands it to the wake word worker,
+    // which scores it from its next frame; the mel and embedding stages never
+    // pause. It takes the lowest free index and returns it, or -1 on failure.
+    // removeWakeWord() retires a model by name and frees its index. Both return
+    // once the worker has let go of the previous keyword set; the indices of the
+    // other wake words never change.
+    int addWakeWord(const std::string& modelPath);
+    bool removeWakeWord(const std::string& name);
+
+    // Receives every wake word score (index into wakeWordNames()) from the
+    // inference thread before activation logic runs; set before start()
+    void setScoreCallback(std::function<void(size_t wakeWord, float score)> callback);
+    
+    // Score telemetry. While enabled, the wake word thread appends one record
+    // per wake word output and frame to scoreRing(), which holds the last 4096;
+    // readers poll it at their own rate. Fails while running.
+    bool setScoreTelemetry(bool enable);
+    const ScoreRing& scoreRing() const { return scoreBuffer; }
+    
+    // Callback for voice activity start (true) and end (false); set before start().
+    // Runs on the VAD thread.
+    void setVoiceActivityCallback(std::function<void(bool)> callback);
+    
+    // Endpointing. Speech starts at the first VAD window scoring at least the
+    // threshold and ends once `hangoverMs` of audio after the last such window
+    // has been scored, or `earlyHangoverMs` when early endpointing is on and the
+    // probability fell off sharply. Counted on the VAD sample clock, not per
+    // processAudio() call. Fails while running.
+    bool setEndpointConfig(const EndpointConfig& config);
+    const EndpointConfig& endpointConfig() const { return endpointing; }
+    
+    // Every start and end with its sample positions, on the VAD thread right
+    // after the voice activity callback; set before start()
+    void setEndpointCallback(std::function<void(const EndpointEvent&)> callback);
+    
+    // Suspend the mel/embedding/wake-word stages while VAD reports silence. The
+    // chain keeps running for `hangoverMs` after speech ends, and up to one second
+    // of audio heard while suspended is replayed into it when speech starts,
+    // into windows and activations cleared of everything from before the silence.
+    // Has no effect while VAD is disabled.
+    void setVadGating(bool enable, int hangoverMs = defaultGateHangoverMs);
+    
     // Start listening for audio
     bool start(std::function<void(const std::string&)> wakeWordCallback);
     
-    // Stop listening
+    // The same, with the detected wake word's index into wakeWordNames()
+    bool start(std::function<void(size_t wakeWord, const std::string& name)> wakeWordCallback);
+    
+    // Stop listening. Cancels any inference in flight and joins every worker,
+    // so it returns within a few milliseconds.
     void stop();
     
-    // Process audio data
+    // Stop consuming audio but keep the threads and sessions alive. Waits until
+    // every worker is idle, then drops buffered audio and resets the stream state
+    // (activations, windows, VAD) as start() would. processAudio() calls are
+    // ignored until resume(). Returns false if the detector is not running.
+    bool pause();
+    
+    // Continue after pause(), as if the detector had been restarted; VAD is
+    // enabled again if it is initialized, as start() enables it
+    bool resume();
+    bool isPaused() const { return paused; }
+    
+    // Process audio data; the caller's buffer is read once and never retained
     void processAudio(const int16_t* audioData, size_t numSamples);
+    
+    // Sample rate of the audio passed to processAudio(). Any other rate than
+    // 16 kHz, such as a device's native 44.1 or 48 kHz, is resampled to 16 kHz
+    // in processAudio() before the capture ring, the mel stage and VAD see it,
+    // adding about 1 ms of delay. Fails while running or for a ratio the
+    // resampler cannot do.
+    bool setInputSampleRate(int sampleRate);
+    int inputSampleRate() const { return static_cast<int>(resampler.inputRate()); }
+    
+    // Post-wake capture. While enabled, every processAudio() block is also kept
+    // in captureRing(), which holds the last ~16 s of raw audio. A detection
+    // opens a capture session starting `preRollMs` before it; the session ends
+    // `postSilenceMs` after VAD reports the end of speech (or after
+    // maxCaptureSeconds), and never overlaps the previous one. Fails while running.
+    bool setAudioCapture(bool enable, int preRollMs = defaultCapturePreRollMs,
+                         int postSilenceMs = defaultPostSilenceMs);
+    
+    // Session start and end, as captureRing() positions; set before start().
+    // Both run on the thread calling processAudio().
+    void setAudioCaptureCallbacks(std::function<void(size_t wakeWord, uint64_t start)> started,
+                                  std::function<void(size_t wakeWord, uint64_t end)> ended);
+    
+    const CaptureRing& captureRing() const { return captureBuffer; }
+    
+    // Wait up to `timeoutMs` for audio of the session that started at
+    // `sessionStart` beyond `position`. Returns the end of what is readable now,
+    // `position` on timeout, or -1 once that session has ended and been read
+    // up to its end (or a newer session replaced it). Safe from any thread.
+    int64_t waitForCapture(uint64_t sessionStart, uint64_t position, int timeoutMs);
+    
+    // Score a whole recording without the realtime threads. Produces the scores
+    // and detections a fast (non-realtime) replay of the same audio would, up to
+    // float rounding between batched and single-window inference; VAD and gating
+    // are not applied. Safe to call from several threads at once, but not while
+    // the detector is running. A trailing partial mel block is not scored.
+    OfflineResult processBuffer(const int16_t* samples, size_t numSamples,
+                                const OfflineOptions& options = OfflineOptions()) const;
+    
+    // Read a 16 kHz mono PCM16 WAV file and score it with processBuffer()
+    OfflineResult processFile(const std::string& wavPath,
+                              const OfflineOptions& options = OfflineOptions()) const;
+    
+    // Score many files, one per thread at a time; results follow `wavPaths`
+    std::vector<OfflineResult> processFiles(const std::vector<std::string>& wavPaths,
+                                            const OfflineOptions& options = OfflineOptions()) const;
+    
+    // Names of the loaded wake word models by index, in the order they were
+    // initialized; a removed model leaves an empty name until its index is reused
+    std::vector<std::string> wakeWordNames() const;
+    
+    // Always-on per-stage latency and worker CPU time; readable from any thread
+    const PipelineStats& stats() const { return pipelineStats; }
+    void resetStats() { pipelineStats.reset(); }
+    
+    // Samples waiting for the mel or VAD stage, whichever is further behind
+    size_t queuedSamples() const { return std::max(sampleRing.size(), vadRing.size()); }
+    
+    // True when no stage is mid-inference and none has enough buffered input for
+    // another one, i.e. everything passed to processAudio has been scored
+    bool isDrained() const;
 
 private:
-    // Constants
-    static constexpr size_t chunkSamples = 1280; // 80 ms
-    static constexpr size_t numMels = 32;
-    static constexpr size_t embWindowSize = 76; // 775 ms
-    static constexpr size_t embStepSize = 8;    // 80 ms
-    static constexpr size_t embFeatures = 96;
-    static constexpr size_t wwFeatures = 16;
+    // Geometry of the mel and embedding stages; each wake word head runs on the
+    // StandardGeometry or WideHeadGeometry window its model's input asks for
+    using Geometry = StandardGeometry;
+    static constexpr size_t chunkSamples = Geometry::chunkSamples;
+    static constexpr size_t frameSize = Geometry::frameSize;
+    static constexpr size_t numMels = Geometry::numMels;
+    static constexpr size_t embWindowSize = Geometry::embWindowSize;
+    static constexpr size_t embStepSize = Geometry::embStepSize;
+    static constexpr size_t embFeatures = Geometry::embFeatures;
+    static constexpr size_t wwFeatures = Geometry::wwFeatures;
+    static constexpr size_t maxWakeWordFrames = WideHeadGeometry::wwFeatures;
+    static_assert(MelFrontEnd::numMels == numMels, "mel front end band count mismatch");
+    static_assert(MelFrontEnd::hopLength == Geometry::melHopSamples, "mel front end hop mismatch");
+    
+    // Duration of one queued frame, for the queue sizes and lag accounting
+    static constexpr int64_t melFrameNanos = 10000000;      // MelFrontEnd::hopLength at 16 kHz
+    static constexpr int64_t featureFrameNanos = 80000000;  // embStepSize mel frames
+
+    // Offline path: mel frames of a whole buffer and the audio position each ends at
+    void offlineMels(const int16_t* samples, size_t numSamples, const OfflineOptions& options,
+                     std::vector<float>& mels, std::vector<uint64_t>& melEndSamples) const;
+    
+    // Per-keyword state; all heads share one worker and one feature window, and
+    // each reads the newest `frames` embeddings of it
+    struct WakeWordHead {
+        std::string name;
+        size_t index = 0;  // into wakeWordNames()
+        size_t frames = wwFeatures;
+        std::array<int64_t, 3> inputShape = StandardGeometry::wwInputShape;
+        const std::vector<Ort::Value>* inputViews = nullptr;  // per feature window slot
+        std::unique_ptr<Ort::Session> session;
+        std::string inputName;
+        std::string outputName;
+        std::unique_ptr<Ort::IoBinding> binding; // output bound to `scores`
+        std::vector<float> scores;
+        int activation = 0;
+        
+        // Cascade first stage, null when the head always runs; the full model
+        // is evaluated while cascadeHold > 0 or the activation is building
+        std::unique_ptr<Ort::Session> firstStage;
+        std::string firstStageInputName;
+        std::string firstStageOutputName;
+        std::unique_ptr<Ort::IoBinding> firstStageBinding;
+        std::vector<float> firstStageScores;
+        int cascadeHold = 0;
+        bool evaluated = true;  // whether `scores` holds this frame's output
+        std::atomic<bool> lowPriority{false};  // skipped first under OverloadPolicy::Degrade
+    };
+    
+    // The keyword set, replaced as a whole (RCU style). Writers, serialized by
+    // wwTableMutex, publish a new table in activeTable and drop the old one once
+    // the wake word worker, which announces the table it is reading in
+    // tableInUse, has moved past it, so the worker never takes a lock. Heads are
+    // shared between consecutive tables and keep their state; null slots are
+    // free indices.
+    struct WakeWordTable {
+        std::vector<std::shared_ptr<WakeWordHead>> heads;  // by wake word index
+        size_t windowFrames = wwFeatures;  // longest head window; frames per wake word step
+        size_t outputs = 0;                // scores per frame over every head
+    };
+    
+    // Load and warm up one head; throws on ORT errors, null if the model is unusable
+    std::shared_ptr<WakeWordHead> loadWakeWordHead(const std::string& modelPath, size_t index);
+    
+    // Swap in `table` and wait out the worker's read of the previous one;
+    // caller holds wwTableMutex
+    void publishTable(std::shared_ptr<WakeWordTable> table);
+    
+    // Snapshot for control calls and offline scoring
+    std::shared_ptr<const WakeWordTable> loadedTable() const;
+    
+    // Worker side: the table to score one frame with, announced until release()
+    struct TableReadScope {
+        explicit TableReadScope(WakeupDetector& d) : detector(d) {
+            const WakeWordTable* current;
+            do {
+                current = detector.activeTable.load();
+                detector.tableInUse.store(current);
+            } while (current != detector.activeTable.load());
+            table = current;
+        }
+        ~TableReadScope() { detector.tableInUse.store(nullptr); }
+        WakeupDetector& detector;
+        const WakeWordTable* table;
+    };
+    
+    // Offline path: the live cascade's decisions applied to one head's scores
+    size_t applyCascade(const WakeWordHead& head, const std::vector<float>& features,
+                        size_t windowFrames, size_t frames, const OfflineOptions& options,
+                        std::vector<float>& scores) const;
     
     // VAD constants
-    static constexpr size_t vadWindowSize = 1536; // Silero VAD window size
-    static constexpr size_t vadSampleRate = 16000; // 16kHz
+    static constexpr size_t vadSampleRate = Geometry::sampleRate;
+    static constexpr size_t vadReadBlock = 2048; // samples taken from vadRing per feed
     
     // Audio capture constants
-    static constexpr size_t audioCaptureBufferSize = vadSampleRate * 60; // 60 seconds max
+    static constexpr size_t captureRingCapacity = 1 << 18;  // ~16 s at 16 kHz, 512 KB
+    static constexpr size_t maxCaptureSeconds = 12;  // session limit without an end of speech
+    static constexpr int defaultCapturePreRollMs = 500;
     static constexpr int defaultPostSilenceMs = 500; // 0.5 seconds after voice ends
     
+    // Score telemetry: ~5 min of frames for one wake word, 64 KB
+    static constexpr size_t scoreRingCapacity = 1 << 12;
+    
+    // Adaptive stride constants; the idle stride is in embStepSize steps and
+    // limited so its mels fit the mel window
+    static constexpr int defaultIdleStrideMs = 240;
+    static constexpr float defaultStrideScoreFraction = 0.3f;
+    static constexpr size_t maxIdleStrideSteps = 8;
+    static constexpr int64_t fullRateHoldNanos = 2000000000;  // 2 s
+    
+    // Cascade constants; a hold of 12 frames is ~1 s of wake word windows
+    static constexpr float defaultCascadeThreshold = 0.1f;
+    static constexpr int defaultCascadeHoldFrames = 12;
+    
+    // VAD gating constants
+    static constexpr size_t preRollSamples = vadSampleRate;  // 1 s replayed when speech starts
+    static constexpr int defaultGateHangoverMs = 1000;
+    
     // Settings
     std::string melModelPath;
     std::string embModelPath;
-    std::vector<std::string> wwModelPaths;
     std::string vadModelPath;
     float threshold = 0.5f;
     int triggerLevel = 1;
     int refractory = 20;
-    size_t frameSize = 4 * chunkSamples;
-    size_t stepFrames = 4;
+    StageProviders stageProviders;
+    StagePrecisions stagePrecisions;
+    SchedulingConfig scheduling;
+    QueueConfig queues;
+    bool useNativeMels = false;
+    bool cascadeEnabled = false;
+    float cascadeThreshold = defaultCascadeThreshold;
+    int cascadeHoldFrames = defaultCascadeHoldFrames;
     
     // VAD settings
     std::atomic<bool> vadEnabled{false};
     std::atomic<bool> vadInitialized{false};
     float vadThreshold = 0.5f;
-    int silenceLimitFrames = 10; // Process for this many frames after silence
-    int silenceFrameCount = 0;   // Counter for frames of silence
-    
-    // Voice end delay mechanism
-    std::atomic<bool> voiceEndPending{false};
-    int voiceEndFrameCount = 0;
-    int voiceEndDelayFrames = 10; // 500ms at 16KHz with 512 sample frames (32ms * 16)
-
-    // VAD context-related additions (based on reference implementation)
-    static constexpr int vadContextSamples = 64; // For 16kHz, 64 samples as context
-    int vadMinSilenceSamples = 1600; // 100ms at 16kHz
-    int vadMinSpeechSamples = 4000;  // 250ms at 16kHz 
-    int vadSpeechPadSamples = 480;   // 30ms at 16kHz
-    float vadMaxSpeechSamples = 16000 * 30.0f; // 30 seconds max
-    std::vector<float> vadContext; // Last samples from previous chunk
-    bool vadTriggered = false;     // Speech detection state
-    unsigned int vadTempEnd = 0;   // Temporary end marker for speech segment
-    unsigned int vadCurrentSample = 0; // Current sample position
-    int vadPrevEnd = 0;
-    int vadNextStart = 0;
-    
-    // Audio Capture settings
+    
+    // Endpointing; the endpointer and its clock belong to the VAD thread, which
+    // raises speechEndPending for the capture session in processAudio
+    EndpointConfig endpointing;
+    Endpointer endpointer;
+    uint64_t vadSampleClock = 0;
+    std::atomic<bool> speechEndPending{false};
+    std::function<void(const EndpointEvent&)> endpointCallback;
+    void onVadWindow(float probability);
+    void resetEndpointer();
+    
+    // VAD gating; gateOpen, the hangover countdown and preRollRing belong to processAudio
+    std::atomic<bool> vadGating{false};
+    std::atomic<size_t> gateHangoverSamples{defaultGateHangoverMs * vadSampleRate / 1000};
+    bool gateOpen = true;
+    size_t gateHangoverRemaining = 0;
+    bool updateGate(bool feedVAD, size_t numSamples);
+    void holdPreRoll(const float* samples, size_t count);
+    size_t replayPreRoll();
+    
+    // Gate reopening: the replayed pre-roll must not continue audio from before
+    // the silence. Each stage drops what it still holds from before the given
+    // position, resets its own state and passes a position on downstream.
+    static constexpr uint64_t noStageReset = UINT64_MAX;
+    std::atomic<uint64_t> gateReopenSample{noStageReset};  // processAudio -> mel thread
+    std::atomic<uint64_t> melResetFrame{noStageReset};     // mel -> embedding thread
+    std::atomic<uint64_t> featureResetFrame{noStageReset}; // embedding -> wake word thread
+
+    // Audio capture settings
     std::atomic<bool> audioCaptureEnabled{false};
-    std::atomic<bool> isCapturingAudio{false};
-    int postSilenceCaptureDurationMs = defaultPostSilenceMs;
-    int postSilenceFrameCount = 0;
-    bool wakeWordDetectedFlag = false;
-    std::string lastDetectedWakeWord;
+    size_t capturePreRollSamples = defaultCapturePreRollMs * vadSampleRate / 1000;
+    size_t capturePostSilenceSamples = defaultPostSilenceMs * vadSampleRate / 1000;
+    
+    // Capture session. The wake word thread only raises captureRequest; the
+    // session itself belongs to processAudio, which publishes its bounds for
+    // waitForCapture() and wakes waiting readers through captureSignal.
+    CaptureRing captureBuffer;
+    std::atomic<int> captureRequest{-1};  // wake word index, -1 when none
+    std::atomic<bool> captureOpen{false};  // set by processAudio; closeCapture() claims it
+    std::atomic<size_t> captureWakeWord{0};  // written by processAudio before captureOpen
+    uint64_t captureCloseAt = 0;           // processAudio only; UINT64_MAX until speech ends
+    uint64_t captureLimit = 0;             // processAudio only
+    std::atomic<uint64_t> captureSessionStart{UINT64_MAX};
+    std::atomic<uint64_t> captureSessionEnd{0};  // UINT64_MAX while open
+    EventSignal captureSignal;
+    std::function<void(size_t, uint64_t)> captureStartedCallback;
+    std::function<void(size_t, uint64_t)> captureEndedCallback;
+    void updateCapture(bool speechEnded);
+    void closeCapture(uint64_t end);
 
 public:
     // Processing threads
     std::thread melThread;
     std::thread featuresThread;
-    std::vector<std::thread> wwThreads;
+    std::thread wwThread;
     std::thread vadThread;
-    std::thread audioCaptureThread;
+    
+    // Marks a worker as busy for the drain check in isDrained()
+    struct BusyScope {
+        explicit BusyScope(WakeupDetector& d) : detector(d) {
+            detector.busyStages.fetch_add(1);
+            detector.stageTransitions.fetch_add(1);
+        }
+        ~BusyScope() {
+            detector.stageTransitions.fetch_add(1);
+            detector.busyStages.fetch_sub(1);
+        }
+        WakeupDetector& detector;
+    };
     
     // Audio processing functions
     void audioToMels();
     void melsToFeatures();
-    void featuresToOutput(size_t wwIdx);
+    void featuresToOutput();
+    void updateActivation(WakeWordHead& head, float probability, bool logThisFrame,
+                          int64_t originNanos);
+    
+    // Adaptive stride: the embedding worker's stride for its next embedding, and
+    // the feature frames it writes for it (interpolated steps, then the embedding)
+    std::atomic<bool> adaptiveStride{false};
+    std::atomic<size_t> idleStrideSteps{defaultIdleStrideMs / 80};
+    std::atomic<float> strideScoreFraction{defaultStrideScoreFraction};
+    std::atomic<int64_t> fullRateUntilNanos{0};
+    std::vector<float> lastEmbedding;  // embedding worker only
+    bool haveLastEmbedding = false;    // embedding worker only
+    bool embeddingDegraded = false;    // embedding worker only; Degrade forces the idle stride
+    void requestFullRate();
+    size_t embeddingStride() const;
+    void writeStridedFeatures(size_t steps, int64_t originNanos, int64_t readyNanos);
+    
+    // Scheduling: open the burst window, and re-pin a worker when it opens or closes
+    void requestBurst();
+    void applyAffinity(ThreadAffinity& affinity, CoreClass steady, bool burstable) const;
+    std::atomic<int64_t> burstUntilNanos{0};
+    
+    // Overload handling: how much of a stage's lag its policy drops, and the
+    // lag histogram a stage records before each inference
+    int64_t overloadDropNanos(int64_t lagNanos) const;
+    bool overloaded(int64_t lagNanos) const {
+        return lagNanos > static_cast<int64_t>(queues.maxLagMs) * 1000000;
+    }
+    static void recordLag(StageStats& stage, int64_t lagNanos);
+    static int64_t samplesToNanos(size_t samples) {
+        return static_cast<int64_t>(samples) * 1000000000 / static_cast<int64_t>(vadSampleRate);
+    }
     void vadProcessing();
     
     // Thread synchronization
-    std::mutex mutSamples, mutMels, mutOutput;
-    std::vector<std::mutex> mutFeatures;
-    std::condition_variable cvSamples, cvMels;
-    std::vector<std::condition_variable> cvFeatures;
+    EventSignal samplesSignal, melsSignal, featuresSignal;
     
     // VAD synchronization
     std::mutex mutVAD;
-    std::condition_variable cvVAD;
-    bool vadSamplesReady = false;
+    EventSignal vadSignal;
+    std::atomic<bool> vadResetPending{false};
+    
+    // Lock-free buffers for data exchange between threads
+    SpscRingBuffer<float> sampleRing;
+    SlidingWindow melWindow;
+    SlidingWindow featureWindow;
+    SpscRingBuffer<float> vadRing;
+    SpscRingBuffer<float> preRollRing;  // raw samples held back while the gate is closed
     
-    // Audio capture synchronization
-    std::mutex mutAudioCapture;
-    std::condition_variable cvAudioCapture;
-    std::atomic<bool> shouldStopCapture{false};
-    std::atomic<bool> audioCaptureComplete{false};
+    // Preallocated conversion buffers used by processAudio
+    std::vector<float> captureScratch;
+    std::vector<float> vadScratch;
     
-    // Buffers for data exchange between threads
-    std::vector<float> floatSamples;
-    std::vector<float> mels;
-    std::vector<std::vector<float>> features;
-    std::vector<float> vadSamples;
+    // Native-rate input, resampled block by block into resampleScratch; processAudio only
+    PolyphaseResampler resampler;
+    std::vector<int16_t> resampleScratch;
+    void ingestAudio(const int16_t* audioData, size_t numSamples, int64_t arrivalNanos);
     
-    // Circular buffer for audio capture
-    std::deque<int16_t> audioBuffer;
-    std::vector<int16_t> capturedAudio;
+    // Measurements and drain tracking
+    PipelineStats pipelineStats;
+    
+    // Arrival time of the audio behind each frame. processAudio leaves one mark per
+    // write (sample count so far, call time); the mel stage turns them into per-frame
+    // origin times, and every stage stamps the slots it fills with the origin and
+    // the time the frame became ready, before committing it.
+    struct SampleMark {
+        uint64_t endSample;
+        int64_t arrivalNanos;
+    };
+    static constexpr size_t sampleMarkCapacity = 1024;
+    SpscRingBuffer<SampleMark> sampleMarks;
+    uint64_t samplesWritten = 0;   // processAudio only
+    uint64_t samplesConsumed = 0;  // mel thread only
+    SampleMark pendingMark{0, 0};  // mel thread only
+    std::vector<int64_t> melOrigin, melReady;          // per mel window slot
+    std::vector<int64_t> featureOrigin, featureReady;  // per feature window slot
+    std::atomic<int> busyStages{0};
+    std::atomic<uint64_t> stageTransitions{0};
     
     // Thread state management
     std::atomic<bool> isRunning;
     std::atomic<bool> isInitialized;
-    std::atomic<bool> samplesReady;
-    std::atomic<bool> melsReady;
-    std::vector<std::atomic<bool>> featuresReady;
+    std::atomic<bool> paused{false};
+    
+    // Workers park at the top of their loop while paused, so pause() can reset
+    // the stages once parkedWorkers reaches liveWorkers
+    std::atomic<int> liveWorkers{0};
+    std::atomic<int> parkedWorkers{0};
+    EventSignal parkSignal;
+    std::atomic<uint32_t> resumeCount{0};
+    uint32_t ingestResumeCount = 0;  // processAudio only
+    bool parkWhilePaused(EventSignal& signal, uint32_t seen);
+    void exitWorker();
+    void resetStreamState();
+    
+    // Shared by every Run() of the streaming stages; stop() sets its terminate flag
+    Ort::RunOptions runOptions;
+    
+    // The same with arena shrinkage, for the one embedding run after trimMemory()
+    Ort::RunOptions arenaShrinkOptions;
+    std::atomic<bool> arenaShrinkPending{false};
+    bool lowMemory = false;
+    void shrinkArena();  // no worker may be inside a Run
     std::atomic<bool> isVoiceDetected{false};
-    std::atomic<bool> previousVoiceState{false};
     
     // ONNX Runtime objects
-    std::unique_ptr<Ort::Env> env;
-    std::unique_ptr<Ort::Session> vadSession;
+    
+    // Sessions are built and warmed up once in initialize() and kept across start()/stop()
+    std::unique_ptr<Ort::Session> melSession;
+    std::unique_ptr<Ort::Session> embSession;
+    std::string melInputName, melOutputName;
+    std::string embInputName, embOutputName;
+    mutable std::mutex wwTableMutex;
+    std::shared_ptr<const WakeWordTable> wwTable;           // guarded by wwTableMutex
+    std::atomic<const WakeWordTable*> activeTable{nullptr}; // what the worker reads next
+    std::atomic<const WakeWordTable*> tableInUse{nullptr};  // what it is reading now
+    
+    // Native mel front end; when set, melSession and melBinding are unused
+    std::unique_ptr<MelFrontEnd> melFrontEnd;
+    
+    // Preallocated I/O for every Run(); shapes are fixed at initialize()
+    std::vector<float> melInput;
+    std::vector<float> melOutput;
+    std::unique_ptr<Ort::IoBinding> melBinding;
+    std::unique_ptr<Ort::IoBinding> embBinding;
+    std::vector<Ort::Value> embInputViews;   // one per mel window slot
+    std::vector<Ort::Value> embOutputViews;  // one per feature window slot
+    std::vector<float> embScratch;           // output when the feature window is full or when
+                                             // skipped embeddings are interpolated from it
+    Ort::Value embScratchView{nullptr};
+    std::vector<Ort::Value> wwInputViews;     // one per feature window slot, StandardGeometry
+    std::vector<Ort::Value> wwWideInputViews; // the same for WideHeadGeometry heads
+    std::atomic<size_t> wwWindowFrames{wwFeatures};  // the active table's windowFrames
     
     // VAD Iterator object
     std::unique_ptr<VadIterator> vadIterator;
     
-    // VAD state for ONNX model
-    static constexpr unsigned int vadStateSize = 2 * 1 * 128;
-    std::vector<float> vadState;
-    
     // Callback when wake word is detected
-    std::function<void(const std::string&)> wakeWordCallback;
+    std::function<void(size_t, const std::string&)> wakeWordCallback;
     // Callback for VAD status
     std::function<void(bool)> vadCallback;
+    // Per-frame wake word scores
+    std::function<void(size_t, float)> scoreCallback;
+    std::atomic<bool> scoreTelemetryEnabled{false};
+    ScoreRing scoreBuffer;
+    std::vector<ScoreRecord> frameScores;  // wake word thread only, one frame's records
     std::string vadInputNameStr;
     std::string vadOutputNameStr;
     
@@ -473,9 +1041,4 @@ public:
     std::vector<int64_t> vadInputShape;
     // vadInputLength
     size_t vadInputLength = 0;
-    // Callback for audio capture completion
-    std::function<void(const std::vector<int16_t>&, int)> audioCaptureCallback;
-
-    // Helper function to join threads with timeout
-    bool joinThreadWithTimeout(std::thread& thread, int timeoutMs);
 };
\ No newline at end of file
@@ -0,0 +1,503 @@
+#include "wakeup_detector.h"
+#include "jni_callback_dispatcher.h"
+#include "platform_log.h"
+#include "mapped_model.h"
+#include <android/asset_manager_jni.h>
+#include <jni.h>
+#include <string>
+
+// JNI bindings for WakeupDetectorJNI; the pipeline itself lives in wakeup_detector.cpp
+
+#define LOGD(...) PLATFORM_LOG(PLATFORM_LOG_DEBUG, "WakeupDetectorJNI", __VA_ARGS__)
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "WakeupDetectorJNI", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "WakeupDetectorJNI", __VA_ARGS__)
+#define LOGW(...) PLATFORM_LOG(PLATFORM_LOG_WARN, "WakeupDetectorJNI", __VA_ARGS__)
+
+// Native side of one WakeupDetectorJNI. Each instance has its own dispatcher
+// thread, so several detectors can run side by side; pipeline threads only enqueue.
+// The detector is declared last so it is destroyed (and stopped) first.
+struct DetectorHandle {
+    JniCallbackDispatcher dispatcher;
+    WakeupDetector detector;
+};
+
+static DetectorHandle* handleFromPtr(jlong detectorPtr) {
+    return reinterpret_cast<DetectorHandle*>(detectorPtr);
+}
+
+static WakeupDetector* detectorFromPtr(jlong detectorPtr) {
+    DetectorHandle* handle = handleFromPtr(detectorPtr);
+    return handle ? &handle->detector : nullptr;
+}
+
+static JavaVM* javaVM = nullptr;
+
+// Java AssetManager backing "asset:" model references, kept alive for the process
+static jobject assetManagerRef = nullptr;
+
+// JNI implementation
+extern "C" {
+
+JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+    
+    // Dispatchers attach their threads through the VM
+    javaVM = vm;
+    return JNI_VERSION_1_6;
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setAssetManager(
+        JNIEnv* env, jclass clazz, jobject assetManager) {
+    jobject previous = assetManagerRef;
+    assetManagerRef = env->NewGlobalRef(assetManager);
+    setModelAssetManager(AAssetManager_fromJava(env, assetManagerRef));
+    if (previous) {
+        env->DeleteGlobalRef(previous);
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setModelCacheDirectory(
+        JNIEnv* env, jclass clazz, jstring directory) {
+    std::string directoryStr;
+    if (directory) {
+        const char* directoryChars = env->GetStringUTFChars(directory, nullptr);
+        directoryStr = directoryChars;
+        env->ReleaseStringUTFChars(directory, directoryChars);
+    }
+    setOptimizedModelCacheDirectory(directoryStr);
+}
+
+JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_createWakeupDetector(
+        JNIEnv* env, jobject thiz) {
+    LOGI("Creating WakeupDetector");
+    auto* handle = new DetectorHandle();
+    if (!handle->dispatcher.initialize(javaVM, env)) {
+        delete handle;
+        return 0;
+    }
+    handle->dispatcher.start();
+    JniCallbackDispatcher* dispatcher = &handle->dispatcher;
+    handle->detector.setEndpointCallback([dispatcher](const EndpointEvent& event) {
+        dispatcher->postVoiceActivity(event.speech, 0, static_cast<int64_t>(event.sample));
+    });
+    handle->detector.setAudioCaptureCallbacks(
+        [dispatcher](size_t wakeWord, uint64_t start) {
+            dispatcher->postCaptureStarted(static_cast<int>(wakeWord), start);
+        },
+        [dispatcher](size_t wakeWord, uint64_t end) {
+            dispatcher->postCaptureEnded(static_cast<int>(wakeWord), end);
+        });
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_initializeDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring melModelPath, 
+        jstring embModelPath, jobjectArray wwModelPaths, jintArray providers,
+        jintArray precisions) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    
+    // Convert Java strings to C++ strings
+    const char* melModelChars = env->GetStringUTFChars(melModelPath, nullptr);
+    const char* embModelChars = env->GetStringUTFChars(embModelPath, nullptr);
+    
+    std::string melModelStr(melModelChars);
+    std::string embModelStr(embModelChars);
+    
+    env->ReleaseStringUTFChars(melModelPath, melModelChars);
+    env->ReleaseStringUTFChars(embModelPath, embModelChars);
+    
+    // Convert Java string array to C++ vector of strings
+    std::vector<std::string> wwModelPathsVec;
+    jsize wwModelCount = env->GetArrayLength(wwModelPaths);
+    
+    for (jsize i = 0; i < wwModelCount; i++) {
+        jstring pathStr = (jstring)env->GetObjectArrayElement(wwModelPaths, i);
+        const char* pathChars = env->GetStringUTFChars(pathStr, nullptr);
+        wwModelPathsVec.emplace_back(pathChars);
+        env->ReleaseStringUTFChars(pathStr, pathChars);
+        env->DeleteLocalRef(pathStr);
+    }
+    
+    // Optional per-stage providers: {mel, embedding, wake word, vad}; missing entries stay on CPU
+    StageProviders stageProviders;
+    if (providers) {
+        jint values[4] = {0, 0, 0, 0};
+        const jsize count = std::min<jsize>(env->GetArrayLength(providers), 4);
+        env->GetIntArrayRegion(providers, 0, count, values);
+        stageProviders.mel = executionProviderFromInt(values[0]);
+        stageProviders.embedding = executionProviderFromInt(values[1]);
+        stageProviders.wakeWord = executionProviderFromInt(values[2]);
+        stageProviders.vad = executionProviderFromInt(values[3]);
+    }
+    
+    // Optional per-stage precisions: {mel, embedding, wake word}; missing entries stay FP32
+    StagePrecisions stagePrecisions;
+    if (precisions) {
+        jint values[3] = {0, 0, 0};
+        const jsize count = std::min<jsize>(env->GetArrayLength(precisions), 3);
+        env->GetIntArrayRegion(precisions, 0, count, values);
+        stagePrecisions.mel = modelPrecisionFromInt(values[0]);
+        stagePrecisions.embedding = modelPrecisionFromInt(values[1]);
+        stagePrecisions.wakeWord = modelPrecisionFromInt(values[2]);
+    }
+    
+    return detector->initialize(melModelStr, embModelStr, wwModelPathsVec, stageProviders,
+                                stagePrecisions) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_startDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    DetectorHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return JNI_FALSE;
+    
+    // Route callbacks to this object; wake word names become cached jstrings
+    JniCallbackDispatcher* dispatcher = &handle->dispatcher;
+    dispatcher->setTarget(env, thiz, handle->detector.wakeWordNames());
+    
+    // Start the detector; detections are handed to the dispatcher by index
+    return handle->detector.start([dispatcher](size_t wakeWord, const std::string&) {
+        dispatcher->postWakeWord(static_cast<int>(wakeWord));
+    }) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_stopDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (detector) {
+        detector->stop();
+    }
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_pauseDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->pause() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_resumeDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->resume() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_processAudio(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jshortArray audioData, jint numSamples) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return;
+    
+    // Get the audio data from Java
+    jshort* audioBuffer = env->GetShortArrayElements(audioData, nullptr);
+    if (!audioBuffer) return;
+    
+    // Process the audio
+    detector->processAudio(reinterpret_cast<int16_t*>(audioBuffer), numSamples);
+    
+    // Release the Java array
+    env->ReleaseShortArrayElements(audioData, audioBuffer, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_processAudioDirect(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jobject audioBuffer, jint numSamples) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector || numSamples <= 0) return;
+    
+    // Read the direct buffer in place; no copy, no pinning
+    auto* samples = static_cast<const int16_t*>(env->GetDirectBufferAddress(audioBuffer));
+    if (!samples) {
+        LOGE("processAudioDirect requires a direct ByteBuffer");
+        return;
+    }
+    
+    const jlong capacitySamples = env->GetDirectBufferCapacity(audioBuffer) / 2;
+    const size_t count = static_cast<size_t>(std::min<jlong>(numSamples, capacitySamples));
+    
+    // Process the audio
+    detector->processAudio(samples, count);
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_destroyWakeupDetector(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    DetectorHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle) return;
+    
+    // Once the detector has stopped no more events can be posted; deliver the
+    // rest and drop the callback refs
+    handle->detector.stop();
+    handle->dispatcher.release(env);
+    delete handle;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_initializeVAD(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring vadModelPath) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    
+    // Convert Java string to C++ string
+    const char* vadModelChars = env->GetStringUTFChars(vadModelPath, nullptr);
+    std::string vadModelStr(vadModelChars);
+    env->ReleaseStringUTFChars(vadModelPath, vadModelChars);
+    
+    // Initialize VAD with the model path
+    return detector->initializeVAD(vadModelStr) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setNativeMelFrontEnd(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->setNativeMelFrontEnd(enabled == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setCascade(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled, jfloat firstStageThreshold,
+        jint holdFrames) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->setCascade(enabled == JNI_TRUE, firstStageThreshold, holdFrames)
+               ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setAdaptiveStride(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled, jint idleStrideMs,
+        jfloat scoreFraction) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (detector) {
+        detector->setAdaptiveStride(enabled == JNI_TRUE, idleStrideMs, scoreFraction);
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setVadGating(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled, jint hangoverMs) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (detector) {
+        detector->setVadGating(enabled == JNI_TRUE, hangoverMs);
+    }
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setEndpointing(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jint hangoverMs, jboolean earlyEndpoint,
+        jint earlyHangoverMs) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    EndpointConfig config = detector->endpointConfig();
+    config.hangoverMs = hangoverMs;
+    config.earlyEndpoint = earlyEndpoint == JNI_TRUE;
+    config.earlyHangoverMs = earlyHangoverMs;
+    return detector->setEndpointConfig(config) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setInputSampleRate(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jint sampleRate) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->setInputSampleRate(sampleRate) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setSchedulingConfig(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean pinThreads, jintArray coreClasses,
+        jint burstHoldMs) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    
+    // Core classes for {mel, embedding, wake word, VAD, burst}; missing entries keep the defaults
+    SchedulingConfig config;
+    config.pinThreads = pinThreads == JNI_TRUE;
+    config.burstHoldMs = burstHoldMs;
+    if (coreClasses) {
+        jint values[5] = {};
+        const jsize count = std::min<jsize>(env->GetArrayLength(coreClasses), 5);
+        env->GetIntArrayRegion(coreClasses, 0, count, values);
+        CoreClass* targets[5] = {&config.mel, &config.embedding, &config.wakeWord,
+                                 &config.vad, &config.burst};
+        for (jsize i = 0; i < count; i++) {
+            *targets[i] = coreClassFromInt(values[i]);
+        }
+    }
+    return detector->setSchedulingConfig(config) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setQueueConfig(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jintArray capacitiesMs, jint policy,
+        jint maxLagMs) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    
+    // Capacities for {samples, VAD, mels, features}; missing entries keep the defaults
+    QueueConfig config;
+    config.policy = policy >= 0 && policy <= static_cast<int>(OverloadPolicy::Degrade)
+                        ? static_cast<OverloadPolicy>(policy) : OverloadPolicy::DropOldest;
+    config.maxLagMs = maxLagMs;
+    if (capacitiesMs) {
+        jint values[4] = {};
+        const jsize count = std::min<jsize>(env->GetArrayLength(capacitiesMs), 4);
+        env->GetIntArrayRegion(capacitiesMs, 0, count, values);
+        int* targets[4] = {&config.sampleQueueMs, &config.vadQueueMs, &config.melQueueMs,
+                           &config.featureQueueMs};
+        for (jsize i = 0; i < count; i++) {
+            *targets[i] = values[i];
+        }
+    }
+    return detector->setQueueConfig(config) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setWakeWordPriority(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jint wakeWord, jboolean high) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector || wakeWord < 0) return JNI_FALSE;
+    return detector->setWakeWordPriority(static_cast<size_t>(wakeWord), high == JNI_TRUE)
+               ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_addWakeWord(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring modelPath) {
+    DetectorHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle || !modelPath) return -1;
+    
+    const char* pathChars = env->GetStringUTFChars(modelPath, nullptr);
+    std::string pathStr(pathChars);
+    env->ReleaseStringUTFChars(modelPath, pathChars);
+    
+    const int index = handle->detector.addWakeWord(pathStr);
+    if (index >= 0) {
+        handle->dispatcher.setWakeWords(env, handle->detector.wakeWordNames());
+    }
+    return index;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_removeWakeWord(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jstring name) {
+    DetectorHandle* handle = handleFromPtr(detectorPtr);
+    if (!handle || !name) return JNI_FALSE;
+    
+    const char* nameChars = env->GetStringUTFChars(name, nullptr);
+    std::string nameStr(nameChars);
+    env->ReleaseStringUTFChars(name, nameChars);
+    
+    if (!handle->detector.removeWakeWord(nameStr)) return JNI_FALSE;
+    handle->dispatcher.setWakeWords(env, handle->detector.wakeWordNames());
+    return JNI_TRUE;
+}
+
+JNIEXPORT jstring JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getPipelineStats(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return nullptr;
+    return env->NewStringUTF(detector->stats().toJson().c_str());
+}
+
+JNIEXPORT jstring JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getMemoryReport(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return nullptr;
+    return env->NewStringUTF(detector->memoryReport().toJson().c_str());
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setLowMemoryMode(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->setLowMemoryMode(enabled == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_trimMemory(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (detector) {
+        detector->trimMemory();
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_resetPipelineStats(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (detector) {
+        detector->resetStats();
+    }
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setAudioCapture(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enable, jint preRollMs,
+        jint postSilenceMs) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->setAudioCapture(enable == JNI_TRUE, preRollMs, postSilenceMs)
+               ? JNI_TRUE : JNI_FALSE;
+}
+
+// The capture ring itself, shared with Java without a copy. Java only reads it;
+// the returned buffer stays valid for the life of the detector.
+JNIEXPORT jobject JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getCaptureBuffer(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return nullptr;
+    const CaptureRing& ring = detector->captureRing();
+    if (ring.capacity() == 0) return nullptr;
+    return env->NewDirectByteBuffer(const_cast<int16_t*>(ring.data()),
+                                    static_cast<jlong>(ring.capacity() * sizeof(int16_t)));
+}
+
+JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_waitForCapture(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jlong sessionStart, jlong position,
+        jint timeoutMs) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return -1;
+    return detector->waitForCapture(static_cast<uint64_t>(sessionStart),
+                                    static_cast<uint64_t>(position), timeoutMs);
+}
+
+JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getCaptureOverwriteLimit(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return 0;
+    return static_cast<jlong>(detector->captureRing().overwriteLimit());
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_setScoreTelemetry(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enable) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    return detector->setScoreTelemetry(enable == JNI_TRUE) ? JNI_TRUE : JNI_FALSE;
+}
+
+// The score ring, shared with Java like the capture ring; polling it costs one
+// JNI call per bound, never one per frame
+JNIEXPORT jobject JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getScoreBuffer(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return nullptr;
+    const ScoreRing& ring = detector->scoreRing();
+    if (ring.capacity() == 0) return nullptr;
+    return env->NewDirectByteBuffer(const_cast<ScoreRecord*>(ring.data()),
+                                    static_cast<jlong>(ring.capacity() * sizeof(ScoreRecord)));
+}
+
+JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getScoreWritten(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return 0;
+    return static_cast<jlong>(detector->scoreRing().written());
+}
+
+JNIEXPORT jlong JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_getScoreOverwriteLimit(
+        JNIEnv* env, jobject thiz, jlong detectorPtr) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return 0;
+    return static_cast<jlong>(detector->scoreRing().overwriteLimit());
+}
+
+JNIEXPORT jboolean JNICALL Java_com_vinhpx_voiceassistant_WakeupDetectorJNI_enableVAD(
+        JNIEnv* env, jobject thiz, jlong detectorPtr, jboolean enabled) {
+    auto* detector = detectorFromPtr(detectorPtr);
+    if (!detector) return JNI_FALSE;
+    
+    // Call the enableVAD method
+    return detector->enableVAD(enabled) ? JNI_TRUE : JNI_FALSE;
+}
+
+} // extern "C"
\ No newline at end of file
@@ -0,0 +1,280 @@
+// Offline scoring for WakeupDetector: the streaming pipeline's stages run one
+// after another over a whole buffer instead of on worker threads. Every mel
+// block, embedding window and wake word window is independent of its
+// neighbours, so each stage is a batch of windows that can be stacked along the
+// model's batch dimension and split across threads.
+#include "wakeup_detector.h"
+#include "parallel_for.h"
+#include "platform_log.h"
+#include "wav_file.h"
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#define LOGI(...) PLATFORM_LOG(PLATFORM_LOG_INFO, "WakeupDetector", __VA_ARGS__)
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "WakeupDetector", __VA_ARGS__)
+
+namespace {
+
+// Run `session` over `count` windows of `windowShape` (leading dimension 1),
+// batched and in parallel. fill(i, dst) writes window i; the `outputFloats`
+// values window i produces are stored at output + i * outputFloats.
+template <size_t Rank, typename Fill>
+void runWindows(Ort::Session& session, const std::string& inputName, const std::string& outputName,
+                const std::array<int64_t, Rank>& windowShape, size_t outputFloats, size_t count,
+                const OfflineOptions& options, float* output, Fill&& fill) {
+    if (count == 0) return;
+    const size_t windowFloats = shapeElementCount(windowShape);
+    // Models exported with a fixed leading dimension run one window per Run()
+    const size_t batchLimit = hasDynamicBatch(session) ? std::max<size_t>(options.batchSize, 1) : 1;
+    const size_t batches = (count + batchLimit - 1) / batchLimit;
+    const auto memoryInfo = Ort::MemoryInfo::CreateCpu(
+        OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    const char* inputNames[] = {inputName.c_str()};
+    const char* outputNames[] = {outputName.c_str()};
+
+    parallelFor(batches, options.threads, [&](size_t batch) {
+        const size_t first = batch * batchLimit;
+        const size_t windows = std::min(batchLimit, count - first);
+
+        // Reused by every batch a thread runs
+        thread_local std::vector<float> stacked;
+        stacked.resize(windows * windowFloats);
+        for (size_t i = 0; i < windows; i++) {
+            fill(first + i, &stacked[i * windowFloats]);
+        }
+
+        std::array<int64_t, Rank> shape = windowShape;
+        shape[0] = static_cast<int64_t>(windows);
+        Ort::Value input = Ort::Value::CreateTensor<float>(memoryInfo, stacked.data(), stacked.size(),
+                                                           shape.data(), shape.size());
+        auto outputs = session.Run(Ort::RunOptions{nullptr}, inputNames, &input, 1, outputNames, 1);
+        if (outputs.front().GetTensorTypeAndShapeInfo().GetElementCount() != windows * outputFloats) {
+            throw std::runtime_error("batched output size does not match the single-window output");
+        }
+        std::memcpy(output + first * outputFloats, outputs.front().GetTensorData<float>(),
+                    windows * outputFloats * sizeof(float));
+    });
+}
+
+} // namespace
+
+// Mel frames for the whole buffer, scaled for the embedding model, in the
+// blocks the live mel stage would have consumed. melEndSamples[m] is the end of
+// the audio frame m depends on.
+void WakeupDetector::offlineMels(const int16_t* samples, size_t numSamples,
+                                 const OfflineOptions& options, std::vector<float>& mels,
+                                 std::vector<uint64_t>& melEndSamples) const {
+    if (!melSession) {
+        // The native front end carries overlap between chunks, so it runs in order;
+        // frame k covers the fftSize samples ending at (k + 1) * hopLength
+        MelFrontEnd frontEnd(chunkSamples);
+        std::vector<float> block(chunkSamples);
+        for (size_t offset = 0; offset + chunkSamples <= numSamples; offset += chunkSamples) {
+            convertPcm16(samples + offset, block.data(), nullptr, chunkSamples);
+            const size_t frames = frontEnd.process(block.data(), chunkSamples);
+            mels.insert(mels.end(), frontEnd.frames(), frontEnd.frames() + frames * numMels);
+        }
+        const size_t frames = mels.size() / numMels;
+        melEndSamples.resize(frames);
+        for (size_t k = 0; k < frames; k++) {
+            melEndSamples[k] = (k + 1) * MelFrontEnd::hopLength;
+        }
+        return;
+    }
+
+    // The mel model sees each frameSize block on its own, so blocks batch freely
+    const size_t blocks = numSamples / frameSize;
+    const size_t blockFloats = melOutput.size();
+    const size_t framesPerBlock = blockFloats / numMels;
+    mels.resize(blocks * blockFloats);
+    runWindows(*melSession, melInputName, melOutputName,
+               Geometry::melInputShape, blockFloats, blocks, options, mels.data(),
+               [&](size_t block, float* dst) {
+                   convertPcm16(samples + block * frameSize, dst, nullptr, frameSize);
+               });
+    for (float& value : mels) {
+        value = (value / 10.0f) + 2.0f;
+    }
+
+    // Frames are spread evenly over their block, to within one hop
+    melEndSamples.resize(blocks * framesPerBlock);
+    for (size_t m = 0; m < melEndSamples.size(); m++) {
+        const size_t block = m / framesPerBlock;
+        const size_t frame = m % framesPerBlock;
+        melEndSamples[m] = block * frameSize + (frame + 1) * frameSize / framesPerBlock;
+    }
+}
+
+OfflineResult WakeupDetector::processBuffer(const int16_t* samples, size_t numSamples,
+                                            const OfflineOptions& options) const {
+    OfflineResult result;
+    result.samples = numSamples;
+    if (!isInitialized) {
+        LOGE("Cannot process offline: not initialized");
+        return result;
+    }
+    if (isRunning) {
+        LOGE("Cannot process offline while the detector is running");
+        return result;
+    }
+
+    try {
+        std::vector<float> mels;
+        std::vector<uint64_t> melEndSamples;
+        if (samples && numSamples > 0) {
+            offlineMels(samples, numSamples, options, mels, melEndSamples);
+        }
+        const size_t melFrames = melEndSamples.size();
+
+        // One embedding per embStepSize mel frames once a full window is available
+        const size_t embeddings = melFrames >= embWindowSize
+            ? (melFrames - embWindowSize) / embStepSize + 1 : 0;
+        std::vector<float> features(embeddings * embFeatures);
+        runWindows(*embSession, embInputName, embOutputName,
+                   Geometry::embInputShape, embFeatures, embeddings, options, features.data(),
+                   [&](size_t window, float* dst) {
+                       std::memcpy(dst, &mels[window * embStepSize * numMels],
+                                   Geometry::embInputFloats * sizeof(float));
+                   });
+
+        // One wake word frame per embedding once the widest head's window is
+        // available; every head scores the window ending at the same embedding
+        const auto table = loadedTable();
+        const size_t windowFrames = table->windowFrames;
+        const size_t frames = embeddings >= windowFrames ? embeddings - windowFrames + 1 : 0;
+        result.frameEndSamples.resize(frames);
+        for (size_t f = 0; f < frames; f++) {
+            const size_t newestEmbedding = f + windowFrames - 1;
+            result.frameEndSamples[f] =
+                melEndSamples[newestEmbedding * embStepSize + embWindowSize - 1];
+        }
+
+        // Free wake word indices get no scores
+        result.scores.resize(table->heads.size());
+        result.scoresPerFrame.resize(table->heads.size());
+        result.evaluatedFrames.assign(table->heads.size(), 0);
+        for (size_t h = 0; h < table->heads.size(); h++) {
+            if (!table->heads[h]) continue;
+            const auto& head = *table->heads[h];
+            result.evaluatedFrames[h] = frames;
+            const size_t perFrame = head.scores.size();
+            result.scoresPerFrame[h] = perFrame;
+            result.scores[h].resize(frames * perFrame);
+            const size_t headOffset = windowFrames - head.frames;
+            runWindows(*head.session, head.inputName, head.outputName, head.inputShape,
+                       perFrame, frames, options, result.scores[h].data(),
+                       [&](size_t window, float* dst) {
+                           std::memcpy(dst, &features[(window + headOffset) * embFeatures],
+                                       head.frames * embFeatures * sizeof(float));
+                       });
+            if (options.cascade && head.firstStage) {
+                result.evaluatedFrames[h] = applyCascade(head, features, windowFrames, frames,
+                                                         options, result.scores[h]);
+            }
+
+            // Same activation and refractory rule as updateActivation(), from a fresh start()
+            int activation = 0;
+            for (size_t i = 0; i < result.scores[h].size(); i++) {
+                const float probability = result.scores[h][i];
+                if (probability > threshold) {
+                    if (++activation >= triggerLevel) {
+                        result.detections.push_back(
+                            {h, result.frameEndSamples[i / perFrame], probability});
+                        activation = -refractory;
+                    }
+                } else if (activation > 0) {
+                    activation = std::max(0, activation - 1);
+                } else {
+                    activation = std::min(0, activation + 1);
+                }
+            }
+        }
+        std::stable_sort(result.detections.begin(), result.detections.end(),
+                         [](const OfflineDetection& a, const OfflineDetection& b) {
+                             return a.sample < b.sample;
+                         });
+        result.ok = true;
+    } catch (const std::exception& e) {
+        LOGE("Error in offline processing: %s", e.what());
+    }
+    return result;
+}
+
+// Zero the frames the live cascade would not have evaluated. Every frame is
+// scored by the full model above, since whether the live detector evaluates a
+// frame depends on the activation its earlier scores built up; returns how
+// many frames the full model would have run on.
+size_t WakeupDetector::applyCascade(const WakeWordHead& head, const std::vector<float>& features,
+                                    size_t windowFrames, size_t frames,
+                                    const OfflineOptions& options,
+                                    std::vector<float>& scores) const {
+    const size_t gatesPerFrame = head.firstStageScores.size();
+    std::vector<float> gates(frames * gatesPerFrame);
+    const size_t headOffset = windowFrames - head.frames;
+    runWindows(*head.firstStage, head.firstStageInputName, head.firstStageOutputName,
+               head.inputShape, gatesPerFrame, frames, options, gates.data(),
+               [&](size_t window, float* dst) {
+                   std::memcpy(dst, &features[(window + headOffset) * embFeatures],
+                               head.frames * embFeatures * sizeof(float));
+               });
+
+    // Mirrors featuresToOutput() and updateActivation()
+    const size_t perFrame = head.scores.size();
+    size_t evaluated = 0;
+    int hold = 0;
+    int activation = 0;
+    for (size_t f = 0; f < frames; f++) {
+        const float* gate = &gates[f * gatesPerFrame];
+        if (*std::max_element(gate, gate + gatesPerFrame) > cascadeThreshold) {
+            hold = cascadeHoldFrames;
+        }
+        const bool run = hold > 0 || activation > 0;
+        if (hold > 0) {
+            hold--;
+        }
+        float* frameScores = &scores[f * perFrame];
+        if (run) {
+            evaluated++;
+        } else {
+            std::fill(frameScores, frameScores + perFrame, 0.0f);
+        }
+        for (size_t i = 0; i < perFrame; i++) {
+            if (frameScores[i] > threshold) {
+                if (++activation >= triggerLevel) {
+                    activation = -refractory;
+                }
+            } else if (activation > 0) {
+                activation = std::max(0, activation - 1);
+            } else {
+                activation = std::min(0, activation + 1);
+            }
+        }
+    }
+    return evaluated;
+}
+
+OfflineResult WakeupDetector::processFile(const std::string& wavPath,
+                                          const OfflineOptions& options) const {
+    std::vector<int16_t> samples;
+    if (!readWavFile(wavPath, samples)) {
+        return OfflineResult();
+    }
+    return processBuffer(samples.data(), samples.size(), options);
+}
+
+// Files are the unit of parallelism here: each is scored on one thread, which
+// avoids splitting short clips into batches too small to be worth a Run()
+std::vector<OfflineResult> WakeupDetector::processFiles(const std::vector<std::string>& wavPaths,
+                                                        const OfflineOptions& options) const {
+    std::vector<OfflineResult> results(wavPaths.size());
+    OfflineOptions perFile = options;
+    perFile.threads = 1;
+    parallelFor(wavPaths.size(), options.threads, [&](size_t i) {
+        results[i] = processFile(wavPaths[i], perFile);
+    });
+    LOGI("Scored %zu files offline", wavPaths.size());
+    return results;
+}
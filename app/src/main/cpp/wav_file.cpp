@@ -0,0 +1,68 @@
+#include "wav_file.h"
+#include "platform_log.h"
+
+#include <cstring>
+#include <fstream>
+
+#define LOGE(...) PLATFORM_LOG(PLATFORM_LOG_ERROR, "WavFile", __VA_ARGS__)
+
+namespace {
+
+constexpr uint32_t wavSampleRate = 16000;
+
+} // namespace
+
+bool readWavFile(const std::string& path, std::vector<int16_t>& samples) {
+    uint32_t rate = 0;
+    if (!readWavFile(path, samples, rate)) return false;
+    if (rate != wavSampleRate) {
+        LOGE("%s: need 16 kHz audio (got %u Hz)", path.c_str(), rate);
+        return false;
+    }
+    return true;
+}
+
+bool readWavFile(const std::string& path, std::vector<int16_t>& samples, uint32_t& sampleRate) {
+    std::ifstream file(path, std::ios::binary);
+    char riff[12];
+    if (!file.read(riff, sizeof(riff)) || std::memcmp(riff, "RIFF", 4) != 0 ||
+        std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        LOGE("%s: not a RIFF/WAVE file", path.c_str());
+        return false;
+    }
+
+    bool haveFormat = false;
+    char header[8];
+    while (file.read(header, sizeof(header))) {
+        uint32_t size = 0;
+        std::memcpy(&size, header + 4, sizeof(size));
+        if (std::memcmp(header, "fmt ", 4) == 0) {
+            std::vector<char> fmt(size);
+            if (size < 16 || !file.read(fmt.data(), size)) break;
+            if (size & 1) file.seekg(1, std::ios::cur);
+            uint16_t format = 0, channels = 0, bits = 0;
+            uint32_t rate = 0;
+            std::memcpy(&format, &fmt[0], 2);
+            std::memcpy(&channels, &fmt[2], 2);
+            std::memcpy(&rate, &fmt[4], 4);
+            std::memcpy(&bits, &fmt[14], 2);
+            if (format != 1 || channels != 1 || bits != 16 || rate == 0) {
+                LOGE("%s: need mono PCM16 (got format %u, %u ch, %u bit, %u Hz)",
+                     path.c_str(), format, channels, bits, rate);
+                return false;
+            }
+            sampleRate = rate;
+            haveFormat = true;
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            if (!haveFormat) break;
+            samples.resize(size / sizeof(int16_t));
+            file.read(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(int16_t));
+            samples.resize(static_cast<size_t>(file.gcount()) / sizeof(int16_t));
+            return true;
+        } else {
+            file.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+    LOGE("%s: no PCM data chunk", path.c_str());
+    return false;
+}
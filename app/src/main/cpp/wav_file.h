@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal RIFF reader for the pipeline's input format, 16 kHz mono PCM16.
+// Other formats are rejected rather than converted; returns false and logs why.
+bool readWavFile(const std::string& path, std::vector<int16_t>& samples);
+
+// The same for mono PCM16 at any sample rate, which is returned in `sampleRate`
+bool readWavFile(const std::string& path, std::vector<int16_t>& samples, uint32_t& sampleRate);
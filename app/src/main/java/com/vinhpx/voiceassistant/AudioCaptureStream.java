@@ -0,0 +1,86 @@
+package com.vinhpx.voiceassistant;
+
+import android.util.Log;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Blocking reader over one capture session of the native capture ring.
+ * Audio is copied straight from the ring shared with native code, so a
+ * recognizer can consume the utterance while the user is still speaking.
+ */
+public class AudioCaptureStream {
+    private static final String TAG = "AudioCaptureStream";
+    private static final int WAIT_TIMEOUT_MS = 100;
+
+    private final WakeupDetectorJNI detector;
+    private final ByteBuffer ring;  // private duplicate, its position is ours
+    private final long ringMask;
+    private final long sessionStart;
+    private long position;
+    private volatile boolean closed = false;
+
+    AudioCaptureStream(WakeupDetectorJNI detector, ByteBuffer ring, long sessionStart) {
+        this.detector = detector;
+        this.ring = ring.duplicate();
+        this.ringMask = ring.capacity() / 2 - 1;
+        this.sessionStart = sessionStart;
+        this.position = sessionStart;
+    }
+
+    /**
+     * Copy the next captured 16-bit PCM samples (native byte order) into buffer,
+     * blocking until audio is available. If this reader falls so far behind that
+     * the ring overwrote its audio, it skips ahead to the oldest intact sample.
+     *
+     * @param buffer Destination; only whole samples are written
+     * @return The number of bytes read, or 0 once the session has ended or close() was called
+     */
+    public int read(byte[] buffer) {
+        int maxSamples = buffer.length / 2;
+        while (!closed && maxSamples > 0) {
+            long available = detector.waitForCapture(sessionStart, position, WAIT_TIMEOUT_MS);
+            if (available < 0) {
+                return 0;
+            }
+            if (available == position) {
+                continue; // Timed out, check closed
+            }
+            int count = (int) Math.min(maxSamples, available - position);
+            copy(position, buffer, count);
+
+            long limit = detector.getCaptureOverwriteLimit();
+            if (position < limit) {
+                Log.w(TAG, "Capture reader fell behind by " + (limit - position) + " samples, skipping ahead");
+                position = limit;
+                continue;
+            }
+            position += count;
+            return count * 2;
+        }
+        return 0;
+    }
+
+    /**
+     * Ring position of the next sample read() returns
+     */
+    public long getPosition() {
+        return position;
+    }
+
+    /**
+     * Make read() return end of stream; safe from any thread
+     */
+    public void close() {
+        closed = true;
+    }
+
+    private void copy(long from, byte[] buffer, int count) {
+        int offset = (int) (from & ringMask);
+        int first = Math.min(count, (int) (ringMask + 1) - offset);
+        ring.position(offset * 2);
+        ring.get(buffer, 0, first * 2);
+        ring.position(0);
+        ring.get(buffer, first * 2, (count - first) * 2);
+    }
+}
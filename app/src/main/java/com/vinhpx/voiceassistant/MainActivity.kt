@@ -176,8 +176,8 @@ class MainActivity : AppCompatActivity(), WakeupDetectorCallback {
         // Show that we're listening for user speech
         binding.statusText.text = "Listening... (after '$wakeWord')"
         
-        // Audio will be automatically captured and sent to Azure Speech SDK
-        // by the WakeupDetectorService's onAudioCaptureCompleted method
+        // The native capture session is streamed to the Azure Speech SDK
+        // by the WakeupDetectorService while the user speaks
     }
     
     // Override audio capture completion to handle results from speech recognition
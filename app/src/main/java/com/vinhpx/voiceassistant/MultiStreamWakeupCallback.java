@@ -0,0 +1,49 @@
+package com.vinhpx.voiceassistant;
+
+/**
+ * Callback interface for MultiStreamWakeupDetectorJNI; every event carries the id
+ * returned by addStream() for the stream it happened on.
+ */
+public interface MultiStreamWakeupCallback {
+    /**
+     * Called when a wake word is detected on a stream.
+     *
+     * @param streamId The stream the wake word was heard on
+     * @param wakeWord The name of the detected wake word
+     */
+    void onWakeWordDetected(int streamId, String wakeWord);
+
+    /**
+     * Called when a detection score is available. The native detector does not
+     * deliver per-frame scores through callbacks, so this is never called.
+     *
+     * @param streamId The stream the score belongs to
+     * @param wakeWord The name of the wake word model
+     * @param score The detection score (0.0-1.0)
+     * @param threshold The current threshold
+     * @param activation The current activation level
+     * @param triggerLevel The trigger level required for detection
+     */
+    default void onDetectionScoreUpdate(int streamId, String wakeWord, float score, float threshold,
+                                        int activation, int triggerLevel) {
+        // Default empty implementation - optional to implement
+    }
+
+    /**
+     * Called when voice activity starts on a stream.
+     *
+     * @param streamId The stream with voice activity
+     */
+    default void onVoiceActivityStarted(int streamId) {
+        // Default empty implementation - optional to implement
+    }
+
+    /**
+     * Called when voice activity ends on a stream.
+     *
+     * @param streamId The stream whose voice activity ended
+     */
+    default void onVoiceActivityEnded(int streamId) {
+        // Default empty implementation - optional to implement
+    }
+}
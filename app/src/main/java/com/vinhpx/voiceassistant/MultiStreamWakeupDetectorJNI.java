@@ -0,0 +1,224 @@
+package com.vinhpx.voiceassistant;
+
+import java.nio.ByteBuffer;
+
+/**
+ * JNI wrapper for the native multi-stream wake-up word detector. One set of models
+ * scores many audio streams (microphone beams, remote clients), each with its own
+ * buffers, VAD state and activation counters; streams that have audio ready at the
+ * same time are run through the models as one batch.
+ */
+public class MultiStreamWakeupDetectorJNI implements MultiStreamWakeupCallback {
+
+    // Load the native library
+    static {
+        System.loadLibrary("voiceassistant");
+    }
+
+    // Pointer to the native MultiStreamDetector object
+    private long nativeDetectorPtr;
+    private MultiStreamWakeupCallback callback;
+
+    /**
+     * Create a new MultiStreamWakeupDetectorJNI instance
+     */
+    public MultiStreamWakeupDetectorJNI() {
+        nativeDetectorPtr = createMultiStreamDetector();
+    }
+
+    /**
+     * Initialize the detector with model paths
+     *
+     * @param melModelPath Path to the mel spectrogram ONNX model
+     * @param embModelPath Path to the embedding ONNX model
+     * @param wwModelPaths Array of paths to wake word ONNX models
+     * @param maxStreams Number of stream slots to preallocate
+     * @return true if initialization succeeded
+     */
+    public boolean initialize(String melModelPath, String embModelPath, String[] wwModelPaths,
+                              int maxStreams) {
+        return initializeDetector(nativeDetectorPtr, melModelPath, embModelPath, wwModelPaths,
+                maxStreams, null, null);
+    }
+
+    /**
+     * Initialize the detector with model paths, an execution provider and a model precision per stage
+     *
+     * @param melModelPath Path to the FP32 mel spectrogram ONNX model
+     * @param embModelPath Path to the FP32 embedding ONNX model
+     * @param wwModelPaths Array of paths to FP32 wake word ONNX models
+     * @param maxStreams Number of stream slots to preallocate
+     * @param providers WakeupDetectorJNI.PROVIDER_* values for {mel, embedding, wake word, VAD},
+     *                  or null for CPU
+     * @param precisions WakeupDetectorJNI.PRECISION_* values for {mel, embedding, wake word},
+     *                   or null for FP32
+     * @return true if initialization succeeded
+     */
+    public boolean initialize(String melModelPath, String embModelPath, String[] wwModelPaths,
+                              int maxStreams, int[] providers, int[] precisions) {
+        return initializeDetector(nativeDetectorPtr, melModelPath, embModelPath, wwModelPaths,
+                maxStreams, providers, precisions);
+    }
+
+    /**
+     * Initialize VAD for every stream; all streams share one VAD model
+     *
+     * @param vadModelPath Path to the VAD (Voice Activity Detection) ONNX model
+     * @return true if initialization succeeded
+     */
+    public boolean initializeVAD(String vadModelPath) {
+        return initializeVAD(nativeDetectorPtr, vadModelPath);
+    }
+
+    /**
+     * Compute mel spectrograms natively instead of with the mel ONNX model.
+     * Takes effect at the next initialize(), whose mel model path is then ignored.
+     *
+     * @param enabled True to use the native mel front end
+     * @return false if the detector is running
+     */
+    public boolean setNativeMelFrontEnd(boolean enabled) {
+        return setNativeMelFrontEnd(nativeDetectorPtr, enabled);
+    }
+
+    /**
+     * Claim a stream slot; may be called while the detector is running
+     *
+     * @return The stream id to pass to processAudio(), or -1 if every slot is in use
+     */
+    public int addStream() {
+        return addStream(nativeDetectorPtr);
+    }
+
+    /**
+     * Release a stream slot and drop its buffered audio. Do not call processAudio()
+     * for the stream while it is being removed.
+     *
+     * @param streamId Id returned by addStream()
+     * @return true if the stream was active
+     */
+    public boolean removeStream(int streamId) {
+        return removeStream(nativeDetectorPtr, streamId);
+    }
+
+    /**
+     * Start the detector
+     *
+     * @return true if starting succeeded
+     */
+    public boolean start() {
+        return startDetector(nativeDetectorPtr);
+    }
+
+    /**
+     * Stop the detector
+     */
+    public void stop() {
+        stopDetector(nativeDetectorPtr);
+    }
+
+    /**
+     * Process audio data for one stream
+     *
+     * @param streamId Id returned by addStream()
+     * @param audioData Array of audio samples (16-bit PCM)
+     * @param numSamples Number of samples in the array
+     */
+    public void processAudio(int streamId, short[] audioData, int numSamples) {
+        processAudio(nativeDetectorPtr, streamId, audioData, numSamples);
+    }
+
+    /**
+     * Process audio data for one stream from a direct buffer without copying it
+     *
+     * @param streamId Id returned by addStream()
+     * @param audioData Direct ByteBuffer of 16-bit PCM samples in native byte order
+     * @param numSamples Number of samples in the buffer
+     */
+    public void processAudio(int streamId, ByteBuffer audioData, int numSamples) {
+        processAudioDirect(nativeDetectorPtr, streamId, audioData, numSamples);
+    }
+
+    /**
+     * Set the callback for wake word detection events
+     *
+     * @param callback The callback to receive events
+     */
+    public void setCallback(MultiStreamWakeupCallback callback) {
+        this.callback = callback;
+    }
+
+    /**
+     * Latency and CPU statistics over all streams since the last reset, as a JSON
+     * object in the format of WakeupDetectorJNI.getPipelineStats(); each compute
+     * sample covers one batch.
+     *
+     * @return JSON statistics, or null if the detector has been released
+     */
+    public String getPipelineStats() {
+        return getPipelineStats(nativeDetectorPtr);
+    }
+
+    /**
+     * Clear the statistics returned by getPipelineStats()
+     */
+    public void resetPipelineStats() {
+        resetPipelineStats(nativeDetectorPtr);
+    }
+
+    /**
+     * Release native resources
+     */
+    public void release() {
+        destroyMultiStreamDetector(nativeDetectorPtr);
+        nativeDetectorPtr = 0;
+    }
+
+    @Override
+    public void onWakeWordDetected(int streamId, String wakeWord) {
+        if (callback != null) {
+            callback.onWakeWordDetected(streamId, wakeWord);
+        }
+    }
+
+    @Override
+    public void onDetectionScoreUpdate(int streamId, String wakeWord, float score, float threshold,
+                                       int activation, int triggerLevel) {
+        if (callback != null) {
+            callback.onDetectionScoreUpdate(streamId, wakeWord, score, threshold, activation,
+                    triggerLevel);
+        }
+    }
+
+    @Override
+    public void onVoiceActivityStarted(int streamId) {
+        if (callback != null) {
+            callback.onVoiceActivityStarted(streamId);
+        }
+    }
+
+    @Override
+    public void onVoiceActivityEnded(int streamId) {
+        if (callback != null) {
+            callback.onVoiceActivityEnded(streamId);
+        }
+    }
+
+    // Native methods - implemented in C++
+    private native long createMultiStreamDetector();
+    private native boolean initializeDetector(long detectorPtr, String melModelPath,
+                                              String embModelPath, String[] wwModelPaths,
+                                              int maxStreams, int[] providers, int[] precisions);
+    private native boolean initializeVAD(long detectorPtr, String vadModelPath);
+    private native boolean setNativeMelFrontEnd(long detectorPtr, boolean enabled);
+    private native int addStream(long detectorPtr);
+    private native boolean removeStream(long detectorPtr, int streamId);
+    private native boolean startDetector(long detectorPtr);
+    private native void stopDetector(long detectorPtr);
+    private native void processAudio(long detectorPtr, int streamId, short[] audioData, int numSamples);
+    private native void processAudioDirect(long detectorPtr, int streamId, ByteBuffer audioData,
+                                           int numSamples);
+    private native String getPipelineStats(long detectorPtr);
+    private native void resetPipelineStats(long detectorPtr);
+    private native void destroyMultiStreamDetector(long detectorPtr);
+}
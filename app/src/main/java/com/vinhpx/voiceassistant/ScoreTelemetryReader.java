@@ -0,0 +1,91 @@
+package com.vinhpx.voiceassistant;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Polling reader over the native score ring. Each poll() reads the ring bounds with
+ * two JNI calls and copies the new records straight from the buffer shared with native
+ * code, however many frames were scored since the last poll, so a UI or tuning tool
+ * can sample every score at its own rate without slowing the inference thread.
+ * Not thread-safe; give each polling thread its own reader.
+ */
+public class ScoreTelemetryReader {
+    private static final int RECORD_BYTES = 16;
+
+    /**
+     * Receives the records of one poll(), oldest first
+     */
+    public interface Listener {
+        /**
+         * @param wakeWord Index of the wake word model in the list passed to initialize()
+         * @param originNanos Arrival of the newest audio scored, System.nanoTime() clock
+         * @param score The score of this output
+         * @param activation The wake word's activation after this score
+         */
+        void onScore(int wakeWord, long originNanos, float score, int activation);
+    }
+
+    private final WakeupDetectorJNI detector;
+    private final ByteBuffer ring;
+    private final int capacity;
+    private long position;
+    private long missed = 0;
+
+    // One poll's records, copied before they are validated against the overwrite limit
+    private final long[] origins;
+    private final float[] scores;
+    private final short[] wakeWords;
+    private final short[] activations;
+
+    ScoreTelemetryReader(WakeupDetectorJNI detector, ByteBuffer ring, long position) {
+        this.detector = detector;
+        this.ring = ring;
+        this.capacity = ring.capacity() / RECORD_BYTES;
+        this.position = position;
+        origins = new long[capacity];
+        scores = new float[capacity];
+        wakeWords = new short[capacity];
+        activations = new short[capacity];
+    }
+
+    /**
+     * Deliver every record written since the last poll. Records the ring overwrote before
+     * they could be read are skipped and counted in getMissedRecords().
+     *
+     * @param listener Receives the records, on the calling thread
+     * @return The number of records delivered
+     */
+    public int poll(Listener listener) {
+        long written = detector.getScoreWritten();
+        long limit = detector.getScoreOverwriteLimit();
+        if (position < limit) {
+            missed += limit - position;
+            position = limit;
+        }
+        int count = (int) Math.min(written - position, capacity);
+        for (int i = 0; i < count; i++) {
+            int offset = (int) ((position + i) % capacity) * RECORD_BYTES;
+            origins[i] = ring.getLong(offset);
+            scores[i] = ring.getFloat(offset + 8);
+            wakeWords[i] = ring.getShort(offset + 12);
+            activations[i] = ring.getShort(offset + 14);
+        }
+
+        // Anything below the limit now may have been overwritten while it was copied
+        limit = detector.getScoreOverwriteLimit();
+        int first = (int) Math.max(0, Math.min(count, limit - position));
+        missed += first;
+        for (int i = first; i < count; i++) {
+            listener.onScore(wakeWords[i] & 0xffff, origins[i], scores[i], activations[i]);
+        }
+        position += count;
+        return count - first;
+    }
+
+    /**
+     * Records lost because this reader polled too rarely for the ring's 4096 records
+     */
+    public long getMissedRecords() {
+        return missed;
+    }
+}
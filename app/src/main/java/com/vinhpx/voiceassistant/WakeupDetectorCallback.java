@@ -12,7 +12,9 @@ public interface WakeupDetectorCallback {
     void onWakeWordDetected(String wakeWord);
     
     /**
-     * Called when a detection score is available.
+     * Called when a detection score is available. The native detector no longer
+     * delivers per-frame scores through callbacks; poll them with
+     * {@link WakeupDetectorJNI#openScoreReader()} instead.
      * 
      * @param wakeWord The name of the wake word model
      * @param score The detection score (0.0-1.0)
@@ -38,6 +40,27 @@ public interface WakeupDetectorCallback {
         // Default empty implementation - optional to implement
     }
     
+    /**
+     * Called when voice activity is detected. Calls onVoiceActivityStarted() unless overridden.
+     * 
+     * @param samplePosition First sample of the speech, counted in samples passed to
+     *                       processAudio() since start() while VAD was enabled
+     */
+    default void onVoiceActivityStarted(long samplePosition) {
+        onVoiceActivityStarted();
+    }
+    
+    /**
+     * Called when voice activity has ended, once the endpointing hangover has passed.
+     * Calls onVoiceActivityEnded() unless overridden.
+     * 
+     * @param samplePosition One past the last sample of speech, on the same clock as
+     *                       onVoiceActivityStarted(long)
+     */
+    default void onVoiceActivityEnded(long samplePosition) {
+        onVoiceActivityEnded();
+    }
+    
     /**
      * Called when collected audio after wake word detection is ready.
      * 
@@ -48,4 +71,24 @@ public interface WakeupDetectorCallback {
     default void onAudioCaptureCompleted(String wakeWord, short[] audioData, int sampleRate) {
         // Default empty implementation - optional to implement
     }
+    
+    /**
+     * Called when a wake word opens a capture session in the native capture ring.
+     * 
+     * @param wakeWord The name of the wake word that triggered the audio capture
+     * @param startPosition Ring position of the first sample, including the pre-roll
+     */
+    default void onAudioCaptureStarted(String wakeWord, long startPosition) {
+        // Default empty implementation - optional to implement
+    }
+    
+    /**
+     * Called when the capture session has recorded its last sample.
+     * 
+     * @param wakeWord The name of the wake word that triggered the audio capture
+     * @param endPosition Ring position one past the last sample
+     */
+    default void onAudioCaptureEnded(String wakeWord, long endPosition) {
+        // Default empty implementation - optional to implement
+    }
 }
\ No newline at end of file
@@ -1,10 +1,43 @@
 package com.vinhpx.voiceassistant;
 
+import android.content.res.AssetManager;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.ShortBuffer;
+
 /**
  * JNI wrapper for the native wake-up word detector.
  */
 public class WakeupDetectorJNI implements WakeupDetectorCallback {
 
+    // Execution providers for initialize(); a stage falls back to CPU if its provider rejects the model
+    public static final int PROVIDER_CPU = 0;
+    public static final int PROVIDER_NNAPI = 1;
+    public static final int PROVIDER_XNNPACK = 2;
+
+    // Model precisions for initialize(); a stage loads <model>.fp16.onnx, <model>.int8.onnx or
+    // <model>.int8_static.onnx from next to its FP32 model, or the FP32 model if the variant is missing
+    public static final int PRECISION_FP32 = 0;
+    public static final int PRECISION_FP16 = 1;
+    public static final int PRECISION_INT8_DYNAMIC = 2;
+    public static final int PRECISION_INT8_STATIC = 3;
+
+    // Core classes for setSchedulingConfig(); on symmetric CPUs every class means all cores
+    public static final int CORES_ANY = 0;
+    public static final int CORES_EFFICIENCY = 1;
+    public static final int CORES_PERFORMANCE = 2;
+
+    // Overload policies for setQueueConfig(), applied by a stage that falls more than
+    // maxLagMs behind real time
+    public static final int OVERLOAD_DROP_NEWEST = 0;
+    public static final int OVERLOAD_DROP_OLDEST = 1;
+    public static final int OVERLOAD_SKIP_TO_LIVE = 2;
+    public static final int OVERLOAD_DEGRADE = 3;
+
+    // Prefix for model paths inside the APK, e.g. "asset:models/embedding_model.onnx".
+    // Such models are memory-mapped in place; keep them uncompressed (androidResources.noCompress).
+    public static final String ASSET_PREFIX = "asset:";
+
     // Load the native library
     static {
         System.loadLibrary("voiceassistant");
@@ -13,6 +46,10 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
     // Pointer to the native WakeupDetector object
     private long nativeDetectorPtr;
     private WakeupDetectorCallback callback;
+    // Read-only view of the native capture ring, created on first use
+    private ByteBuffer captureBuffer;
+    // Read-only view of the native score ring, created on first use
+    private ByteBuffer scoreBuffer;
 
     /**
      * Create a new WakeupDetectorJNI instance
@@ -30,11 +67,41 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
      * @return true if initialization succeeded
      */
     public boolean initialize(String melModelPath, String embModelPath, String[] wwModelPaths) {
-        return initializeDetector(nativeDetectorPtr, melModelPath, embModelPath, wwModelPaths);
+        return initializeDetector(nativeDetectorPtr, melModelPath, embModelPath, wwModelPaths, null, null);
+    }
+
+    /**
+     * Initialize the detector with model paths and an execution provider per stage
+     *
+     * @param melModelPath Path to the mel spectrogram ONNX model
+     * @param embModelPath Path to the embedding ONNX model
+     * @param wwModelPaths Array of paths to wake word ONNX models
+     * @param providers PROVIDER_* values for {mel, embedding, wake word, VAD}; missing entries use CPU
+     * @return true if initialization succeeded
+     */
+    public boolean initialize(String melModelPath, String embModelPath, String[] wwModelPaths,
+                              int[] providers) {
+        return initializeDetector(nativeDetectorPtr, melModelPath, embModelPath, wwModelPaths, providers, null);
+    }
+
+    /**
+     * Initialize the detector with model paths, an execution provider and a model precision per stage
+     *
+     * @param melModelPath Path to the FP32 mel spectrogram ONNX model
+     * @param embModelPath Path to the FP32 embedding ONNX model
+     * @param wwModelPaths Array of paths to FP32 wake word ONNX models
+     * @param providers PROVIDER_* values for {mel, embedding, wake word, VAD}, or null for CPU
+     * @param precisions PRECISION_* values for {mel, embedding, wake word}, or null for FP32
+     * @return true if initialization succeeded
+     */
+    public boolean initialize(String melModelPath, String embModelPath, String[] wwModelPaths,
+                              int[] providers, int[] precisions) {
+        return initializeDetector(nativeDetectorPtr, melModelPath, embModelPath, wwModelPaths,
+                providers, precisions);
     }
     
     /**
-     * Initialize the VAD detector with model path
+     * Initialize the VAD detector with model path, on the VAD provider passed to initialize()
      * 
      * @param vadModelPath Path to the VAD (Voice Activity Detection) ONNX model
      * @return true if initialization succeeded
@@ -59,6 +126,26 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
         stopDetector(nativeDetectorPtr);
     }
 
+    /**
+     * Stop consuming audio while keeping the native threads and models loaded.
+     * Buffered audio is dropped and detection state is reset; processAudio()
+     * calls are ignored until resume().
+     *
+     * @return false if the detector is not running
+     */
+    public boolean pause() {
+        return pauseDetector(nativeDetectorPtr);
+    }
+
+    /**
+     * Continue detection after pause(), as if the detector had been restarted
+     *
+     * @return false if the detector is not running
+     */
+    public boolean resume() {
+        return resumeDetector(nativeDetectorPtr);
+    }
+
     /**
      * Process audio data
      *
@@ -69,6 +156,29 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
         processAudio(nativeDetectorPtr, audioData, numSamples);
     }
 
+    /**
+     * Set the sample rate of the audio passed to processAudio(), so a recorder can run at
+     * the device's native rate (typically 48000 or 44100 Hz) instead of going through the
+     * framework resampler. Other rates than 16000 Hz are resampled natively, adding about
+     * 1 ms of delay; captured audio is always 16000 Hz. Call while stopped.
+     *
+     * @param sampleRate Input sample rate in Hz (default 16000)
+     * @return false if the detector is running or the rate is not supported
+     */
+    public boolean setInputSampleRate(int sampleRate) {
+        return setInputSampleRate(nativeDetectorPtr, sampleRate);
+    }
+
+    /**
+     * Process audio data from a direct buffer without copying it
+     *
+     * @param audioData Direct ByteBuffer of 16-bit PCM samples in native byte order
+     * @param numSamples Number of samples in the buffer
+     */
+    public void processAudio(ByteBuffer audioData, int numSamples) {
+        processAudioDirect(nativeDetectorPtr, audioData, numSamples);
+    }
+
     /**
      * Set the callback for wake word detection events
      *
@@ -84,6 +194,8 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
     public void release() {
         destroyWakeupDetector(nativeDetectorPtr);
         nativeDetectorPtr = 0;
+        captureBuffer = null;
+        scoreBuffer = null;
     }
 
     @Override
@@ -122,6 +234,132 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
         }
     }
     
+    @Override
+    public void onAudioCaptureStarted(String wakeWord, long startPosition) {
+        if (callback != null) {
+            callback.onAudioCaptureStarted(wakeWord, startPosition);
+        }
+    }
+    
+    @Override
+    public void onAudioCaptureEnded(String wakeWord, long endPosition) {
+        if (callback != null) {
+            callback.onAudioCaptureEnded(wakeWord, endPosition);
+        }
+    }
+    
+    /**
+     * Keep the raw audio around each detection in a native ring (~16 s). A detection opens a
+     * capture session reported through onAudioCaptureStarted(); it ends postSilenceMs after
+     * VAD reports the end of speech, or after 12 s, and is reported through
+     * onAudioCaptureEnded(). Call while the detector is stopped.
+     *
+     * @param enabled True to capture post-wake audio
+     * @param preRollMs Audio kept from before the detection
+     * @param postSilenceMs Audio kept after the end of speech
+     * @return false if the detector is running
+     */
+    public boolean setAudioCapture(boolean enabled, int preRollMs, int postSilenceMs) {
+        return setAudioCapture(nativeDetectorPtr, enabled, preRollMs, postSilenceMs);
+    }
+    
+    /**
+     * The native capture ring as a read-only direct buffer of 16-bit samples in native byte
+     * order; ring position p is sample (p % capacity). Audio older than the ring capacity is
+     * overwritten without notice, so prefer openCaptureStream() or readCapturedAudio().
+     *
+     * @return The ring, or null if audio capture was never enabled
+     */
+    public ByteBuffer getCaptureBuffer() {
+        if (captureBuffer == null && nativeDetectorPtr != 0) {
+            ByteBuffer ring = getCaptureBuffer(nativeDetectorPtr);
+            if (ring != null) {
+                captureBuffer = ring.asReadOnlyBuffer().order(ByteOrder.nativeOrder());
+            }
+        }
+        return captureBuffer;
+    }
+    
+    /**
+     * Stream the capture session that started at startPosition while it is still being
+     * recorded, without copying it out of the native ring first
+     *
+     * @param startPosition The position given to onAudioCaptureStarted()
+     * @return The stream, or null if audio capture was never enabled
+     */
+    public AudioCaptureStream openCaptureStream(long startPosition) {
+        ByteBuffer ring = getCaptureBuffer();
+        return ring != null ? new AudioCaptureStream(this, ring, startPosition) : null;
+    }
+    
+    /**
+     * Copy a finished capture session out of the native ring
+     *
+     * @param startPosition The position given to onAudioCaptureStarted()
+     * @param endPosition The position given to onAudioCaptureEnded()
+     * @return The samples, or null if the ring has already overwritten part of them
+     */
+    public short[] readCapturedAudio(long startPosition, long endPosition) {
+        ByteBuffer ring = getCaptureBuffer();
+        if (ring == null || endPosition < startPosition) {
+            return null;
+        }
+        ShortBuffer samples = ring.asShortBuffer();
+        int capacity = samples.capacity();
+        if (endPosition - startPosition > capacity) {
+            return null;
+        }
+        short[] audio = new short[(int) (endPosition - startPosition)];
+        int offset = (int) (startPosition % capacity);
+        int first = Math.min(audio.length, capacity - offset);
+        samples.position(offset);
+        samples.get(audio, 0, first);
+        samples.position(0);
+        samples.get(audio, first, audio.length - first);
+        return startPosition >= getCaptureOverwriteLimit() ? audio : null;
+    }
+    
+    /**
+     * Record every wake word score in a native ring of the last 4096 scores, one
+     * 16-byte record per wake word output and 80 ms frame, for readers that poll it at
+     * their own rate (see openScoreReader()). Nothing crosses JNI per frame.
+     * Call while the detector is stopped.
+     *
+     * @param enabled True to record scores
+     * @return false if the detector is running
+     */
+    public boolean setScoreTelemetry(boolean enabled) {
+        return setScoreTelemetry(nativeDetectorPtr, enabled);
+    }
+    
+    /**
+     * The native score ring as a read-only direct buffer in native byte order. Record p
+     * starts at byte 16 * (p % capacity): long originNanos (System.nanoTime() clock),
+     * float score, short wake word index, short activation. Prefer openScoreReader(),
+     * which detects records overwritten while they were read.
+     *
+     * @return The ring, or null if score telemetry was never enabled
+     */
+    public ByteBuffer getScoreBuffer() {
+        if (scoreBuffer == null && nativeDetectorPtr != 0) {
+            ByteBuffer ring = getScoreBuffer(nativeDetectorPtr);
+            if (ring != null) {
+                scoreBuffer = ring.asReadOnlyBuffer().order(ByteOrder.nativeOrder());
+            }
+        }
+        return scoreBuffer;
+    }
+    
+    /**
+     * Poll scores recorded from now on; each reader keeps its own position
+     *
+     * @return The reader, or null if score telemetry was never enabled
+     */
+    public ScoreTelemetryReader openScoreReader() {
+        ByteBuffer ring = getScoreBuffer();
+        return ring != null ? new ScoreTelemetryReader(this, ring, getScoreWritten()) : null;
+    }
+    
     /**
      * Enable or disable VAD processing
      *
@@ -132,14 +370,281 @@ public class WakeupDetectorJNI implements WakeupDetectorCallback {
         return enableVAD(nativeDetectorPtr, enabled);
     }
 
+    /**
+     * Compute mel spectrograms natively instead of with the mel ONNX model.
+     * Takes effect at the next initialize(), whose mel model path is then ignored.
+     *
+     * @param enabled True to use the native mel front end
+     * @return false if the detector is running
+     */
+    public boolean setNativeMelFrontEnd(boolean enabled) {
+        return setNativeMelFrontEnd(nativeDetectorPtr, enabled);
+    }
+
+    /**
+     * Run each wake word model only around the frames where its first-stage model (a tiny
+     * head shipped next to it as name.stage1.onnx) scores above firstStageThreshold; the
+     * first stage runs on every frame. Takes effect at the next initialize().
+     *
+     * @param enabled True to enable cascade mode
+     * @param firstStageThreshold First-stage score that wakes the full model
+     * @param holdFrames Frames (80 ms each) the full model keeps running after that
+     * @return false if the detector is running
+     */
+    public boolean setCascade(boolean enabled, float firstStageThreshold, int holdFrames) {
+        return setCascade(nativeDetectorPtr, enabled, firstStageThreshold, holdFrames);
+    }
+
+    /**
+     * Compute embeddings less often while nothing sounds like a wake word. While VAD
+     * reports no speech and every score stays below scoreFraction times the threshold,
+     * embeddings are only computed every idleStrideMs and the 80 ms steps in between are
+     * interpolated. Speech or a higher score returns to the full 80 ms rate for 2 s.
+     *
+     * @param enabled True to enable the adaptive stride
+     * @param idleStrideMs Embedding interval while idle, rounded to 80 ms steps (at most 640)
+     * @param scoreFraction Fraction of the threshold that restores the full rate
+     */
+    public void setAdaptiveStride(boolean enabled, int idleStrideMs, float scoreFraction) {
+        setAdaptiveStride(nativeDetectorPtr, enabled, idleStrideMs, scoreFraction);
+    }
+
+    /**
+     * Suspend the wake word models while VAD reports silence. Up to one second of
+     * audio is replayed into them when speech starts. Only applies while VAD is enabled.
+     *
+     * @param enabled True to gate the wake word models on VAD
+     * @param hangoverMs How long the models keep running after speech ends
+     */
+    public void setVadGating(boolean enabled, int hangoverMs) {
+        setVadGating(nativeDetectorPtr, enabled, hangoverMs);
+    }
+
+    /**
+     * Configure when voice activity ends: hangoverMs of audio after the last speech
+     * window, counted on the VAD sample clock whatever the size of the processAudio()
+     * calls. With early endpointing, speech whose probability drops off sharply ends
+     * after earlyHangoverMs instead. Call while stopped.
+     *
+     * @param hangoverMs Silence before speech ends (default 500)
+     * @param earlyEndpoint True to end crisply finished speech after earlyHangoverMs
+     * @param earlyHangoverMs Silence before a crisp end (default 200)
+     * @return false if the detector is running
+     */
+    public boolean setEndpointing(int hangoverMs, boolean earlyEndpoint, int earlyHangoverMs) {
+        return setEndpointing(nativeDetectorPtr, hangoverMs, earlyEndpoint, earlyHangoverMs);
+    }
+
+    /**
+     * Latency and CPU statistics for every pipeline stage since the last reset, as a JSON
+     * object. Histograms ("wait", "compute", "endToEnd", "detection", ...) hold count,
+     * mean, p50, p90, p99 and max in microseconds; "endToEnd" runs from processAudio to
+     * the wake word scores, "detection" from processAudio to the wake word callback.
+     * "wakeWordRuns" and "wakeWordSkips" count the wake word inferences run and those
+     * cascade mode avoided; "embeddingsInterpolated" counts the embedding steps the
+     * adaptive stride skipped. Each stage also reports "lag", the audio queued in front of
+     * it beyond its next inference, as a histogram and as its latest value "lagMs", and
+     * "droppedMs", the audio it lost to its overload policy or a full queue;
+     * "overloadSkips" counts the low-priority wake word runs OVERLOAD_DEGRADE shed.
+     *
+     * @return JSON statistics, or null if the detector has been released
+     */
+    public String getPipelineStats() {
+        return getPipelineStats(nativeDetectorPtr);
+    }
+
+    /**
+     * Choose where the native worker threads run; call while the detector is stopped.
+     * By default every stage is pinned to efficiency cores, and the embedding and wake word
+     * stages may use any core for 1.5 s after speech onset or a score above the threshold.
+     *
+     * @param pinThreads false to leave thread placement entirely to the scheduler
+     * @param coreClasses CORES_* values for {mel, embedding, wake word, VAD, burst};
+     *                    missing entries keep their defaults
+     * @param burstHoldMs how long the embedding and wake word stages stay on the burst cores
+     * @return true if the policy was applied
+     */
+    public boolean setSchedulingConfig(boolean pinThreads, int[] coreClasses, int burstHoldMs) {
+        return setSchedulingConfig(nativeDetectorPtr, pinThreads, coreClasses, burstHoldMs);
+    }
+
+    /**
+     * Size the queues between the native stages and choose what a stage that falls behind
+     * real time drops; call while the detector is stopped. Capacities take effect at the
+     * next initialize() (initializeVAD() for the VAD queue). OVERLOAD_DROP_OLDEST drops the
+     * oldest queued audio until the lag is back to maxLagMs, OVERLOAD_SKIP_TO_LIVE drops all
+     * of it, OVERLOAD_DEGRADE first computes embeddings less often and skips low-priority
+     * wake words, and only drops beyond twice maxLagMs. OVERLOAD_DROP_NEWEST only drops
+     * what no longer fits a full queue.
+     *
+     * @param capacitiesMs Capacities in ms of audio for {samples, VAD, mels, features};
+     *                     missing entries keep their defaults (4000, 2000, 2560, 5120)
+     * @param policy One of the OVERLOAD_* values
+     * @param maxLagMs Lag each stage may build up before the policy applies
+     * @return false if the detector is running
+     */
+    public boolean setQueueConfig(int[] capacitiesMs, int policy, int maxLagMs) {
+        return setQueueConfig(nativeDetectorPtr, capacitiesMs, policy, maxLagMs);
+    }
+
+    /**
+     * Mark a wake word as low priority so OVERLOAD_DEGRADE skips it first. Wake words
+     * start with high priority; may be called while running.
+     *
+     * @param wakeWord Index of the wake word model, as passed to initialize() or
+     *                 returned by addWakeWord()
+     * @param high false for low priority
+     * @return false if no wake word has this index
+     */
+    public boolean setWakeWordPriority(int wakeWord, boolean high) {
+        return setWakeWordPriority(nativeDetectorPtr, wakeWord, high);
+    }
+
+    /**
+     * Load one more wake word model without restarting. The model is loaded and warmed
+     * up on the calling thread, so call it off the main thread; the running pipeline
+     * scores it from its next frame and keeps listening meanwhile. Its detections are
+     * reported under the model's file name. Call after initialize().
+     *
+     * @param wwModelPath Path of the wake word model, the same form as for initialize()
+     * @return The wake word's index (the lowest free one), or -1 if the model could not
+     *         be loaded or one with the same name is already loaded
+     */
+    public int addWakeWord(String wwModelPath) {
+        return addWakeWord(nativeDetectorPtr, wwModelPath);
+    }
+
+    /**
+     * Stop listening for a wake word without restarting; its index becomes free and
+     * the other wake words keep theirs
+     *
+     * @param name The wake word's name, its model file name without the extension
+     * @return false if no wake word has this name
+     */
+    public boolean removeWakeWord(String name) {
+        return removeWakeWord(nativeDetectorPtr, name);
+    }
+
+    /**
+     * Native memory use as a JSON object of byte counts: this detector's queues and windows
+     * ("sampleRing", "vadRing", "preRoll", "melWindow", "featureWindow", "wakeWordHeads",
+     * "captureRing", "scoreRing", "stageScratch" and their sum "pipeline"), the models the
+     * process has mapped ("models" count, "modelMapped", "modelResident", "modelHeap"), and
+     * the process footprint ("resident", "peakResident", "anonymous", "file"). The shared
+     * ONNX Runtime arena is part of "anonymous".
+     *
+     * @return JSON report, or null if the detector has been released
+     */
+    public String getMemoryReport() {
+        return getMemoryReport(nativeDetectorPtr);
+    }
+
+    /**
+     * Low-memory mode, for devices where the process is killed under memory pressure.
+     * Queues shrink to the minimum each stage needs, so a stall of more than one window
+     * drops audio; models load without memory pattern planning and with initializers
+     * outside the shared arena; pause() returns the arena's free memory. Takes effect at
+     * the next initialize(); call while stopped.
+     *
+     * @param enabled True for low-memory mode
+     * @return false if the detector is running
+     */
+    public boolean setLowMemoryMode(boolean enabled) {
+        return setLowMemoryMode(nativeDetectorPtr, enabled);
+    }
+
+    /**
+     * Release memory that is not needed right now without stopping detection, e.g. from
+     * onTrimMemory(). The arena's free memory is returned after the next embedding.
+     */
+    public void trimMemory() {
+        trimMemory(nativeDetectorPtr);
+    }
+
+    /**
+     * Clear the statistics returned by getPipelineStats()
+     */
+    public void resetPipelineStats() {
+        resetPipelineStats(nativeDetectorPtr);
+    }
+
+    /**
+     * Set the AssetManager used to resolve ASSET_PREFIX model paths; call before initialize()
+     *
+     * @param assetManager The application's AssetManager, kept referenced by native code
+     */
+    public static native void setAssetManager(AssetManager assetManager);
+
+    // Used by AudioCaptureStream
+    long waitForCapture(long sessionStart, long position, int timeoutMs) {
+        return waitForCapture(nativeDetectorPtr, sessionStart, position, timeoutMs);
+    }
+
+    long getCaptureOverwriteLimit() {
+        return getCaptureOverwriteLimit(nativeDetectorPtr);
+    }
+
+    // Used by ScoreTelemetryReader
+    long getScoreWritten() {
+        return getScoreWritten(nativeDetectorPtr);
+    }
+
+    long getScoreOverwriteLimit() {
+        return getScoreOverwriteLimit(nativeDetectorPtr);
+    }
+
+    /**
+     * Set an app-private directory where the optimized graphs of .onnx models are cached in
+     * ORT format, so later initialize() calls skip graph parsing and optimization; call before
+     * initialize(). Bundled .ort models are used as they are.
+     *
+     * @param directory Cache directory, or null to disable the cache
+     */
+    public static native void setModelCacheDirectory(String directory);
+
     // Native methods - implemented in C++
     private native long createWakeupDetector();
     private native boolean initializeDetector(long detectorPtr, String melModelPath, 
-                                            String embModelPath, String[] wwModelPaths);
+                                            String embModelPath, String[] wwModelPaths,
+                                            int[] providers, int[] precisions);
     private native boolean initializeVAD(long detectorPtr, String vadModelPath);
+    private native boolean setSchedulingConfig(long detectorPtr, boolean pinThreads, int[] coreClasses,
+                                               int burstHoldMs);
+    private native boolean setQueueConfig(long detectorPtr, int[] capacitiesMs, int policy,
+                                          int maxLagMs);
+    private native boolean setWakeWordPriority(long detectorPtr, int wakeWord, boolean high);
+    private native int addWakeWord(long detectorPtr, String wwModelPath);
+    private native boolean removeWakeWord(long detectorPtr, String name);
     private native boolean startDetector(long detectorPtr);
     private native void stopDetector(long detectorPtr);
+    private native boolean pauseDetector(long detectorPtr);
+    private native boolean resumeDetector(long detectorPtr);
     private native void processAudio(long detectorPtr, short[] audioData, int numSamples);
+    private native void processAudioDirect(long detectorPtr, ByteBuffer audioData, int numSamples);
+    private native boolean setInputSampleRate(long detectorPtr, int sampleRate);
     private native boolean enableVAD(long detectorPtr, boolean enabled);
+    private native boolean setNativeMelFrontEnd(long detectorPtr, boolean enabled);
+    private native boolean setCascade(long detectorPtr, boolean enabled, float firstStageThreshold,
+                                      int holdFrames);
+    private native String getPipelineStats(long detectorPtr);
+    private native void resetPipelineStats(long detectorPtr);
+    private native String getMemoryReport(long detectorPtr);
+    private native boolean setLowMemoryMode(long detectorPtr, boolean enabled);
+    private native void trimMemory(long detectorPtr);
+    private native void setVadGating(long detectorPtr, boolean enabled, int hangoverMs);
+    private native boolean setEndpointing(long detectorPtr, int hangoverMs, boolean earlyEndpoint,
+                                          int earlyHangoverMs);
+    private native void setAdaptiveStride(long detectorPtr, boolean enabled, int idleStrideMs,
+                                          float scoreFraction);
+    private native boolean setAudioCapture(long detectorPtr, boolean enabled, int preRollMs,
+                                           int postSilenceMs);
+    private native ByteBuffer getCaptureBuffer(long detectorPtr);
+    private native long waitForCapture(long detectorPtr, long sessionStart, long position,
+                                       int timeoutMs);
+    private native long getCaptureOverwriteLimit(long detectorPtr);
+    private native boolean setScoreTelemetry(long detectorPtr, boolean enabled);
+    private native ByteBuffer getScoreBuffer(long detectorPtr);
+    private native long getScoreWritten(long detectorPtr);
+    private native long getScoreOverwriteLimit(long detectorPtr);
     private native void destroyWakeupDetector(long detectorPtr);
 }
\ No newline at end of file
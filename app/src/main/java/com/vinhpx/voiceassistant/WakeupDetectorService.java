@@ -1,7 +1,11 @@
 package com.vinhpx.voiceassistant;
 
+import android.app.ActivityManager;
+import android.content.ComponentCallbacks2;
 import android.content.Context;
+import android.content.res.Configuration;
 import android.media.AudioFormat;
+import android.media.AudioManager;
 import android.media.AudioRecord;
 import android.media.MediaRecorder;
 import android.os.Handler;
@@ -11,9 +15,8 @@ import android.util.Log;
 import com.vinhpx.voiceassistant.speech.AzureSpeechRecognizer;
 import com.vinhpx.voiceassistant.speech.SpeechRecognitionListener;
 
-import java.io.File;
-import java.io.FileOutputStream;
-import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.text.SimpleDateFormat;
 import java.util.ArrayList;
 import java.util.Date;
@@ -28,11 +31,16 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
     private static final String TAG = "WakeupDetectorService";
     
     // Audio configurations
-    private static final int SAMPLE_RATE = 16000; // 16kHz
+    private static final int SAMPLE_RATE = 16000; // 16kHz, the detector and captured audio
     private static final int CHANNEL_CONFIG = AudioFormat.CHANNEL_IN_MONO;
     private static final int AUDIO_FORMAT = AudioFormat.ENCODING_PCM_16BIT;
+    private static final int BYTES_PER_SAMPLE = 2;
     private static final int BUFFER_SIZE_FACTOR = 2; // Multiplier for minimum buffer size
-    private static final int MAX_SPEECH_DURATION_SAMPLES = SAMPLE_RATE * 30; // 30 seconds max
+    // Post-wake capture in the native ring, streamed to the recognizer as it is recorded
+    private static final int CAPTURE_PRE_ROLL_MS = 500;
+    private static final int CAPTURE_POST_SILENCE_MS = 500;
+    // Devices up to this much RAM run the detector in low-memory mode
+    private static final long LOW_MEMORY_DEVICE_BYTES = 2L << 30;
     
     private final List<WakeupDetectorCallback> callbacks = new ArrayList<>();
     private final List<SpeechRecognitionListener> speechListeners = new ArrayList<>();
@@ -42,15 +50,16 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
     private final AtomicBoolean isRecording = new AtomicBoolean(false);
     
     private AudioRecord audioRecord;
-    private short[] audioBuffer;
+    // The device's native rate when the detector can resample it, else SAMPLE_RATE
+    private final int recordSampleRate;
+    private final int audioBufferSamples;
+    // Direct buffer shared with the native detector, filled in place by AudioRecord
+    private final ByteBuffer audioBuffer;
     private Thread recordingThread;
     
-    // Audio capture for speech recognition
-    private List<short[]> voiceActivityBuffer;
-    private boolean isCapturingVoiceActivity = false;
-    private boolean wakeWordDetectedDuringVoiceActivity = false;
-    private String detectedWakeWord = null;
-    private int capturedSamplesCount = 0;
+    // Capture session for speech recognition, touched only on the callback thread
+    private AudioCaptureStream captureStream;
+    private long captureStartPosition = -1;
     
     // Azure Speech SDK recognizer
     private AzureSpeechRecognizer speechRecognizer;
@@ -74,17 +83,78 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
     public WakeupDetectorService(Context context) {
         this.context = context;
         this.mainHandler = new Handler(Looper.getMainLooper());
+        // Models are memory-mapped from the APK rather than copied out of it
+        WakeupDetectorJNI.setAssetManager(context.getAssets());
+        // Optimized graphs survive service restarts; the code cache is cleared on app updates
+        WakeupDetectorJNI.setModelCacheDirectory(context.getCodeCacheDir().getAbsolutePath() + "/ort");
         this.detector = new WakeupDetectorJNI();
         this.detector.setCallback(this);
+        if (isLowMemoryDevice()) {
+            detector.setLowMemoryMode(true);
+            Log.i(TAG, "Low-memory device, detector in low-memory mode");
+        }
+        context.registerComponentCallbacks(memoryCallbacks);
         
+        recordSampleRate = chooseRecordSampleRate();
         int minBufferSize = AudioRecord.getMinBufferSize(
-                SAMPLE_RATE, CHANNEL_CONFIG, AUDIO_FORMAT);
-        audioBuffer = new short[minBufferSize];
+                recordSampleRate, CHANNEL_CONFIG, AUDIO_FORMAT);
+        audioBufferSamples = minBufferSize;
+        audioBuffer = ByteBuffer.allocateDirect(audioBufferSamples * BYTES_PER_SAMPLE)
+                .order(ByteOrder.nativeOrder());
+        
+        Log.i(TAG, "WakeupDetectorService created with buffer size: " + minBufferSize
+                + " at " + recordSampleRate + " Hz");
+    }
+    
+    private boolean isLowMemoryDevice() {
+        ActivityManager activityManager =
+                (ActivityManager) context.getSystemService(Context.ACTIVITY_SERVICE);
+        if (activityManager == null) {
+            return false;
+        }
+        ActivityManager.MemoryInfo memoryInfo = new ActivityManager.MemoryInfo();
+        activityManager.getMemoryInfo(memoryInfo);
+        return activityManager.isLowRamDevice() || memoryInfo.totalMem <= LOW_MEMORY_DEVICE_BYTES;
+    }
+    
+    // Trim the native footprint under memory pressure while detection keeps running
+    private final ComponentCallbacks2 memoryCallbacks = new ComponentCallbacks2() {
+        @Override
+        public void onTrimMemory(int level) {
+            if (level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW) {
+                detector.trimMemory();
+            }
+        }
         
-        // Initialize buffer for voice activity
-        voiceActivityBuffer = new ArrayList<>();
+        @Override
+        public void onLowMemory() {
+            detector.trimMemory();
+        }
         
-        Log.i(TAG, "WakeupDetectorService created with buffer size: " + minBufferSize);
+        @Override
+        public void onConfigurationChanged(Configuration newConfig) {
+        }
+    };
+    
+    /**
+     * Record at the device's native rate, which keeps capture off the framework's
+     * resampler; the detector resamples to 16 kHz itself
+     */
+    private int chooseRecordSampleRate() {
+        AudioManager audioManager = (AudioManager) context.getSystemService(Context.AUDIO_SERVICE);
+        String nativeRate = audioManager != null
+                ? audioManager.getProperty(AudioManager.PROPERTY_OUTPUT_SAMPLE_RATE) : null;
+        try {
+            int rate = nativeRate != null ? Integer.parseInt(nativeRate) : SAMPLE_RATE;
+            if (rate != SAMPLE_RATE && AudioRecord.getMinBufferSize(rate, CHANNEL_CONFIG, AUDIO_FORMAT) > 0
+                    && detector.setInputSampleRate(rate)) {
+                return rate;
+            }
+        } catch (NumberFormatException e) {
+            Log.w(TAG, "Unexpected native sample rate: " + nativeRate);
+        }
+        detector.setInputSampleRate(SAMPLE_RATE);
+        return SAMPLE_RATE;
     }
     
     /**
@@ -96,20 +166,51 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
      * @return true if initialization succeeded
      */
     public boolean initialize(String melModelName, String embModelName, String[] wakeWordModelNames) {
-        try {
-            String melModelPath = copyAssetToInternalStorage(melModelName);
-            String embModelPath = copyAssetToInternalStorage(embModelName);
-            
-            String[] wakeWordModelPaths = new String[wakeWordModelNames.length];
-            for (int i = 0; i < wakeWordModelNames.length; i++) {
-                wakeWordModelPaths[i] = copyAssetToInternalStorage(wakeWordModelNames[i]);
-            }
-            
-            return detector.initialize(melModelPath, embModelPath, wakeWordModelPaths);
-        } catch (IOException e) {
-            Log.e(TAG, "Error initializing models", e);
-            return false;
+        return initialize(melModelName, embModelName, wakeWordModelNames, null);
+    }
+
+    /**
+     * Initialize the detector with the ONNX models and an execution provider per stage
+     * 
+     * @param melModelName Name of the mel spectrogram model file in assets
+     * @param embModelName Name of the embedding model file in assets
+     * @param wakeWordModelNames Array of wake word model files in assets
+     * @param providers WakeupDetectorJNI.PROVIDER_* values for {mel, embedding, wake word, VAD},
+     *                  or null to run every stage on CPU
+     * @return true if initialization succeeded
+     */
+    public boolean initialize(String melModelName, String embModelName, String[] wakeWordModelNames,
+                              int[] providers) {
+        return initialize(melModelName, embModelName, wakeWordModelNames, providers, null);
+    }
+
+    /**
+     * Initialize the detector with an execution provider and a model precision per stage.
+     * The FP16/INT8 variant of each model is used when it is bundled in assets next to the
+     * FP32 model; stages without a bundled variant run the FP32 model.
+     * 
+     * @param melModelName Name of the FP32 mel spectrogram model file in assets
+     * @param embModelName Name of the FP32 embedding model file in assets
+     * @param wakeWordModelNames Array of FP32 wake word model files in assets
+     * @param providers WakeupDetectorJNI.PROVIDER_* values for {mel, embedding, wake word, VAD},
+     *                  or null to run every stage on CPU
+     * @param precisions WakeupDetectorJNI.PRECISION_* values for {mel, embedding, wake word},
+     *                   or null to run every stage in FP32
+     * @return true if initialization succeeded
+     */
+    public boolean initialize(String melModelName, String embModelName, String[] wakeWordModelNames,
+                              int[] providers, int[] precisions) {
+        String[] wakeWordModelPaths = new String[wakeWordModelNames.length];
+        for (int i = 0; i < wakeWordModelNames.length; i++) {
+            wakeWordModelPaths[i] = assetModel(wakeWordModelNames[i]);
+        }
+        
+        boolean result = detector.initialize(assetModel(melModelName), assetModel(embModelName),
+                wakeWordModelPaths, providers, precisions);
+        if (!result) {
+            Log.e(TAG, "Error initializing models");
         }
+        return result;
     }
     
     /**
@@ -119,21 +220,166 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
      * @return true if initialization succeeded
      */
     public boolean initializeVAD(String vadModelName) {
-        try {
-            String vadModelPath = copyAssetToInternalStorage(vadModelName);
-            
-            Log.i(TAG, "Initializing VAD with model: " + vadModelName);
-            boolean result = detector.initializeVAD(vadModelPath);
-            if (result) {
-                Log.i(TAG, "VAD model initialized successfully");
-            } else {
-                Log.e(TAG, "Failed to initialize VAD model");
-            }
-            return result;
-        } catch (IOException e) {
-            Log.e(TAG, "Error initializing VAD model", e);
-            return false;
+        Log.i(TAG, "Initializing VAD with model: " + vadModelName);
+        boolean result = detector.initializeVAD(assetModel(vadModelName));
+        if (result) {
+            Log.i(TAG, "VAD model initialized successfully");
+        } else {
+            Log.e(TAG, "Failed to initialize VAD model");
         }
+        return result;
+    }
+    
+    /**
+     * Use the native mel front end instead of the mel model; call before initialize()
+     * 
+     * @param enabled True to use the native mel front end
+     * @return false if the detector is running
+     */
+    public boolean setNativeMelFrontEnd(boolean enabled) {
+        return detector.setNativeMelFrontEnd(enabled);
+    }
+    
+    /**
+     * Gate each wake word model on its bundled first-stage model; call before initialize()
+     * 
+     * @param enabled True to enable cascade mode
+     * @param firstStageThreshold First-stage score that wakes the full model
+     * @param holdFrames Frames (80 ms each) the full model keeps running after that
+     * @return false if the detector is running
+     */
+    public boolean setCascade(boolean enabled, float firstStageThreshold, int holdFrames) {
+        return detector.setCascade(enabled, firstStageThreshold, holdFrames);
+    }
+    
+    /**
+     * Size the native queues and choose what a stage behind real time drops; call before
+     * initialize()
+     * 
+     * @param capacitiesMs Capacities in ms for {samples, VAD, mels, features}
+     * @param policy One of the WakeupDetectorJNI.OVERLOAD_* values
+     * @param maxLagMs Lag each stage may build up before the policy applies
+     * @return false if the detector is running
+     */
+    public boolean setQueueConfig(int[] capacitiesMs, int policy, int maxLagMs) {
+        return detector.setQueueConfig(capacitiesMs, policy, maxLagMs);
+    }
+    
+    /**
+     * Mark a wake word as low priority, skipped first when the device cannot keep up
+     * 
+     * @param wakeWord Index of the wake word model
+     * @param high false for low priority
+     * @return false if no wake word has this index
+     */
+    public boolean setWakeWordPriority(int wakeWord, boolean high) {
+        return detector.setWakeWordPriority(wakeWord, high);
+    }
+    
+    /**
+     * Start listening for one more wake word without restarting; blocks while the
+     * model loads, so call it off the main thread
+     * 
+     * @param wakeWordModelName Name of the FP32 wake word model file in assets
+     * @return The wake word's index, or -1 on failure
+     */
+    public int addWakeWord(String wakeWordModelName) {
+        int index = detector.addWakeWord(assetModel(wakeWordModelName));
+        if (index < 0) {
+            Log.e(TAG, "Error adding wake word model " + wakeWordModelName);
+        }
+        return index;
+    }
+    
+    /**
+     * Stop listening for a wake word without restarting
+     * 
+     * @param name The wake word's name, its model file name without the extension
+     * @return false if no wake word has this name
+     */
+    public boolean removeWakeWord(String name) {
+        return detector.removeWakeWord(name);
+    }
+    
+    /**
+     * Record every wake word score for polling through openScoreReader(); call before start()
+     * 
+     * @param enabled True to record scores
+     * @return false if the detector is running
+     */
+    public boolean setScoreTelemetry(boolean enabled) {
+        return detector.setScoreTelemetry(enabled);
+    }
+    
+    /**
+     * Poll the wake word scores recorded from now on, e.g. for a live score view
+     * 
+     * @return The reader, or null if score telemetry was never enabled
+     */
+    public ScoreTelemetryReader openScoreReader() {
+        return detector.openScoreReader();
+    }
+    
+    /**
+     * Per-stage latency and CPU statistics of the native pipeline
+     * 
+     * @return JSON statistics, see WakeupDetectorJNI.getPipelineStats()
+     */
+    public String getPipelineStats() {
+        return detector.getPipelineStats();
+    }
+    
+    /**
+     * Native memory use of the detector, its models and the process
+     * 
+     * @return JSON byte counts, see WakeupDetectorJNI.getMemoryReport()
+     */
+    public String getMemoryReport() {
+        return detector.getMemoryReport();
+    }
+    
+    /**
+     * Override low-memory mode, which is on by default on devices with 2 GB of RAM or less;
+     * call before initialize()
+     * 
+     * @param enabled True for minimal queues, lean sessions and arena release on pause
+     * @return false if the detector is running
+     */
+    public boolean setLowMemoryMode(boolean enabled) {
+        return detector.setLowMemoryMode(enabled);
+    }
+    
+    /**
+     * Compute embeddings less often while idle to save power
+     * 
+     * @param enabled True to enable the adaptive stride
+     * @param idleStrideMs Embedding interval while idle, rounded to 80 ms steps
+     * @param scoreFraction Fraction of the threshold that restores the full rate
+     */
+    public void setAdaptiveStride(boolean enabled, int idleStrideMs, float scoreFraction) {
+        detector.setAdaptiveStride(enabled, idleStrideMs, scoreFraction);
+    }
+    
+    /**
+     * Run the wake word models only around detected speech to save power
+     * 
+     * @param enabled True to gate the wake word models on VAD
+     * @param hangoverMs How long the models keep running after speech ends
+     */
+    public void setVadGating(boolean enabled, int hangoverMs) {
+        detector.setVadGating(enabled, hangoverMs);
+    }
+    
+    /**
+     * Configure how soon voice activity ends after speech; call before start()
+     * 
+     * @param hangoverMs Silence before speech ends
+     * @param earlyEndpoint True to end crisply finished speech after earlyHangoverMs
+     * @param earlyHangoverMs Silence before a crisp end
+     * @return false if the detector is running
+     */
+    public boolean setEndpointing(int hangoverMs, boolean earlyEndpoint, int earlyHangoverMs) {
+        return detector.setEndpointing(hangoverMs, earlyEndpoint, earlyHangoverMs);
     }
     
     /**
@@ -204,6 +450,11 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
             return true;
         }
         
+        // The utterance after each wake word is kept natively, not copied chunk by chunk here
+        if (!detector.setAudioCapture(true, CAPTURE_PRE_ROLL_MS, CAPTURE_POST_SILENCE_MS)) {
+            Log.w(TAG, "Failed to enable audio capture");
+        }
+        
         // Start the native detector
         if (!detector.start()) {
             Log.e(TAG, "Failed to start native detector");
@@ -213,7 +464,7 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
         // Start audio recording
         try {
             audioRecord = new AudioRecord(MediaRecorder.AudioSource.MIC, 
-                    SAMPLE_RATE, CHANNEL_CONFIG, AUDIO_FORMAT, audioBuffer.length * BUFFER_SIZE_FACTOR);
+                    recordSampleRate, CHANNEL_CONFIG, AUDIO_FORMAT, audioBufferSamples * BUFFER_SIZE_FACTOR);
             
             if (audioRecord.getState() != AudioRecord.STATE_INITIALIZED) {
                 Log.e(TAG, "AudioRecord initialization failed");
@@ -334,6 +585,7 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
      */
     public void release() {
         stop();
+        context.unregisterComponentCallbacks(memoryCallbacks);
         detector.release();
         callbacks.clear();
         
@@ -401,22 +653,13 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
      */
     private void processAudioRunnable() {
         while (isRecording.get()) {
-            int readSize = audioRecord.read(audioBuffer, 0, audioBuffer.length);
+            int readBytes = audioRecord.read(audioBuffer, audioBuffer.capacity());
+            int readSize = readBytes / BYTES_PER_SAMPLE;
             
             if (readSize > 0) {
-                // Process audio for wake word detection
+                // Process audio for wake word detection straight from the direct buffer;
+                // the native detector also keeps it for post-wake capture
                 detector.processAudio(audioBuffer, readSize);
-                
-                // If we're in a voice activity session, store the audio for later processing
-                if (isCapturingVoiceActivity && capturedSamplesCount < MAX_SPEECH_DURATION_SAMPLES) {
-                    // Make a copy of the audio buffer to store
-                    short[] bufferCopy = new short[readSize];
-                    System.arraycopy(audioBuffer, 0, bufferCopy, 0, readSize);
-                    
-                    // Add to our voice activity buffer
-                    voiceActivityBuffer.add(bufferCopy);
-                    capturedSamplesCount += readSize;
-                }
             }
         }
     }
@@ -517,24 +760,13 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
         mainHandler.post(() -> {
             Log.i(TAG, "Wake word detected: " + wakeWord);
             
-            // Reset any previous state to ensure clean capture
-            voiceActivityBuffer.clear();
-            capturedSamplesCount = 0;
-
-            // Store wake word information for later processing
-            wakeWordDetectedDuringVoiceActivity = true;
-            detectedWakeWord = wakeWord;
-            
-            // Start voice activity capture immediately
-            isCapturingVoiceActivity = true;
-            
             // First disable VAD to reset its state, then re-enable it
             detector.enableVAD(false);
             
             // Enable VAD in the native detector to start listening for voice activity
             detector.enableVAD(true);
             
-            Log.d(TAG, "Voice capture started after wake word, waiting for speech...");
+            Log.d(TAG, "Waiting for speech after wake word...");
             
             for (WakeupDetectorCallback callback : new ArrayList<>(callbacks)) {
                 callback.onWakeWordDetected(wakeWord);
@@ -559,18 +791,6 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
     public void onVoiceActivityStarted() {
         Log.d("VADDebug", "Voice activity STARTED detected");
         
-        // Only start capturing if a wake word was previously detected
-        // This ensures we're only capturing and recognizing speech that follows a wake word
-        if (wakeWordDetectedDuringVoiceActivity) {
-            if (!isCapturingVoiceActivity) {
-                Log.d(TAG, "Starting voice activity capture after wake word detection");
-                isCapturingVoiceActivity = true;
-                // We don't clear the buffer here as it might contain audio from the wake word
-            }
-        } else {
-            Log.d(TAG, "Voice activity detected but no wake word was detected first, ignoring");
-        }
-        
         mainHandler.post(() -> {
             for (WakeupDetectorCallback callback : new ArrayList<>(callbacks)) {
                 callback.onVoiceActivityStarted();
@@ -582,102 +802,83 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
     public void onVoiceActivityEnded() {
         Log.d("VADDebug", "Voice activity ENDED detected");
         
-        // Process captured audio if a wake word was detected during this voice activity
-        // and we have some audio data captured
-        if (wakeWordDetectedDuringVoiceActivity && !voiceActivityBuffer.isEmpty() && capturedSamplesCount > 0) {
-            Log.d(TAG, "Processing voice activity audio - captured " + capturedSamplesCount + 
-                  " samples after wake word: " + detectedWakeWord);
-            
-            // Stop capturing before processing to prevent additional audio being added during processing
-            isCapturingVoiceActivity = false;
-            
-            // Process the audio that was captured after the wake word
-            processVoiceActivityAudio();
-            
-            // Disable VAD after processing to prevent false triggers
-            detector.enableVAD(false);
-        } else {
-            // Clear the buffer if no wake word was detected or no useful audio was captured
-            Log.d(TAG, "No usable voice activity after wake word detection (wakeWordDetected=" + 
-                  wakeWordDetectedDuringVoiceActivity + ", bufferEmpty=" + voiceActivityBuffer.isEmpty() + 
-                  ", capturedSamples=" + capturedSamplesCount + ")");
-            
-            // Disable VAD to avoid false triggers
-            detector.enableVAD(false);
-        }
-        
-        // Reset capture state regardless of outcome
-        voiceActivityBuffer.clear();
-        capturedSamplesCount = 0;
-        isCapturingVoiceActivity = false;
-        wakeWordDetectedDuringVoiceActivity = false;
-        
-        // Notify callbacks
+        // The capture session keeps recording the post-silence tail and reports its end
         mainHandler.post(() -> {
             for (WakeupDetectorCallback callback : new ArrayList<>(callbacks)) {
                 callback.onVoiceActivityEnded();
             }
-            
-            // Re-enable wake word detection by resetting the detector state
-            // This allows it to detect wake words again
-            mainHandler.postDelayed(() -> {
-                Log.d(TAG, "Re-enabling wake word detection after voice activity ended");
-                // Re-initialize the detector's state to be ready for the next wake word
-                if (detector != null && isRecording.get()) {
-                    // Stop and restart wake word processing
-                    detector.stop();
-                    detector.start();
-                }
-            }, 500); // Small delay to ensure all processing is complete
         });
     }
     
-    /**
-     * Process the audio captured during voice activity and send to Azure Speech
-     */
-    private void processVoiceActivityAudio() {
-        // Calculate total audio size
-        int totalSize = capturedSamplesCount;
-        if (totalSize <= 0) {
-            Log.w(TAG, "No voice activity audio captured");
-            return;
+    @Override
+    public void onAudioCaptureStarted(String wakeWord, long startPosition) {
+        Log.d(TAG, "Audio capture started for " + wakeWord + " at " + startPosition);
+        captureStartPosition = startPosition;
+        if (captureStream != null) {
+            captureStream.close();
         }
+        captureStream = null;
         
-        Log.d(TAG, "Processing voice activity audio: combining " + voiceActivityBuffer.size() + 
-              " chunks into " + totalSize + " samples");
-        
-        // Create a single audio buffer from all captured chunks
-        short[] capturedAudio = new short[totalSize];
-        int position = 0;
-        
-        // Copy all buffer chunks into the single array
-        for (short[] chunk : voiceActivityBuffer) {
-            int chunkSize = Math.min(chunk.length, totalSize - position);
-            if (chunkSize <= 0) break;
-            
-            System.arraycopy(chunk, 0, capturedAudio, position, chunkSize);
-            position += chunkSize;
+        // Recognition runs while the user is still speaking
+        if (speechRecognizer != null) {
+            captureStream = detector.openCaptureStream(startPosition);
+            if (captureStream != null) {
+                Log.i(TAG, "Streaming captured audio to Azure Speech SDK");
+                speechRecognizer.recognizeStream(captureStream);
+            }
+        } else {
+            Log.w(TAG, "Azure Speech SDK not configured, skipping speech recognition");
         }
         
-        Log.d(TAG, "Audio processing complete: combined " + position + " of " + totalSize + 
-              " samples, sending to onAudioCaptureCompleted");
-              
-        final short[] finalAudio = capturedAudio;
-        // Ensure wakeWord is never null - use a placeholder if needed
-        final String finalWakeWord = detectedWakeWord != null ? detectedWakeWord : "unknown";
+        mainHandler.post(() -> {
+            for (WakeupDetectorCallback callback : new ArrayList<>(callbacks)) {
+                callback.onAudioCaptureStarted(wakeWord, startPosition);
+            }
+        });
+    }
+    
+    @Override
+    public void onAudioCaptureEnded(String wakeWord, long endPosition) {
+        long startPosition = captureStartPosition;
+        captureStartPosition = -1;
+        captureStream = null; // Ends by itself once it has read up to endPosition
+        Log.d(TAG, "Audio capture ended for " + wakeWord + ": " + (endPosition - startPosition) + " samples");
         
-        // Clear buffers
-        voiceActivityBuffer.clear();
-        capturedSamplesCount = 0;
+        // Only copy the session out of the ring when someone wants the samples
+        short[] audioData = null;
+        if (startPosition >= 0 && !callbacks.isEmpty()) {
+            audioData = detector.readCapturedAudio(startPosition, endPosition);
+            if (audioData == null) {
+                Log.w(TAG, "Captured audio was overwritten before it could be read");
+            }
+        }
+        final short[] capturedAudio = audioData;
         
-        // Send the captured audio for processing
         mainHandler.post(() -> {
-            onAudioCaptureCompleted(finalWakeWord, finalAudio, SAMPLE_RATE);
+            // Disable VAD to prevent false triggers
+            detector.enableVAD(false);
+            
+            for (WakeupDetectorCallback callback : new ArrayList<>(callbacks)) {
+                callback.onAudioCaptureEnded(wakeWord, endPosition);
+            }
+            if (capturedAudio != null) {
+                onAudioCaptureCompleted(wakeWord, capturedAudio, SAMPLE_RATE);
+            }
+            
+            // Reset wake word processing without tearing down the native threads,
+            // so the next wake word is detected from a clean state; resume() turns
+            // VAD back on, as start() did
+            if (detector != null && isRecording.get()) {
+                Log.d(TAG, "Re-enabling wake word detection after audio capture ended");
+                detector.pause();
+                detector.resume();
+            }
         });
     }
     
     @Override
     public void onAudioCaptureCompleted(String wakeWord, short[] audioData, int sampleRate) {
+        // The recognizer has already been fed from the capture stream
         mainHandler.post(() -> {
             Log.i(TAG, "Audio capture completed: " + audioData.length + " samples at " + sampleRate + " Hz");
             
@@ -685,61 +886,13 @@ public class WakeupDetectorService implements WakeupDetectorCallback {
             for (WakeupDetectorCallback callback : new ArrayList<>(callbacks)) {
                 callback.onAudioCaptureCompleted(wakeWord, audioData, sampleRate);
             }
-            
-            // Send to Azure Speech SDK if configured
-            if (speechRecognizer != null) {
-                try {
-                    Log.i(TAG, "Sending captured audio to Azure Speech SDK");
-                    
-                    // Add extra debugging to track if this is actually being called
-                    if (audioData != null && audioData.length > 0) {
-                        Log.d(TAG, "Audio data is valid: " + audioData.length + " samples");
-                        
-                        // Check if we have any listeners registered
-                        Log.d(TAG, "Number of speech recognition listeners: " + speechListeners.size());
-                        
-                        // Start the recognition process
-                        speechRecognizer.recognizeSpeech(audioData, sampleRate);
-                    } else {
-                        Log.e(TAG, "Audio data is invalid or empty");
-                    }
-                } catch (Exception e) {
-                    Log.e(TAG, "Error sending audio to Azure Speech SDK", e);
-                }
-            } else {
-                Log.w(TAG, "Azure Speech SDK not configured, skipping speech recognition");
-            }
         });
     }
     
     /**
-     * Copy an asset file to internal storage
-     * 
-     * @param assetName The name of the asset file
-     * @return The path to the copied file
-     * @throws IOException If an I/O error occurs
+     * Model reference for a file in assets; the native loader maps it straight from the APK
      */
-    private String copyAssetToInternalStorage(String assetName) throws IOException {
-        File file = new File(context.getFilesDir(), assetName);
-        
-        // Create parent directories if they don't exist
-        File parentDir = file.getParentFile();
-        if (parentDir != null && !parentDir.exists()) {
-            parentDir.mkdirs();
-        }
-        
-        // Copy asset file to internal storage
-        try (FileOutputStream outputStream = new FileOutputStream(file)) {
-            byte[] buffer = new byte[1024];
-            int read;
-            
-            try (var inputStream = context.getAssets().open(assetName)) {
-                while ((read = inputStream.read(buffer)) != -1) {
-                    outputStream.write(buffer, 0, read);
-                }
-            }
-        }
-        
-        return file.getAbsolutePath();
+    private static String assetModel(String assetName) {
+        return WakeupDetectorJNI.ASSET_PREFIX + assetName;
     }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ import com.microsoft.cognitiveservices.speech.audio.AudioConfig;
 import com.microsoft.cognitiveservices.speech.audio.PullAudioInputStream;
 import com.microsoft.cognitiveservices.speech.audio.AudioInputStream;
 import com.microsoft.cognitiveservices.speech.audio.PullAudioInputStreamCallback;
+import com.vinhpx.voiceassistant.AudioCaptureStream;
 
 import java.util.ArrayList;
 import java.util.List;
@@ -69,7 +70,22 @@ public class AzureSpeechRecognizer {
      * @param sampleRate Sample rate of the audio (typically 16000 Hz)
      */
     public Future<Void> recognizeSpeech(short[] audioData, int sampleRate) {
+        return recognize(new AudioDataReader(audioData));
+    }
+    
+    /**
+     * Recognize speech while it is still being captured. The stream is read until the
+     * capture session ends and closed once recognition completes.
+     *
+     * @param stream Capture session of the wake word detector, 16 kHz 16-bit mono PCM
+     */
+    public Future<Void> recognizeStream(AudioCaptureStream stream) {
+        return recognize(new CaptureStreamReader(stream));
+    }
+    
+    private Future<Void> recognize(PullAudioInputStreamCallback reader) {
         if (speechConfig == null) {
+            reader.close();
             notifyError("Speech recognizer not initialized properly");
             return null;
         }
@@ -78,10 +94,9 @@ public class AzureSpeechRecognizer {
             try {
                 notifyRecognizing();
                 
-                // Create a pull audio input stream from the audio data
+                // Create a pull audio input stream from the audio source
                 PullAudioInputStream inputStream = AudioInputStream.createPullStream(
-                        new AudioDataReader(audioData), 
-                        AudioStreamFormat.create16kHz16BitMonoPcm());
+                        reader, AudioStreamFormat.create16kHz16BitMonoPcm());
                 
                 // Create audio config from the input stream
                 AudioConfig audioConfig = AudioConfig.fromStreamInput(inputStream);
@@ -110,6 +125,8 @@ public class AzureSpeechRecognizer {
             } catch (Exception e) {
                 Log.e(TAG, "Error during speech recognition: " + e.getMessage(), e);
                 notifyError("Recognition error: " + e.getMessage());
+            } finally {
+                reader.close();
             }
             
             return null;
@@ -224,4 +241,26 @@ public class AzureSpeechRecognizer {
             // Nothing to close
         }
     }
-}
\ No newline at end of file
+    
+    /**
+     * Callback to pull live audio from a capture session of the wake word detector
+     */
+    private static class CaptureStreamReader extends PullAudioInputStreamCallback {
+        private final AudioCaptureStream stream;
+        
+        CaptureStreamReader(AudioCaptureStream stream) {
+            this.stream = stream;
+        }
+        
+        @Override
+        public int read(byte[] buffer) {
+            // Blocks until audio arrives; 0 ends the stream
+            return stream.read(buffer);
+        }
+        
+        @Override
+        public void close() {
+            stream.close();
+        }
+    }
+}